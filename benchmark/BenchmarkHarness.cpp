@@ -0,0 +1,59 @@
+#include "BenchmarkHarness.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+QJsonObject BenchmarkResult::toJson() const
+{
+    QJsonObject json;
+    json["name"] = name;
+    json["topology"] = topology;
+    json["nodes"] = nodes;
+    json["connections"] = connections;
+    json["iterations"] = static_cast<int>(samplesMs.size());
+    json["operations"] = static_cast<double>(operations);
+
+    if (samplesMs.empty()) {
+        return json;
+    }
+
+    std::vector<double> sorted = samplesMs;
+    std::sort(sorted.begin(), sorted.end());
+
+    const double mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+    const double median = sorted[sorted.size() / 2];
+
+    json["min_ms"] = sorted.front();
+    json["median_ms"] = median;
+    json["mean_ms"] = mean;
+    json["max_ms"] = sorted.back();
+
+    if (median > 0.0) {
+        json["ops_per_second"] = operations * 1000.0 / median;
+    }
+
+    return json;
+}
+
+BenchmarkResult runBenchmark(QString const &name,
+                             int iterations,
+                             qint64 operations,
+                             std::function<void(Stopwatch &)> const &body)
+{
+    BenchmarkResult result;
+    result.name = name;
+    result.operations = operations;
+
+    {
+        Stopwatch warmUp;
+        body(warmUp);
+    }
+
+    for (int i = 0; i < iterations; ++i) {
+        Stopwatch stopwatch;
+        body(stopwatch);
+        result.samplesMs.push_back(stopwatch.elapsedNs() / 1.0e6);
+    }
+
+    return result;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+
+#include <functional>
+#include <vector>
+
+/// Measures only the part of a run between `start()` and `stop()`.
+class Stopwatch
+{
+public:
+    void start() { _timer.start(); }
+
+    void stop() { _elapsedNs += _timer.nsecsElapsed(); }
+
+    qint64 elapsedNs() const { return _elapsedNs; }
+
+private:
+    QElapsedTimer _timer;
+
+    qint64 _elapsedNs = 0;
+};
+
+struct BenchmarkResult
+{
+    QString name;
+
+    QString topology;
+
+    int nodes = 0;
+
+    int connections = 0;
+
+    /// Work items processed by one run, used for the throughput.
+    qint64 operations = 1;
+
+    std::vector<double> samplesMs;
+
+    QJsonObject toJson() const;
+};
+
+/// Runs `body` once as a warm-up and then `iterations` times.
+BenchmarkResult runBenchmark(QString const &name,
+                             int iterations,
+                             qint64 operations,
+                             std::function<void(Stopwatch &)> const &body);
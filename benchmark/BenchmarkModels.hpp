@@ -0,0 +1,90 @@
+#pragma once
+
+#include <QtNodes/NodeData>
+#include <QtNodes/NodeDelegateModel>
+
+#include <QtCore/QJsonObject>
+
+#include <array>
+#include <memory>
+
+using QtNodes::NodeData;
+using QtNodes::NodeDataType;
+using QtNodes::NodeDelegateModel;
+using QtNodes::PortIndex;
+using QtNodes::PortType;
+
+class BenchData : public NodeData
+{
+public:
+    explicit BenchData(double value)
+        : _value(value)
+    {}
+
+    NodeDataType type() const override { return NodeDataType{"bench", "Bench"}; }
+
+    bool empty() const override { return false; }
+
+    double value() const { return _value; }
+
+private:
+    double _value;
+};
+
+/// Two inputs, two outputs. Every output carries the sum of the inputs plus one.
+class BenchModel : public NodeDelegateModel
+{
+public:
+    static QString Name() { return QStringLiteral("Bench"); }
+
+    QString caption() const override { return Name(); }
+
+    QString name() const override { return Name(); }
+
+    size_t nPorts(PortType) const override { return 2; }
+
+    NodeDataType dataType(PortType, PortIndex) const override
+    {
+        return NodeDataType{"bench", "Bench"};
+    }
+
+    void setInData(std::shared_ptr<NodeData> nodeData, PortIndex const portIndex) override
+    {
+        auto data = std::dynamic_pointer_cast<BenchData>(nodeData);
+        _inputs[portIndex] = data ? data->value() : 0.0;
+        _value = _inputs[0] + _inputs[1] + 1.0;
+
+        Q_EMIT dataUpdated(0);
+        Q_EMIT dataUpdated(1);
+    }
+
+    std::shared_ptr<NodeData> outData(PortIndex const) override
+    {
+        return std::make_shared<BenchData>(_value);
+    }
+
+    QWidget *embeddedWidget() override { return nullptr; }
+
+    QJsonObject save() const override
+    {
+        QJsonObject json = NodeDelegateModel::save();
+        json["value"] = _value;
+        return json;
+    }
+
+    void load(QJsonObject const &json) override { _value = json["value"].toDouble(); }
+
+    /// Changes the outputs, starting a propagation wave from this node.
+    void pulse()
+    {
+        _value += 1.0;
+
+        Q_EMIT dataUpdated(0);
+        Q_EMIT dataUpdated(1);
+    }
+
+private:
+    std::array<double, 2> _inputs{{0.0, 0.0}};
+
+    double _value = 0.0;
+};
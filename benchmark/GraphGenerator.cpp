@@ -0,0 +1,158 @@
+#include "GraphGenerator.hpp"
+
+#include "BenchmarkModels.hpp"
+
+#include <QtNodes/DataFlowGraphModel>
+#include <QtNodes/NodeDelegateModelRegistry>
+
+#include <QtCore/QPointF>
+#include <QtCore/QVariant>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using QtNodes::DataFlowGraphModel;
+using QtNodes::NodeDelegateModelRegistry;
+using QtNodes::NodeRole;
+
+namespace {
+
+std::size_t latticeWidth(std::size_t nodeCount)
+{
+    return std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(std::sqrt(nodeCount))));
+}
+
+} // namespace
+
+QString topologyName(Topology topology)
+{
+    switch (topology) {
+    case Topology::Chain:
+        return QStringLiteral("chain");
+    case Topology::FanOut:
+        return QStringLiteral("fanout");
+    case Topology::Lattice:
+        return QStringLiteral("lattice");
+    case Topology::Random:
+        return QStringLiteral("random");
+    }
+
+    return QString();
+}
+
+bool parseTopology(QString const &name, Topology &topology)
+{
+    for (Topology const t : allTopologies()) {
+        if (topologyName(t) == name) {
+            topology = t;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::vector<Topology> allTopologies()
+{
+    return {Topology::Chain, Topology::FanOut, Topology::Lattice, Topology::Random};
+}
+
+std::shared_ptr<NodeDelegateModelRegistry> makeBenchRegistry()
+{
+    auto registry = std::make_shared<NodeDelegateModelRegistry>();
+    registry->registerModel<BenchModel>([](auto const &) { return std::make_unique<BenchModel>(); });
+    return registry;
+}
+
+std::vector<ConnectionId> generateConnections(GraphSpec const &spec,
+                                              std::vector<NodeId> const &nodeIds)
+{
+    std::vector<ConnectionId> result;
+
+    const std::size_t n = nodeIds.size();
+
+    switch (spec.topology) {
+    case Topology::Chain:
+        for (std::size_t i = 1; i < n; ++i) {
+            result.push_back(ConnectionId{nodeIds[i - 1], 0, nodeIds[i], 0});
+        }
+        break;
+
+    case Topology::FanOut:
+        for (std::size_t i = 1; i < n; ++i) {
+            result.push_back(ConnectionId{nodeIds[0], 0, nodeIds[i], 0});
+        }
+        break;
+
+    case Topology::Lattice: {
+        const std::size_t width = latticeWidth(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i + width < n) {
+                result.push_back(ConnectionId{nodeIds[i], 0, nodeIds[i + width], 0});
+            }
+            if ((i % width) + 1 < width && i + 1 < n) {
+                result.push_back(ConnectionId{nodeIds[i], 1, nodeIds[i + 1], 1});
+            }
+        }
+        break;
+    }
+
+    case Topology::Random: {
+        std::mt19937 generator(spec.seed);
+        std::bernoulli_distribution connect(0.75);
+        std::uniform_int_distribution<int> outPort(0, 1);
+
+        for (std::size_t i = 1; i < n; ++i) {
+            std::uniform_int_distribution<std::size_t> source(0, i - 1);
+            for (QtNodes::PortIndex inPort = 0; inPort < 2; ++inPort) {
+                if (connect(generator)) {
+                    result.push_back(ConnectionId{nodeIds[source(generator)],
+                                                  static_cast<QtNodes::PortIndex>(
+                                                      outPort(generator)),
+                                                  nodeIds[i],
+                                                  inPort});
+                }
+            }
+        }
+        break;
+    }
+    }
+
+    return result;
+}
+
+std::vector<NodeId> addNodes(DataFlowGraphModel &model, GraphSpec const &spec)
+{
+    constexpr double spacingX = 250.0;
+    constexpr double spacingY = 150.0;
+
+    const std::size_t width = latticeWidth(spec.nodeCount);
+
+    std::vector<NodeId> nodeIds;
+    nodeIds.reserve(spec.nodeCount);
+
+    for (std::size_t i = 0; i < spec.nodeCount; ++i) {
+        const NodeId nodeId = model.addNode(BenchModel::Name());
+        model.setNodeData(nodeId,
+                          NodeRole::Position,
+                          QPointF((i % width) * spacingX, (i / width) * spacingY));
+        nodeIds.push_back(nodeId);
+    }
+
+    return nodeIds;
+}
+
+std::size_t populate(DataFlowGraphModel &model, GraphSpec const &spec)
+{
+    const std::vector<NodeId> nodeIds = addNodes(model, spec);
+    const std::vector<ConnectionId> connections = generateConnections(spec, nodeIds);
+
+    model.beginBatchUpdate();
+    for (ConnectionId const &connectionId : connections) {
+        model.addConnection(connectionId);
+    }
+    model.endBatchUpdate();
+
+    return connections.size();
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QtNodes/Definitions>
+
+#include <QtCore/QString>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace QtNodes {
+class DataFlowGraphModel;
+class NodeDelegateModelRegistry;
+} // namespace QtNodes
+
+using QtNodes::ConnectionId;
+using QtNodes::NodeId;
+
+enum class Topology {
+    Chain,   ///< Every node feeds the next one.
+    FanOut,  ///< The first node feeds all the others.
+    Lattice, ///< Square grid, each node feeds its right and bottom neighbours.
+    Random,  ///< Random DAG, every input port is connected with probability 3/4.
+};
+
+struct GraphSpec
+{
+    Topology topology = Topology::Chain;
+
+    std::size_t nodeCount = 0;
+
+    unsigned int seed = 0;
+};
+
+QString topologyName(Topology topology);
+
+/// @returns `false` for an unknown name.
+bool parseTopology(QString const &name, Topology &topology);
+
+std::vector<Topology> allTopologies();
+
+/// Registry providing `BenchModel`.
+std::shared_ptr<QtNodes::NodeDelegateModelRegistry> makeBenchRegistry();
+
+/// Connections of the topology between `nodeIds`, every input port receives at most one.
+std::vector<ConnectionId> generateConnections(GraphSpec const &spec,
+                                              std::vector<NodeId> const &nodeIds);
+
+/// Adds `spec.nodeCount` nodes laid out on a grid.
+std::vector<NodeId> addNodes(QtNodes::DataFlowGraphModel &model, GraphSpec const &spec);
+
+/// Builds the whole graph and @returns the number of connections.
+std::size_t populate(QtNodes::DataFlowGraphModel &model, GraphSpec const &spec);
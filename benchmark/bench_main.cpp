@@ -0,0 +1,427 @@
+#include "BenchmarkHarness.hpp"
+#include "BenchmarkModels.hpp"
+#include "GraphGenerator.hpp"
+
+#include <QtNodes/AbstractNodePainter>
+#include <QtNodes/DataFlowGraphModel>
+#include <QtNodes/DataFlowGraphicsScene>
+#include <QtNodes/internal/ConnectionGraphicsObject.hpp>
+#include <QtNodes/internal/NodeGraphicsObject.hpp>
+#include <QtNodes/internal/UndoCommands.hpp>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QTextStream>
+#include <QtGui/QImage>
+#include <QtGui/QPainter>
+#include <QtWidgets/QApplication>
+#include <QtWidgets/QStyleOptionGraphicsItem>
+#include <QUndoStack>
+
+#include <memory>
+
+using QtNodes::DataFlowGraphicsScene;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::MoveNodeCommand;
+
+namespace {
+
+struct Options
+{
+    std::size_t nodeCount = 1000;
+
+    int iterations = 10;
+
+    unsigned int seed = 1;
+
+    std::vector<Topology> topologies = allTopologies();
+
+    QString output;
+};
+
+/// Nodes without connected inputs, i.e. the sources of a propagation wave.
+std::vector<NodeId> rootNodes(DataFlowGraphModel const &model)
+{
+    std::vector<NodeId> roots;
+    for (NodeId const nodeId : model.allNodeIds()) {
+        if (model.connections(nodeId, PortType::In, 0).empty()
+            && model.connections(nodeId, PortType::In, 1).empty()) {
+            roots.push_back(nodeId);
+        }
+    }
+    return roots;
+}
+
+std::vector<ConnectionId> allConnections(DataFlowGraphModel const &model)
+{
+    std::vector<ConnectionId> result;
+    for (NodeId const nodeId : model.allNodeIds()) {
+        for (PortIndex portIndex = 0; portIndex < 2; ++portIndex) {
+            for (ConnectionId const &connectionId :
+                 model.connections(nodeId, PortType::Out, portIndex)) {
+                result.push_back(connectionId);
+            }
+        }
+    }
+    return result;
+}
+
+void paintScene(DataFlowGraphicsScene &scene,
+                std::vector<ConnectionId> const &connectionIds,
+                QImage &image,
+                bool lowDetail)
+{
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    QStyleOptionGraphicsItem option;
+
+    for (ConnectionId const &connectionId : connectionIds) {
+        if (auto cgo = scene.connectionGraphicsObject(connectionId)) {
+            QGraphicsItem *item = cgo;
+            option.exposedRect = item->boundingRect();
+
+            painter.save();
+            painter.translate(item->pos());
+            item->paint(&painter, &option, nullptr);
+            painter.restore();
+        }
+    }
+
+    for (NodeId const nodeId : scene.graphModel().allNodeIds()) {
+        if (auto ngo = scene.nodeGraphicsObject(nodeId)) {
+            painter.save();
+            painter.translate(ngo->pos());
+            if (lowDetail) {
+                scene.nodePainter().paintLowDetail(&painter, *ngo);
+            } else {
+                scene.nodePainter().paint(&painter, *ngo);
+            }
+            painter.restore();
+        }
+    }
+}
+
+std::vector<BenchmarkResult> runTopology(GraphSpec const &spec, int iterations)
+{
+    auto registry = makeBenchRegistry();
+
+    std::vector<BenchmarkResult> results;
+
+    const qint64 nodeCount = static_cast<qint64>(spec.nodeCount);
+
+    results.push_back(runBenchmark("add_nodes", iterations, nodeCount, [&](Stopwatch &stopwatch) {
+        DataFlowGraphModel model(registry);
+        stopwatch.start();
+        addNodes(model, spec);
+        stopwatch.stop();
+    }));
+
+    // Reference graph used by the read-only benchmarks.
+    DataFlowGraphModel reference(registry);
+    const std::size_t connectionCount = populate(reference, spec);
+    const qint64 connections = static_cast<qint64>(connectionCount);
+
+    results.push_back(
+        runBenchmark("add_connections", iterations, connections, [&](Stopwatch &stopwatch) {
+            DataFlowGraphModel model(registry);
+            const auto connectionIds = generateConnections(spec, addNodes(model, spec));
+            stopwatch.start();
+            for (ConnectionId const &connectionId : connectionIds) {
+                model.addConnection(connectionId);
+            }
+            stopwatch.stop();
+        }));
+
+    results.push_back(
+        runBenchmark("add_connections_bulk", iterations, connections, [&](Stopwatch &stopwatch) {
+            DataFlowGraphModel model(registry);
+            const auto connectionIds = generateConnections(spec, addNodes(model, spec));
+            stopwatch.start();
+            model.addConnections(connectionIds);
+            stopwatch.stop();
+        }));
+
+    results.push_back(runBenchmark("delete_nodes", iterations, nodeCount, [&](Stopwatch &stopwatch) {
+        DataFlowGraphModel model(registry);
+        populate(model, spec);
+        const auto nodeIds = model.allNodeIds();
+        stopwatch.start();
+        for (NodeId const nodeId : nodeIds) {
+            model.deleteNode(nodeId);
+        }
+        stopwatch.stop();
+    }));
+
+    results.push_back(runBenchmark("save", iterations, nodeCount, [&](Stopwatch &stopwatch) {
+        stopwatch.start();
+        const QJsonObject json = reference.save();
+        stopwatch.stop();
+        Q_UNUSED(json);
+    }));
+
+    const QJsonObject saved = reference.save();
+
+    results.push_back(runBenchmark("load", iterations, nodeCount, [&](Stopwatch &stopwatch) {
+        DataFlowGraphModel model(registry);
+        stopwatch.start();
+        model.load(saved);
+        stopwatch.stop();
+    }));
+
+    const std::vector<NodeId> roots = rootNodes(reference);
+
+    results.push_back(runBenchmark("propagate", iterations, nodeCount, [&](Stopwatch &stopwatch) {
+        stopwatch.start();
+        reference.beginBatchUpdate();
+        for (NodeId const nodeId : roots) {
+            reference.delegateModel<BenchModel>(nodeId)->pulse();
+        }
+        reference.endBatchUpdate();
+        stopwatch.stop();
+    }));
+
+    results.push_back(
+        runBenchmark("scene_populate", iterations, nodeCount, [&](Stopwatch &stopwatch) {
+            stopwatch.start();
+            auto scene = std::make_unique<DataFlowGraphicsScene>(reference);
+            stopwatch.stop();
+        }));
+
+    // Programmatic import into a model that is already shown.
+    results.push_back(
+        runBenchmark("scene_import_bulk", iterations, nodeCount, [&](Stopwatch &stopwatch) {
+            DataFlowGraphModel model(registry);
+            DataFlowGraphicsScene scene(model);
+            const std::vector<QString> nodeTypes(spec.nodeCount, BenchModel::Name());
+
+            stopwatch.start();
+            const std::vector<NodeId> nodeIds = model.addNodes(nodeTypes);
+            stopwatch.stop();
+
+            const auto connectionIds = generateConnections(spec, nodeIds);
+
+            stopwatch.start();
+            model.addConnections(connectionIds);
+            stopwatch.stop();
+        }));
+
+    // Without a view a virtualized scene keeps no graphics objects at all.
+    results.push_back(
+        runBenchmark("scene_load_virtualized", iterations, nodeCount, [&](Stopwatch &stopwatch) {
+            DataFlowGraphModel model(registry);
+            DataFlowGraphicsScene scene(model);
+            scene.setVirtualizationEnabled(true);
+
+            stopwatch.start();
+            model.load(saved);
+            stopwatch.stop();
+        }));
+
+    {
+        DataFlowGraphicsScene scene(reference);
+        const std::vector<ConnectionId> connectionIds = allConnections(reference);
+        QImage image(1024, 1024, QImage::Format_ARGB32_Premultiplied);
+
+        const qint64 items = nodeCount + connections;
+
+        results.push_back(runBenchmark("paint", iterations, items, [&](Stopwatch &stopwatch) {
+            stopwatch.start();
+            paintScene(scene, connectionIds, image, false);
+            stopwatch.stop();
+        }));
+
+        scene.setLowDetailMode(true);
+
+        results.push_back(
+            runBenchmark("paint_low_detail", iterations, items, [&](Stopwatch &stopwatch) {
+                stopwatch.start();
+                paintScene(scene, connectionIds, image, true);
+                stopwatch.stop();
+            }));
+    }
+
+    // Whole scene through QGraphicsScene::render, per connection objects versus one layer.
+    {
+        DataFlowGraphicsScene scene(reference);
+        QImage image(1024, 1024, QImage::Format_ARGB32_Premultiplied);
+
+        const qint64 items = nodeCount + connections;
+
+        auto render = [&](Stopwatch &stopwatch) {
+            image.fill(Qt::transparent);
+            QPainter painter(&image);
+            painter.setRenderHint(QPainter::Antialiasing);
+
+            stopwatch.start();
+            scene.render(&painter);
+            stopwatch.stop();
+        };
+
+        results.push_back(runBenchmark("render", iterations, items, render));
+
+        scene.setBatchedConnectionsEnabled(true);
+
+        results.push_back(runBenchmark("render_batched_connections", iterations, items, render));
+
+        scene.setNodeShadowMode(DataFlowGraphicsScene::ShadowMode::Cached);
+
+        results.push_back(runBenchmark("render_cached_shadows", iterations, items, render));
+    }
+
+    // Dragging the whole graph: 64 mouse events, a display frame every 16 of them.
+    {
+        DataFlowGraphModel model(registry);
+        model.load(saved);
+        DataFlowGraphicsScene scene(model);
+
+        for (NodeId const nodeId : model.allNodeIds()) {
+            scene.nodeGraphicsObject(nodeId)->setSelected(true);
+        }
+
+        const int mouseEvents = 64;
+        const int eventsPerFrame = 16;
+
+        results.push_back(runBenchmark("drag", iterations, nodeCount, [&](Stopwatch &stopwatch) {
+            stopwatch.start();
+            for (int i = 0; i < mouseEvents; ++i) {
+                scene.undoStack().push(new MoveNodeCommand(&scene, QPointF(1, 1)));
+            }
+            stopwatch.stop();
+        }));
+
+        scene.setDragSessionsEnabled(true);
+        scene.setDragFrameInterval(0);
+
+        results.push_back(
+            runBenchmark("drag_session", iterations, nodeCount, [&](Stopwatch &stopwatch) {
+                stopwatch.start();
+                scene.beginDragSession();
+                for (int i = 0; i < mouseEvents; ++i) {
+                    scene.updateDragSession(QPointF(1, 1));
+                    if ((i + 1) % eventsPerFrame == 0) {
+                        QCoreApplication::processEvents();
+                    }
+                }
+                scene.endDragSession();
+                stopwatch.stop();
+            }));
+    }
+
+    for (BenchmarkResult &result : results) {
+        result.topology = topologyName(spec.topology);
+        result.nodes = static_cast<int>(spec.nodeCount);
+        result.connections = static_cast<int>(connectionCount);
+    }
+
+    return results;
+}
+
+bool parseOptions(QCoreApplication const &app, Options &options)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmarks of the QtNodes model, scene and painters.");
+    parser.addHelpOption();
+
+    QCommandLineOption nodesOption({"n", "nodes"}, "Nodes per graph.", "count", "1000");
+    QCommandLineOption iterationsOption({"i", "iterations"}, "Timed runs.", "count", "10");
+    QCommandLineOption topologyOption({"t", "topology"},
+                                      "chain, fanout, lattice, random or all.",
+                                      "name",
+                                      "all");
+    QCommandLineOption seedOption("seed", "Seed of the random topology.", "seed", "1");
+    QCommandLineOption outputOption({"o", "output"}, "JSON file, stdout by default.", "file");
+
+    parser.addOptions({nodesOption, iterationsOption, topologyOption, seedOption, outputOption});
+    parser.process(app);
+
+    bool ok = true;
+
+    options.nodeCount = parser.value(nodesOption).toUInt(&ok);
+    if (!ok || options.nodeCount == 0) {
+        return false;
+    }
+
+    options.iterations = parser.value(iterationsOption).toInt(&ok);
+    if (!ok || options.iterations <= 0) {
+        return false;
+    }
+
+    options.seed = parser.value(seedOption).toUInt(&ok);
+    if (!ok) {
+        return false;
+    }
+
+    const QString topology = parser.value(topologyOption);
+    if (topology != "all") {
+        Topology t = Topology::Chain;
+        if (!parseTopology(topology, t)) {
+            return false;
+        }
+        options.topologies = {t};
+    }
+
+    options.output = parser.value(outputOption);
+
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // Painting happens into a QImage, no display is needed.
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+
+    Options options;
+    if (!parseOptions(app, options)) {
+        QTextStream(stderr) << "Invalid arguments, see --help\n";
+        return 1;
+    }
+
+    QJsonArray results;
+
+    for (Topology const topology : options.topologies) {
+        const GraphSpec spec{topology, options.nodeCount, options.seed};
+
+        for (BenchmarkResult const &result : runTopology(spec, options.iterations)) {
+            const QJsonObject json = result.toJson();
+            results.append(json);
+
+            QTextStream(stderr) << result.topology << " " << result.name << ": "
+                                << json["median_ms"].toDouble() << " ms\n";
+        }
+    }
+
+    QJsonObject report;
+    report["qt_version"] = QString(qVersion());
+    report["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["iterations"] = options.iterations;
+    report["seed"] = static_cast<double>(options.seed);
+    report["results"] = results;
+
+    const QByteArray json = QJsonDocument(report).toJson();
+
+    if (options.output.isEmpty()) {
+        QTextStream(stdout) << json;
+        return 0;
+    }
+
+    QFile file(options.output);
+    if (!file.open(QIODevice::WriteOnly)) {
+        QTextStream(stderr) << "Cannot write " << options.output << "\n";
+        return 1;
+    }
+    file.write(json);
+
+    return 0;
+}
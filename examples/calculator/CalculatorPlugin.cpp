@@ -0,0 +1,25 @@
+#include "CalculatorPlugin.hpp"
+
+#include "AdditionModel.hpp"
+#include "DivisionModel.hpp"
+#include "MultiplicationModel.hpp"
+#include "NumberDisplayDataModel.hpp"
+#include "NumberSourceDataModel.hpp"
+#include "SubtractionModel.hpp"
+
+#include <QtNodes/NodeDelegateModelRegistry>
+
+void CalculatorPlugin::registerModels(QtNodes::NodeDelegateModelRegistry &registry)
+{
+    registry.registerModel<NumberSourceDataModel>("Sources");
+
+    registry.registerModel<NumberDisplayDataModel>("Displays");
+
+    registry.registerModel<AdditionModel>("Operators");
+
+    registry.registerModel<SubtractionModel>("Operators");
+
+    registry.registerModel<MultiplicationModel>("Operators");
+
+    registry.registerModel<DivisionModel>("Operators");
+}
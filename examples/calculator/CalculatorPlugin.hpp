@@ -0,0 +1,18 @@
+#pragma once
+
+#include <QtNodes/NodeRegistryPlugin>
+
+#include <QtCore/QObject>
+
+/// Provides the calculator models to `qtnodes_run`.
+class CalculatorPlugin
+    : public QObject
+    , public QtNodes::NodeRegistryPlugin
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID QtNodes_NodeRegistryPlugin_iid)
+    Q_INTERFACES(QtNodes::NodeRegistryPlugin)
+
+public:
+    void registerModels(QtNodes::NodeDelegateModelRegistry &registry) override;
+};
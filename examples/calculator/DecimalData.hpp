@@ -24,6 +24,8 @@ public:
 
     QString numberAsText() const { return QString::number(_number, 'f'); }
 
+    QString getDescription() const override { return numberAsText(); }
+
 private:
     double _number;
 };
@@ -52,8 +52,8 @@ private:
     {
         PortIndex const outPortIndex = 0;
 
-        auto n1 = _number1.lock();
-        auto n2 = _number2.lock();
+        auto n1 = _number1;
+        auto n2 = _number2;
 
         if (n2 && (n2->number() == 0.0)) {
             //modelValidationState = NodeValidationState::Error;
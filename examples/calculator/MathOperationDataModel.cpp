@@ -37,6 +37,4 @@ void MathOperationDataModel::setInData(std::shared_ptr<NodeData> data, PortIndex
     } else {
         _number2 = numberData;
     }
-
-    compute();
 }
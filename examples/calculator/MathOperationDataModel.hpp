@@ -36,12 +36,14 @@ public:
 
     QWidget *embeddedWidget() override { return nullptr; }
 
-protected:
-    virtual void compute() = 0;
+    /// The graph model computes once all the inputs of a change wave are set.
+    bool threadSafeCompute() const override { return true; }
+
+    void compute() override = 0;
 
 protected:
-    std::weak_ptr<DecimalData> _number1;
-    std::weak_ptr<DecimalData> _number2;
+    std::shared_ptr<DecimalData> _number1;
+    std::shared_ptr<DecimalData> _number2;
 
     std::shared_ptr<DecimalData> _result;
 };
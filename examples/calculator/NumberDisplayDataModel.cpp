@@ -50,6 +50,8 @@ void NumberDisplayDataModel::setInData(std::shared_ptr<NodeData> data, PortIndex
     }
 
     _label->adjustSize();
+
+    Q_EMIT embeddedWidgetUpdated();
 }
 
 QWidget *NumberDisplayDataModel::embeddedWidget()
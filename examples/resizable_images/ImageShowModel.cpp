@@ -85,5 +85,7 @@ void ImageShowModel::setInData(std::shared_ptr<NodeData> nodeData, PortIndex con
         _label->setPixmap(QPixmap());
     }
 
+    Q_EMIT embeddedWidgetUpdated();
+
     Q_EMIT dataUpdated(0);
 }
@@ -48,4 +48,6 @@ void TextDisplayDataModel::setInData(std::shared_ptr<NodeData> data, PortIndex c
 
     _label->setText(_inputText);
     _label->adjustSize();
+
+    Q_EMIT embeddedWidgetUpdated();
 }
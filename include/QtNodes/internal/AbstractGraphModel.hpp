@@ -2,18 +2,24 @@
 
 #include "Export.hpp"
 
+#include <cstdint>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <QtCore/QJsonObject>
 #include <QtCore/QObject>
 #include <QtCore/QVariant>
 
 #include "ConnectionIdHash.hpp"
+#include "DataTypeRegistry.hpp"
 #include "Definitions.hpp"
 
 namespace QtNodes {
 
+class NodeStyle;
+
 /**
  * The central class in the Model-View approach. It delivers all kinds
  * of information from the backing user data structures that represent
@@ -76,6 +82,15 @@ public:
    */
     virtual bool connectionPossible(ConnectionId const connectionId) const = 0;
 
+    /**
+   * Tells if a connection `outNodeId` -> `inNodeId` would close a directed
+   * cycle, i.e. if `outNodeId` is reachable downstream from `inNodeId`.
+   *
+   * The default implementation walks the output connections iteratively.
+   * Models keeping a topological order can answer without a full traversal.
+   */
+    virtual bool wouldCreateCycle(NodeId const outNodeId, NodeId const inNodeId) const;
+
     /// Defines if detaching the connection is possible.
     virtual bool detachPossible(ConnectionId const) const { return true; }
 
@@ -111,6 +126,21 @@ public:
         return nodeData(nodeId, role).value<T>();
     }
 
+    /// Typed style used to paint the node.
+    /**
+   * The default implementation parses the `NodeRole::Style` JSON on every
+   * call. Models that keep `NodeStyle` objects around should return them
+   * directly; `NodeRole::Style` is then only needed for serialization.
+   */
+    virtual std::shared_ptr<NodeStyle const> nodeStyle(NodeId const nodeId) const;
+
+    /**
+   * Version stamp of the style returned by `nodeStyle(nodeId)`. Painters keep
+   * the handle for as long as the stamp does not change. The default
+   * implementation follows `StyleCollection::nodeStyleVersion()`.
+   */
+    virtual std::uint64_t nodeStyleVersion(NodeId const nodeId) const;
+
     virtual NodeFlags nodeFlags(NodeId nodeId) const
     {
         Q_UNUSED(nodeId);
@@ -143,6 +173,13 @@ public:
         return portData(nodeId, portType, index, role).value<T>();
     }
 
+    /// Interned `PortRole::DataType` of the port.
+    /**
+   * Painters ask for it on every repaint. The default implementation interns
+   * the id returned by `portData`, models may cache the handles.
+   */
+    virtual DataTypeHandle portTypeHandle(NodeId nodeId, PortType portType, PortIndex index) const;
+
     virtual bool setPortData(NodeId nodeId,
                              PortType portType,
                              PortIndex index,
@@ -154,6 +191,21 @@ public:
 
     virtual bool deleteNode(NodeId const nodeId) = 0;
 
+    /// Creates a node of each type, `InvalidNodeId` is returned for failed types.
+    /**
+   * The bulk functions serve building or clearing large graphs. Their default
+   * implementations call `addNode`, `addConnection` and `deleteNode`, which
+   * emit per-element signals. Overrides may instead emit a single
+   * `nodesCreated`, `connectionsCreated`, `connectionsDeleted` or
+   * `nodesDeleted` signal per call.
+   */
+    virtual std::vector<NodeId> addNodes(std::vector<QString> const &nodeTypes);
+
+    virtual void addConnections(std::vector<ConnectionId> const &connectionIds);
+
+    /// Deletes the nodes together with their connections.
+    virtual void deleteNodes(std::unordered_set<NodeId> const &nodeIds);
+
     /**
    * Reimplement the function if you want to store/restore the node's
    * inner state during undo/redo node deletion operations.
@@ -201,7 +253,8 @@ public:
 
     /**
    * Signal emitted when model no longer has the old data associated with the
-   * given port indices and when the node must be repainted.
+   * given port indices and when the node must be repainted. Emits
+   * `nodePortsUpdated` and re-creates the shifted connections.
    */
     void portsDeleted();
 
@@ -220,8 +273,8 @@ public:
                                 PortIndex const last);
 
     /**
-   * Function re-creates the connections that were shifted during the port
-   * insertion. After that the node is updated.
+   * Function emits `nodePortsUpdated` and re-creates the connections that were
+   * shifted during the port insertion. After that the node is updated.
    */
     void portsInserted();
 
@@ -234,16 +287,44 @@ Q_SIGNALS:
 
     void nodeDeleted(NodeId const nodeId);
 
+    /// Emitted instead of `nodeCreated` by the bulk functions.
+    void nodesCreated(std::vector<NodeId> const &nodeIds);
+
+    /// Emitted instead of `nodeDeleted` by the bulk functions.
+    void nodesDeleted(std::vector<NodeId> const &nodeIds);
+
+    /// Emitted instead of `connectionCreated` by the bulk functions.
+    void connectionsCreated(std::vector<ConnectionId> const &connectionIds);
+
+    /// Emitted instead of `connectionDeleted` by the bulk functions.
+    void connectionsDeleted(std::vector<ConnectionId> const &connectionIds);
+
     void nodeUpdated(NodeId const nodeId);
 
     void nodeFlagsUpdated(NodeId const nodeId);
 
     void nodePositionUpdated(NodeId const nodeId);
 
+    /// Emitted when the contents of the node's `NodeRole::Widget` changed.
+    void nodeWidgetUpdated(NodeId const nodeId);
+
+    /// Emitted by `portsInserted` and `portsDeleted` once the node has its new ports.
+    void nodePortsUpdated(NodeId const nodeId);
+
+    /**
+   * Emitted when the size of the node is set. The node geometry places the
+   * ports for the sizes written by `recomputeSize()` without it, so models
+   * which only store the size may leave it out.
+   */
+    void nodeSizeUpdated(NodeId const nodeId);
+
     void modelReset();
 
 private:
     std::vector<ConnectionId> _shiftedByDynamicPortsConnections;
+
+    /// Node whose ports are being inserted or deleted.
+    NodeId _portsChangedNodeId = InvalidNodeId;
 };
 
 } // namespace QtNodes
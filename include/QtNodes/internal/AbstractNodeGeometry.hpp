@@ -3,6 +3,7 @@
 #include "Definitions.hpp"
 #include "Export.hpp"
 
+#include <QMetaObject>
 #include <QRectF>
 #include <QSize>
 #include <QTransform>
@@ -15,7 +16,7 @@ class NODE_EDITOR_PUBLIC AbstractNodeGeometry
 {
 public:
     AbstractNodeGeometry(AbstractGraphModel &);
-    virtual ~AbstractNodeGeometry() {}
+    virtual ~AbstractNodeGeometry();
 
     /**
    * The node's size plus some additional margin around it to account for drawing
@@ -72,8 +73,29 @@ public:
 
     virtual QRect resizeHandleRect(NodeId const nodeId) const = 0;
 
+    /**
+   * Drops the layout data cached for the node. Called on `nodePortsUpdated`,
+   * and by the scene when the node is updated or deleted. The default
+   * implementation does nothing.
+   */
+    virtual void invalidate(NodeId const nodeId) const { Q_UNUSED(nodeId); }
+
+    /**
+   * Drops the cached positions which depend on the node size, called on
+   * `nodeSizeUpdated`. The default implementation does nothing.
+   */
+    virtual void invalidatePositions(NodeId const nodeId) const { Q_UNUSED(nodeId); }
+
+    /// Drops the layout data of all nodes, e.g. after a font change.
+    virtual void invalidateAll() const {}
+
 protected:
     AbstractGraphModel &_graphModel;
+
+private:
+    QMetaObject::Connection _portsConnection;
+
+    QMetaObject::Connection _sizeConnection;
 };
 
 } // namespace QtNodes
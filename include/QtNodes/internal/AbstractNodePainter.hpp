@@ -25,5 +25,15 @@ public:
    * `NodeGraphicsObject::graphModel()`
    */
     virtual void paint(QPainter *painter, NodeGraphicsObject &ngo) const = 0;
+
+    /**
+   * Used instead of `paint` while the scene is in low detail mode, i.e. when
+   * the view is zoomed out too far for captions and labels to be readable.
+   * Default implementation falls back to the full painting.
+   */
+    virtual void paintLowDetail(QPainter *painter, NodeGraphicsObject &ngo) const
+    {
+        paint(painter, ngo);
+    }
 };
 } // namespace QtNodes
@@ -1,13 +1,16 @@
 #pragma once
 
 #include <QtCore/QUuid>
+#include <QtGui/QTransform>
 #include <QtWidgets/QGraphicsScene>
 #include <QtWidgets/QMenu>
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <tuple>
 #include <unordered_map>
+#include <vector>
 
 #include "AbstractGraphModel.hpp"
 #include "AbstractNodeGeometry.hpp"
@@ -18,6 +21,8 @@
 #include "QUuidStdHash.hpp"
 #include "NodeData.hpp"
 
+class QGraphicsObject;
+class QUndoCommand;
 class QUndoStack;
 
 namespace QtNodes {
@@ -25,13 +30,26 @@ namespace QtNodes {
 class AbstractGraphModel;
 class AbstractNodePainter;
 class ConnectionGraphicsObject;
+class ConnectionLayer;
 class NodeGraphicsObject;
+class NodeStatePool;
 class NodeStyle;
 
+template<typename Key>
+class SpatialGridIndex;
+
 /// An instance of QGraphicsScene, holds connections and nodes.
 class NODE_EDITOR_PUBLIC BasicGraphicsScene : public QGraphicsScene
 {
     Q_OBJECT
+public:
+    /// How nodes draw their drop shadow.
+    enum class ShadowMode {
+        Effect, ///< A QGraphicsDropShadowEffect per node, blurred on every repaint.
+        Cached, ///< A shared pre-rendered pixmap stretched under each node.
+        None
+    };
+
 public:
     BasicGraphicsScene(AbstractGraphModel &graphModel, QObject *parent = nullptr);
 
@@ -54,6 +72,25 @@ public:
 
     QUndoStack &undoStack();
 
+    /// Shares equal node states between the commands of `undoStack()`.
+    NodeStatePool &nodeStatePool();
+
+    /// Caps the memory held by the undo history, 0 means unlimited.
+    /**
+   * When the commands on the stack report more than `bytes`, the state of
+   * the oldest ones is released and they can no longer be undone.
+   */
+    void setUndoMemoryBudget(std::size_t bytes);
+
+    std::size_t undoMemoryBudget() const { return _undoMemoryBudget; }
+
+    /// Ids of the selected nodes.
+    /**
+   * The set is cached until the selection changes, so repeated callers such
+   * as the move commands of one drag share a single instance.
+   */
+    std::shared_ptr<std::vector<NodeId> const> selectedNodeIds() const;
+
 public:
     /// Creates a "draft" instance of ConnectionGraphicsObject.
     /**
@@ -90,12 +127,169 @@ public:
    */
     ConnectionGraphicsObject *connectionGraphicsObject(ConnectionId connectionId);
 
+    /// Like `nodeGraphicsObject` but creates the object if virtualization released it.
+    /**
+   * @returns nullptr when the node does not exist in the model.
+   */
+    NodeGraphicsObject *materializeNode(NodeId nodeId);
+
+    /// Like `connectionGraphicsObject` but creates the object if it was released.
+    ConnectionGraphicsObject *materializeConnection(ConnectionId connectionId);
+
+    /// Transform placing the node in the scene, also for released nodes.
+    QTransform nodeSceneTransform(NodeId nodeId) const;
+
     Qt::Orientation orientation() const { return _orientation; }
 
     void setOrientation(Qt::Orientation const orientation);
 
     void toggleWidgetMode();
 
+public:
+    /// Enables the grid index used to locate nodes and connections.
+    /**
+   * The index is off by default. When enabled, it is kept in sync with node
+   * positions and sizes and with connection geometry, and point or rect
+   * lookups visit only the nearby grid cells instead of every scene item.
+   */
+    void setSpatialIndexEnabled(bool enabled);
+
+    bool spatialIndexEnabled() const { return _nodeIndex != nullptr; }
+
+    /// @returns ids of the nodes whose bounding rects intersect `sceneRect`.
+    std::vector<NodeId> nodesInRect(QRectF const &sceneRect) const;
+
+    /// @returns ids of the connections whose bounding rects intersect `sceneRect`.
+    std::vector<ConnectionId> connectionsInRect(QRectF const &sceneRect) const;
+
+    /// @returns the topmost node whose shape contains `scenePoint` or `nullptr`.
+    /**
+   * Queries the spatial index if it is enabled and checks every node
+   * otherwise.
+   */
+    NodeGraphicsObject *nodeGraphicsObjectAt(QPointF const &scenePoint);
+
+    /// Refreshes the indexed bounds of the item after its geometry changed.
+    void updateSpatialIndex(NodeGraphicsObject const &ngo);
+
+    void updateSpatialIndex(ConnectionGraphicsObject const &cgo);
+
+    /// Moves the connections of `nodeId` which have no graphics object.
+    /**
+   * Refreshes their indexed bounds and, in batched mode, their drawing.
+   * Called by the node when it moves or changes its size.
+   */
+    void moveReleasedConnections(NodeId const nodeId);
+
+    /// Switches nodes and connections to simplified painting.
+    /**
+   * In low detail mode nodes are drawn as plain rects without captions,
+   * port labels, embedded widgets or shadows and connections are drawn as
+   * straight lines. `GraphicsView` enables it below its low detail scale.
+   */
+    void setLowDetailMode(bool lowDetail);
+
+    bool lowDetailMode() const { return _lowDetailMode; }
+
+public:
+    /// Paints embedded widgets from snapshots until their node is hovered.
+    /**
+   * Off by default. When enabled, a node wraps its embedded widget in a
+   * `QGraphicsProxyWidget` only while the mouse is over the node or the
+   * widget has focus. After `widgetReleaseDelay()` milliseconds without
+   * either, the proxy is replaced by a pixmap of the widget again. The
+   * pixmap is retaken after `onNodeUpdated` and `onNodeWidgetUpdated`, the
+   * latter on `NodeDelegateModel::embeddedWidgetUpdated`.
+   */
+    void setDeferredWidgetsEnabled(bool enabled);
+
+    bool deferredWidgetsEnabled() const { return _deferredWidgets; }
+
+    void setWidgetReleaseDelay(int msec);
+
+    int widgetReleaseDelay() const { return _widgetReleaseDelay; }
+
+    /// Selects the shadow of all the nodes, `ShadowMode::Effect` by default.
+    /**
+   * The effect renders every node offscreen and blurs it on each repaint.
+   * `ShadowMode::Cached` looks nearly the same at a fraction of the cost,
+   * `ShadowMode::None` suits very large graphs.
+   */
+    void setNodeShadowMode(ShadowMode mode);
+
+    ShadowMode nodeShadowMode() const { return _nodeShadowMode; }
+
+public:
+    /// Draws the connections with one scene item instead of an object each.
+    /**
+   * Off by default. When enabled, a single layer item strokes all the
+   * connections of one color with one path per paint. Only the selected,
+   * hovered and dragged connections keep a `ConnectionGraphicsObject`: the
+   * object is created when the mouse moves over a connection and released
+   * again once the connection is neither hovered nor selected.
+   *
+   * `connectionGraphicsObject` returns `nullptr` for batched connections,
+   * `materializeConnection` creates their object. Rubber band selection
+   * only picks connections which have an object.
+   */
+    void setBatchedConnectionsEnabled(bool enabled);
+
+    bool batchedConnectionsEnabled() const { return _connectionLayer != nullptr; }
+
+public:
+    /// Moves dragged nodes once per frame instead of once per mouse event.
+    /**
+   * Off by default. When enabled, pressing a node starts a drag session
+   * which takes the selection and the node positions once. Mouse moves only
+   * accumulate the offset: the nodes are moved at most once every
+   * `dragFrameInterval()` milliseconds, their connections are updated once
+   * per frame and the scene rect grows once per frame. Releasing the mouse
+   * applies the last offset and pushes a single `MoveNodeCommand`.
+   */
+    void setDragSessionsEnabled(bool enabled);
+
+    bool dragSessionsEnabled() const { return _dragSessionsEnabled; }
+
+    void setDragFrameInterval(int msec);
+
+    int dragFrameInterval() const { return _dragFrameInterval; }
+
+    /// Starts a drag session over the current selection, called on mouse press.
+    void beginDragSession();
+
+    /// Adds `diff` to the offset of the running session.
+    void updateDragSession(QPointF const &diff);
+
+    /// Applies the pending offset and records the whole drag as one undo command.
+    void endDragSession();
+
+    bool dragSessionActive() const { return _dragSession != nullptr; }
+
+public:
+    /// Keeps graphics objects only for the items near the visible area.
+    /**
+   * Off by default. When enabled, every node and connection is tracked in
+   * the spatial index by its model geometry, but `NodeGraphicsObject` and
+   * `ConnectionGraphicsObject` instances exist only for the items that
+   * intersect the viewports of the attached views, grown by a margin.
+   * `GraphicsView` refreshes the set when it pans, zooms or resizes.
+   *
+   * Selected, hovered and grabbed items are never released, so the
+   * selection and the undo commands keep working. Code that needs the
+   * object of an arbitrary item calls `materializeNode` or
+   * `materializeConnection`. Enabling it also enables the spatial index.
+   */
+    void setVirtualizationEnabled(bool enabled);
+
+    bool virtualizationEnabled() const { return _virtualized; }
+
+    /// Creates the objects entering the views' visible area and releases the others.
+    /**
+   * Does nothing while the visible area stays inside the area covered by
+   * the last update.
+   */
+    void updateMaterializedItems();
+
 public:
     /// Can @return an instance of the scene context menu in subclass.
     /**
@@ -106,6 +300,10 @@ public:
 
     void keyPressEvent(QKeyEvent *event) override;
 
+protected:
+    /// Re-lays out the nodes when the font changes.
+    bool event(QEvent *event) override;
+
 Q_SIGNALS:
     void nodeMoved(NodeId const nodeId, QPointF const &newLocation);
 
@@ -138,6 +336,56 @@ private:
     /// Redraws adjacent nodes for given `connectionId`
     void updateAttachedNodes(ConnectionId const connectionId, PortType const portType);
 
+    /**
+   * Releases the oldest undo commands while the history exceeds the budget.
+   * Only the commands below the latest undoable one are released, the redo
+   * side is kept. The costs are accounted incrementally, the history is only
+   * walked again after it was changed below the accounted commands.
+   */
+    void enforceUndoMemoryBudget();
+
+    /// Memory of the undo command at `index`, 0 for released commands.
+    std::size_t undoCommandCost(int const index) const;
+
+    /// Drops the incremental accounting of the undo history.
+    void resetUndoAccounting();
+
+    /// Indexes a released node by its model geometry, @returns its scene rect.
+    QRectF indexNode(NodeId const nodeId);
+
+    /// Indexes a released connection by its model geometry, @returns its scene rect.
+    QRectF indexConnection(ConnectionId const connectionId);
+
+    /// Re-indexes a released node and its connections, materializing the visible ones.
+    void relocateReleasedNode(NodeId const nodeId);
+
+    /// Takes a pooled connection object or creates a new one.
+    void createConnectionGraphicsObject(ConnectionId const connectionId);
+
+    /// Creates the object of a new connection, unless it is released or batched.
+    void placeConnection(ConnectionId const connectionId);
+
+    /// Creates the released items intersecting `region` and releases the others.
+    void materializeRegion(QRectF const &region);
+
+    /// Whether the user currently interacts with the object.
+    bool isReleasable(QGraphicsObject const &object) const;
+
+    void releaseNode(NodeId const nodeId);
+
+    void releaseConnection(ConnectionId const connectionId);
+
+    /// Batches the releasable connection objects on the next event loop pass.
+    void scheduleConnectionBatching();
+
+    void batchReleasableConnections();
+
+    /// Updates the geometry of a connection which has no graphics object.
+    void moveReleasedConnection(ConnectionId const connectionId);
+
+    /// Moves the nodes of the drag session to the accumulated offset.
+    void applyDragFrame();
+
 public Q_SLOTS:
     /// Slot called when the `connectionId` is erased form the AbstractGraphModel.
     void onConnectionDeleted(ConnectionId const connectionId);
@@ -149,10 +397,29 @@ public Q_SLOTS:
 
     void onNodeCreated(NodeId const nodeId);
 
+    /// Slots for the bulk signals, attached nodes are repainted once per call.
+    void onConnectionsDeleted(std::vector<ConnectionId> const &connectionIds);
+
+    void onConnectionsCreated(std::vector<ConnectionId> const &connectionIds);
+
+    void onNodesDeleted(std::vector<NodeId> const &nodeIds);
+
+    void onNodesCreated(std::vector<NodeId> const &nodeIds);
+
     void onNodePositionUpdated(NodeId const nodeId);
 
     void onNodeUpdated(NodeId const nodeId);
 
+    /// Repaints the node after new input data.
+    /**
+   * Unlike `onNodeUpdated`, keeps the layout and the size of the node unless
+   * its caption changed.
+   */
+    void onNodeDataUpdated(NodeId const nodeId);
+
+    /// Retakes the snapshot of a deferred embedded widget.
+    void onNodeWidgetUpdated(NodeId const nodeId);
+
     void onNodeClicked(NodeId const nodeId);
 
     void onModelReset();
@@ -178,8 +445,59 @@ private:
 
     QUndoStack *_undoStack;
 
+    std::unique_ptr<NodeStatePool> _nodeStatePool;
+
+    std::size_t _undoMemoryBudget;
+
+    /// Costs of the accounted undo commands, the oldest ones first. Released
+    /// commands are accounted with 0.
+    std::vector<std::size_t> _undoCommandCosts;
+
+    /// Sum of `_undoCommandCosts`.
+    std::size_t _undoHistoryCost;
+
+    /// Number of the oldest accounted commands already released.
+    std::size_t _undoReleased;
+
+    /// Last accounted command, tells whether the stack shifted meanwhile.
+    QUndoCommand const *_undoAccountedLast;
+
+    mutable std::shared_ptr<std::vector<NodeId> const> _selectedNodeIds;
+
     Qt::Orientation _orientation;
 
+    std::unique_ptr<SpatialGridIndex<NodeId>> _nodeIndex;
+
+    std::unique_ptr<SpatialGridIndex<ConnectionId>> _connectionIndex;
+
+    bool _lowDetailMode;
+
+    bool _virtualized;
+
+    bool _deferredWidgets;
+
+    int _widgetReleaseDelay;
+
+    ShadowMode _nodeShadowMode;
+
+    /// Scene area whose items have graphics objects in a virtualized scene.
+    QRectF _materializedRect;
+
+    /// Released connection objects waiting for reuse.
+    std::vector<UniqueConnectionGraphicsObject> _connectionPool;
+
+    std::unique_ptr<ConnectionLayer> _connectionLayer;
+
+    bool _connectionBatchingScheduled;
+
+    struct DragSession;
+
+    std::unique_ptr<DragSession> _dragSession;
+
+    bool _dragSessionsEnabled;
+
+    int _dragFrameInterval;
+
     bool portVacant(NodeId nodeId, const PortIndex portIndex, const PortType portType) const;
 
     NodeDataType getDataType(NodeId nodeId,
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Definitions.hpp"
+#include "Export.hpp"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDataStream>
+#include <QtCore/QJsonObject>
+#include <QtCore/QPointF>
+#include <QtCore/QString>
+
+class QIODevice;
+
+namespace QtNodes {
+
+/**
+ * Compact binary counterpart of the JSON graph format.
+ *
+ * ```
+ * header   : quint32 magic "QNGB", quint16 version
+ * section* : quint32 tag, quint64 record count, record*
+ * record   : quint32 byte size, payload
+ * ```
+ *
+ * Known sections are the node table ("NODE"), the connection table ("CONN")
+ * and the terminating "END ". A node record holds the id, the position and
+ * the node's internal data as an opaque blob. A connection record holds the
+ * four ids of the `ConnectionId`. Every record is size-prefixed, so readers
+ * skip sections and trailing record fields they do not know.
+ */
+namespace BinaryGraphFormat {
+
+constexpr quint32 Magic = 0x514E4742; // "QNGB"
+
+constexpr quint16 Version = 1;
+
+enum class Section : quint32 {
+    Nodes = 0x4E4F4445,       // "NODE"
+    Connections = 0x434F4E4E, // "CONN"
+    End = 0x454E4420,         // "END "
+};
+
+/// Checks the magic number without consuming any data from the device.
+NODE_EDITOR_PUBLIC bool isBinaryGraph(QIODevice &device);
+
+} // namespace BinaryGraphFormat
+
+/// One row of the node table.
+struct NODE_EDITOR_PUBLIC BinaryNodeRecord
+{
+    NodeId id = InvalidNodeId;
+
+    QPointF position;
+
+    /// Node's "internal-data" encoded as compact JSON.
+    QByteArray internalData;
+
+    QJsonObject internalDataJson() const;
+};
+
+/// Streams a graph to a device section by section without building a DOM.
+class NODE_EDITOR_PUBLIC BinaryGraphWriter
+{
+public:
+    /// Writes the file header.
+    explicit BinaryGraphWriter(QIODevice &device);
+
+    /// Starts a section that must be followed by exactly `recordCount` records.
+    void beginSection(BinaryGraphFormat::Section section, quint64 recordCount);
+
+    void writeNode(NodeId const nodeId, QPointF const &position, QJsonObject const &internalData);
+
+    void writeConnection(ConnectionId const &connectionId);
+
+    /// Writes the terminating section.
+    void finish();
+
+    bool hasError() const;
+
+private:
+    QDataStream _stream;
+
+    QByteArray _recordBuffer;
+};
+
+/// Reads a graph written by `BinaryGraphWriter` one record at a time.
+class NODE_EDITOR_PUBLIC BinaryGraphReader
+{
+public:
+    explicit BinaryGraphReader(QIODevice &device);
+
+    /// Reads and validates the file header.
+    bool readHeader();
+
+    /**
+   * Moves to the next known section, skipping unknown ones together with any
+   * unread record of the current section. Returns `false` at the end of the
+   * graph or on error.
+   */
+    bool nextSection(BinaryGraphFormat::Section &section, quint64 &recordCount);
+
+    bool readNode(BinaryNodeRecord &record);
+
+    bool readConnection(ConnectionId &connectionId);
+
+    quint16 version() const { return _version; }
+
+    bool hasError() const { return !_errorString.isEmpty(); }
+
+    QString errorString() const { return _errorString; }
+
+private:
+    /// Reads the next size-prefixed record of the current section.
+    bool readRecord(QByteArray &payload);
+
+    bool fail(QString const &error);
+
+private:
+    QDataStream _stream;
+
+    quint16 _version = 0;
+
+    quint64 _remainingRecords = 0;
+
+    QString _errorString;
+};
+
+} // namespace QtNodes
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace QtNodes {
+
+/**
+ * Shared flag telling a running computation that its result is no longer
+ * wanted. Copies share the flag, so the graph model cancels the copy it
+ * keeps while the compute polls its own one from a worker thread.
+ */
+class CancellationToken
+{
+public:
+    CancellationToken()
+        : _cancelled(std::make_shared<std::atomic<bool>>(false))
+    {}
+
+    bool isCancelled() const { return _cancelled->load(std::memory_order_relaxed); }
+
+    void cancel() const { _cancelled->store(true, std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> _cancelled;
+};
+
+} // namespace QtNodes
@@ -3,6 +3,7 @@
 #include <utility>
 
 #include <QtCore/QUuid>
+#include <QtGui/QPainterPath>
 #include <QtWidgets/QGraphicsObject>
 
 #include "ConnectionState.hpp"
@@ -39,8 +40,21 @@ public:
 
     QRectF boundingRect() const override;
 
+    /// Stroke used for rubber band selection, cached until the ends move.
     QPainterPath shape() const override;
 
+    /// Hit test against the curve itself instead of its stroked shape.
+    bool contains(QPointF const &point) const override;
+
+    /// Cubic path between the ends in item coordinates, cached until the ends move.
+    QPainterPath const &cubicPath() const;
+
+    /// Outline of `cubicPath` for a pen of `width`, cached for the last width.
+    QPainterPath const &cubicOutline(double width) const;
+
+    /// Drops the cached path, e.g. after a level of detail change.
+    void invalidatePath();
+
     QPointF const &endPoint(PortType portType) const;
 
     QPointF out() const { return _out; }
@@ -49,6 +63,20 @@ public:
 
     std::pair<QPointF, QPointF> pointsC1C2() const;
 
+    /// Control points of the cubic path between `out` and `in`.
+    static std::pair<QPointF, QPointF> pointsC1C2(QPointF const &out,
+                                                  QPointF const &in,
+                                                  Qt::Orientation orientation);
+
+    /// Bounds of the path between `out` and `in`, including the port circles.
+    /**
+   * Lets the scene compute connection bounds for connections without a
+   * graphics object.
+   */
+    static QRectF pathBoundingRect(QPointF const &out,
+                                   QPointF const &in,
+                                   Qt::Orientation orientation);
+
     void setEndPoint(PortType portType, QPointF const &point);
 
     /// Updates the position of both ends
@@ -58,6 +86,9 @@ public:
 
     ConnectionState &connectionState();
 
+    /// Rebinds a pooled object to another connection and moves it there.
+    void reset(ConnectionId const connectionId);
+
 protected:
     void paint(QPainter *painter,
                QStyleOptionGraphicsItem const *option,
@@ -78,9 +109,11 @@ private:
 
     void addGraphicsEffect();
 
-    std::pair<QPointF, QPointF> pointsC1C2Horizontal() const;
+    static std::pair<QPointF, QPointF> pointsC1C2Horizontal(QPointF const &out,
+                                                            QPointF const &in);
 
-    std::pair<QPointF, QPointF> pointsC1C2Vertical() const;
+    static std::pair<QPointF, QPointF> pointsC1C2Vertical(QPointF const &out,
+                                                          QPointF const &in);
 
 private:
     ConnectionId _connectionId;
@@ -91,6 +124,16 @@ private:
 
     mutable QPointF _out;
     mutable QPointF _in;
+
+    mutable QRectF _boundingRect;
+
+    mutable QPainterPath _cubicPath;
+
+    mutable QPainterPath _shape;
+
+    mutable QPainterPath _cubicOutline;
+
+    mutable double _cubicOutlineWidth = 0.0;
 };
 
 } // namespace QtNodes
@@ -2,6 +2,7 @@
 
 #include <QtGui/QColor>
 
+#include "DataTypeRegistry.hpp"
 #include "Export.hpp"
 #include "Style.hpp"
 
@@ -28,6 +29,7 @@ public:
     QColor constructionColor() const;
     QColor normalColor() const;
     QColor normalColor(QString typeId) const;
+    QColor normalColor(DataTypeHandle typeHandle) const;
     QColor selectedColor() const;
     QColor selectedHaloColor() const;
     QColor hoveredColor() const;
@@ -1,8 +1,13 @@
 #pragma once
 
+#include "DataTypeRegistry.hpp"
+#include "NodeData.hpp"
+
 #include <TypeTraits.h>
 #include <any>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <type_traits>
 #include <unordered_map>
 #include <QHash>
@@ -10,17 +15,27 @@
 
 namespace QtNodes {
 
+/// Converter key, the pair of interned source and destination data types.
 class FromToTypes
 {
 public:
-    FromToTypes(QString from, QString to)
-        : m_from(std::move(from))
-        , m_to(std::move(to))
+    FromToTypes(QString const &from, QString const &to)
+        : m_from(DataTypeRegistry::intern(from))
+        , m_to(DataTypeRegistry::intern(to))
+    {}
+
+    FromToTypes(DataTypeHandle from, DataTypeHandle to) noexcept
+        : m_from(from)
+        , m_to(to)
     {}
 
-    const QString &from() const noexcept { return m_from; }
+    const QString &from() const noexcept { return DataTypeRegistry::typeId(m_from); }
+
+    const QString &to() const noexcept { return DataTypeRegistry::typeId(m_to); }
 
-    const QString &to() const noexcept { return m_to; }
+    DataTypeHandle fromHandle() const noexcept { return m_from; }
+
+    DataTypeHandle toHandle() const noexcept { return m_to; }
 
     bool operator==(const FromToTypes &other) const noexcept
     {
@@ -28,8 +43,8 @@ public:
     }
 
 private:
-    QString m_from;
-    QString m_to;
+    DataTypeHandle m_from;
+    DataTypeHandle m_to;
 };
 
 template<class T>
@@ -46,10 +61,10 @@ struct hash<QtNodes::FromToTypes>
 {
     size_t operator()(const QtNodes::FromToTypes &from_to_types) const noexcept
     {
-        size_t seed = 0;
-        QtNodes::hash_combine(seed, from_to_types.from());
-        QtNodes::hash_combine(seed, from_to_types.to());
-        return seed;
+        // Both handles fit in one 64 bit key.
+        const auto key = (static_cast<std::uint64_t>(from_to_types.fromHandle()) << 32)
+                         | from_to_types.toHandle();
+        return std::hash<std::uint64_t>()(key);
     }
 };
 } // namespace std
@@ -58,6 +73,10 @@ namespace QtNodes {
 
 using ConverterFunction = std::function<std::any(const std::any &)>;
 
+/// Converter working on the data exchanged by the nodes, no payload is copied into a `std::any`.
+using NodeDataConverter
+    = std::function<std::shared_ptr<NodeData>(const std::shared_ptr<NodeData> &)>;
+
 class ConvertersRegister : public std::unordered_map<FromToTypes, ConverterFunction>
 {
 public:
@@ -77,12 +96,70 @@ public:
         using ToType = StdExt::ReturnType_t<Func>;
         using FromType = StdExt::ArgType_t<Func, 0>;
         using FromTypeWithoutReference = std::remove_reference_t<FromType>;
-        const FromToTypes from_to_types{ToType::id(), FromTypeWithoutReference::id()};
+        const FromToTypes from_to_types{FromTypeWithoutReference::id(), ToType::id()};
         this->emplace(from_to_types, [](const std::any &any_from) -> std::any {
             const FromType &from_casted = std::any_cast<FromType>(any_from);
             return Func()(from_casted);
         });
+
+        using FromData = std::decay_t<FromType>;
+        using ToData = std::decay_t<ToType>;
+        constexpr bool is_node_data = std::is_base_of<NodeData, FromData>::value
+                                      && std::is_base_of<NodeData, ToData>::value;
+        register_node_data_converter<Func, FromData, ToData>(
+            from_to_types, std::integral_constant<bool, is_node_data>{});
+    }
+
+    /**
+   * Registers `converter` for the connections going from `from_to_types.from()`
+   * to `from_to_types.to()`. A `std::any` converter passing the `shared_ptr`
+   * through is added as well, so the pair is found by `contains`.
+   */
+    void add_node_data_converter(const FromToTypes &from_to_types, NodeDataConverter converter)
+    {
+        auto shared = std::make_shared<const NodeDataConverter>(std::move(converter));
+
+        this->insert_or_assign(from_to_types, [shared](const std::any &any_from) -> std::any {
+            return (*shared)(std::any_cast<std::shared_ptr<NodeData>>(any_from));
+        });
+
+        m_node_data_converters.insert_or_assign(from_to_types, std::move(shared));
     }
+
+    /// @returns the converter for the pair or nullptr, it stays valid if the pair is re-registered.
+    std::shared_ptr<const NodeDataConverter> node_data_converter(
+        const FromToTypes &from_to_types) const
+    {
+        const auto it = m_node_data_converters.find(from_to_types);
+        return it != m_node_data_converters.end() ? it->second : nullptr;
+    }
+
+private:
+    template<typename Func, typename FromData, typename ToData>
+    void register_node_data_converter(const FromToTypes &from_to_types, std::true_type)
+    {
+        m_node_data_converters.emplace(
+            from_to_types,
+            std::make_shared<const NodeDataConverter>(
+                [](const std::shared_ptr<NodeData> &data) -> std::shared_ptr<NodeData> {
+                    const auto from = std::dynamic_pointer_cast<FromData>(data);
+                    if (!from) {
+                        return nullptr;
+                    }
+                    return std::make_shared<ToData>(Func()(*from));
+                }));
+    }
+
+    /// Converters between types which are not `NodeData` only serve the `std::any` API.
+    template<typename Func, typename FromData, typename ToData>
+    void register_node_data_converter(const FromToTypes &, std::false_type)
+    {}
+
+private:
+    using NodeDataConverters
+        = std::unordered_map<FromToTypes, std::shared_ptr<const NodeDataConverter>>;
+
+    NodeDataConverters m_node_data_converters;
 };
 
 } // namespace QtNodes
@@ -3,6 +3,7 @@
 #include "AbstractGraphModel.hpp"
 #include "ConnectionIdUtils.hpp"
 #include "NodeDelegateModelRegistry.hpp"
+#include "NodeProfiler.hpp"
 #include "Serializable.hpp"
 #include "StyleCollection.hpp"
 
@@ -10,10 +11,21 @@
 
 #include <QJsonObject>
 
+#include <cstdint>
+#include <list>
 #include <memory>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+class QIODevice;
+class QThreadPool;
 
 namespace QtNodes {
 
+class DataFlowEvaluationEngine;
+
 class NODE_EDITOR_PUBLIC DataFlowGraphModel : public AbstractGraphModel, public Serializable
 {
     Q_OBJECT
@@ -25,9 +37,18 @@ public:
         QPointF pos;
     };
 
+    /// Memoization counters of a node, @see NodeDelegateModel::memoizationCacheSize.
+    struct MemoizationStats
+    {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+    };
+
 public:
     DataFlowGraphModel(std::shared_ptr<NodeDelegateModelRegistry> registry);
 
+    ~DataFlowGraphModel() override;
+
     std::shared_ptr<NodeDelegateModelRegistry> dataModelRegistry() { return _registry; }
 
 public:
@@ -43,14 +64,32 @@ public:
 
     NodeId addNode(QString const nodeType) override;
 
+    /// Emits a single `nodesCreated`.
+    std::vector<NodeId> addNodes(std::vector<QString> const &nodeTypes) override;
+
     bool connectionPossible(ConnectionId const connectionId) const override;
 
     void addConnection(ConnectionId const connectionId) override;
 
+    /**
+   * Emits a single `connectionsCreated`. The new inputs are propagated in one
+   * change wave.
+   */
+    void addConnections(std::vector<ConnectionId> const &connectionIds) override;
+
+    /**
+   * Answered from an incrementally maintained topological order: a
+   * connection agreeing with the order is accepted without any traversal,
+   * otherwise only the nodes ranked between both ends are visited.
+   */
+    bool wouldCreateCycle(NodeId const outNodeId, NodeId const inNodeId) const override;
+
     bool nodeExists(NodeId const nodeId) const override;
 
     QVariant nodeData(NodeId nodeId, NodeRole role) const override;
 
+    std::shared_ptr<NodeStyle const> nodeStyle(NodeId const nodeId) const override;
+
     NodeFlags nodeFlags(NodeId nodeId) const override;
 
     bool setNodeData(NodeId nodeId, NodeRole role, QVariant value) override;
@@ -60,6 +99,11 @@ public:
                       PortIndex portIndex,
                       PortRole role) const override;
 
+    /// Handles are interned once per node and dropped when its ports change.
+    DataTypeHandle portTypeHandle(NodeId nodeId,
+                                  PortType portType,
+                                  PortIndex portIndex) const override;
+
     bool setPortData(NodeId nodeId,
                      PortType portType,
                      PortIndex portIndex,
@@ -70,6 +114,9 @@ public:
 
     bool deleteNode(NodeId const nodeId) override;
 
+    /// Emits a single `connectionsDeleted` followed by a single `nodesDeleted`.
+    void deleteNodes(std::unordered_set<NodeId> const &nodeIds) override;
+
     QJsonObject saveNode(NodeId const) const override;
 
     QJsonObject save() const override;
@@ -78,6 +125,91 @@ public:
 
     void load(QJsonObject const &json) override;
 
+    /// Writes the graph in the compact binary format, @see BinaryGraphFormat.
+    bool saveBinary(QIODevice &device) const;
+
+    /**
+   * Restores a graph written by `saveBinary`. Like `load()` it throws
+   * `std::logic_error` for unregistered model names.
+   */
+    bool loadBinary(QIODevice &device);
+
+    /**
+   * Defers the data propagation until the matching `endBatchUpdate()`.
+   * Updates made in between are coalesced: every affected node receives its
+   * new inputs once, in topological order. Calls may be nested.
+   */
+    void beginBatchUpdate();
+
+    /**
+   * Closes the outermost batch by propagating the queued updates. An
+   * exception thrown by a model on the way is caught and reported with
+   * `qWarning()`, the rest of the wave is dropped.
+   */
+    void endBatchUpdate();
+
+    /**
+   * Scoped `beginBatchUpdate()`/`endBatchUpdate()` pair. Left by an
+   * exception, it closes the batch without propagating and drops the
+   * queued updates.
+   */
+    class NODE_EDITOR_PUBLIC BatchUpdate
+    {
+    public:
+        explicit BatchUpdate(DataFlowGraphModel &model);
+
+        ~BatchUpdate() noexcept;
+
+        BatchUpdate(BatchUpdate const &) = delete;
+
+        BatchUpdate &operator=(BatchUpdate const &) = delete;
+
+    private:
+        DataFlowGraphModel &_model;
+
+        int _uncaughtExceptions;
+    };
+
+    /**
+   * Runs `NodeDelegateModel::compute()` of the models reporting
+   * `threadSafeCompute()` on a thread pool. Their results are propagated on
+   * the thread owning this graph model. All other models keep computing
+   * synchronously. Disabled by default.
+   */
+    void setAsynchronousEvaluation(bool enabled);
+
+    bool asynchronousEvaluation() const { return _evaluationEngine != nullptr; }
+
+    /// Pool used for the asynchronous evaluation, `nullptr` while it is disabled.
+    QThreadPool *evaluationThreadPool();
+
+    /**
+   * Blocks until the asynchronous computations are finished and their
+   * results are propagated. Returns `false` if `msecs` expired before.
+   */
+    bool waitForEvaluation(int msecs = -1);
+
+    /**
+   * Records per-node timings of the evaluation, @see NodeProfiler. Disabled
+   * by default, disabling drops the recorded statistics.
+   */
+    void setProfilingEnabled(bool enabled);
+
+    bool profilingEnabled() const { return _profiler != nullptr; }
+
+    /// `nullptr` while the profiling is disabled.
+    NodeProfiler *profiler() { return _profiler.get(); }
+
+    NodeProfiler const *profiler() const { return _profiler.get(); }
+
+    MemoizationStats memoizationStats(NodeId const nodeId) const;
+
+    /**
+   * Drops the outputs memoized for the node, e.g. after a change of its
+   * internal state that affects the outputs.
+   */
+    void clearMemoizedOutputs(NodeId const nodeId);
+
     /**
    * Fetches the NodeDelegateModel for the given `nodeId` and tries to cast the
    * stored pointer to the given type
@@ -98,12 +230,125 @@ Q_SIGNALS:
     void inPortDataWasSet(NodeId const, PortType const, PortIndex const);
 
 private:
+    friend class DataFlowEvaluationEngine;
+
     NodeId newNodeId() override { return _nextNodeId++; }
 
+    /// Shared part of `loadNode` and `loadBinary`.
+    void restoreNode(NodeId const nodeId,
+                     QPointF const &position,
+                     QJsonObject const &internalDataJson);
+
+    /// Connects the delegate model's signals to the graph model.
+    void connectDelegateModel(NodeId const nodeId, NodeDelegateModel *model);
+
+    /**
+   * Runs `compute()` of a thread-safe model, asynchronously if enabled,
+   * unless outputs memoized for the same inputs can be reused.
+   */
+    void requestCompute(NodeId const nodeId);
+
+    /// Returns `true` if the compute was replaced with memoized outputs.
+    bool reuseMemoizedOutputs(NodeId const nodeId, NodeDelegateModel &model);
+
+    /// Keeps the outputs of the finished compute for its inputs.
+    void memoizeOutputs(NodeId const nodeId, NodeDelegateModel &model);
+
+    /// The outputs of a superseded compute are neither memoized nor current.
+    void forgetComputedOutputs(NodeId const nodeId);
+
+    /**
+   * Hands the data to the delegate model without triggering `compute()`.
+   * Returns `false` if the input was deferred by the evaluation engine.
+   */
+    bool deliverInData(NodeId const nodeId,
+                       PortIndex const portIndex,
+                       std::shared_ptr<NodeData> nodeData);
+
+    /**
+   * Applies the converter resolved for the connection, if any. The result is
+   * kept per output port, so consumers of the same data behind the same
+   * converter share one conversion.
+   */
+    std::shared_ptr<NodeData> convertData(ConnectionId const &connectionId,
+                                          std::shared_ptr<NodeData> nodeData);
+
+    /// Interned data type of the connection's port on the `portType` side.
+    DataTypeHandle portTypeHandle(ConnectionId const &connectionId, PortType const portType) const;
+
+    /// Calls `setInData` of the node's model, timed while profiling.
+    void setModelInData(NodeId const nodeId,
+                        NodeDelegateModel &model,
+                        std::shared_ptr<NodeData> nodeData,
+                        PortIndex const portIndex);
+
+    /// Queues the connection for the next change wave.
+    void schedulePropagation(ConnectionId const connectionId);
+
+    /**
+   * Propagates the queued connections. The receiving nodes are visited in
+   * topological order, so each of them gets all of its new inputs at once
+   * and computes after everything upstream of it.
+   */
+    void propagatePending();
+
+    /// Topologically sorted nodes reachable downstream from `seeds`, seeds included.
+    std::vector<NodeId> downstreamOrder(std::vector<NodeId> const &seeds) const;
+
+    /// Creates the delegate model without emitting `nodeCreated`.
+    NodeId createNode(QString const &nodeType);
+
+    /// Releases everything stored for the node, its connections must be gone.
+    void destroyNode(NodeId const nodeId);
+
+    /// Stores and indexes the connection. Returns `false` if it already existed.
+    bool insertConnection(ConnectionId const connectionId);
+
+    /// Counterpart of `insertConnection` for a connection already erased from `_connectivity`.
+    void removeConnection(ConnectionId const connectionId);
+
     void sendConnectionCreation(ConnectionId const connectionId);
 
     void sendConnectionDeletion(ConnectionId const connectionId);
 
+    /// Informs the delegate models at both ends, no graph model signal is emitted.
+    void notifyConnectionCreated(ConnectionId const connectionId);
+
+    void notifyConnectionDeleted(ConnectionId const connectionId);
+
+    /// Registers the connection in the per-port and per-node adjacency index.
+    void indexConnection(ConnectionId const connectionId);
+
+    /// Removes the connection from the per-port and per-node adjacency index.
+    void unindexConnection(ConnectionId const connectionId);
+
+    /// Gives the node the highest rank of the topological order.
+    void appendToTopologicalOrder(NodeId const nodeId);
+
+    /**
+   * Pearce-Kelly update of the order for a new connection. Only the nodes
+   * ranked between the connection ends are reordered. Invalidates the order
+   * if the connection closes a cycle.
+   */
+    void insertIntoTopologicalOrder(ConnectionId const connectionId);
+
+    /// Recomputes the order of the whole graph, used once a cycle was removed.
+    void rebuildTopologicalOrder() const;
+
+    /**
+   * Nodes reachable downstream from `nodeId` ranked not above `maxRank`.
+   * Returns `false` as soon as `stopNodeId` is reached.
+   */
+    bool collectForward(NodeId const nodeId,
+                        std::int64_t const maxRank,
+                        NodeId const stopNodeId,
+                        std::vector<NodeId> &visited) const;
+
+    /// Nodes reachable upstream from `nodeId` ranked above `minRank`.
+    void collectBackward(NodeId const nodeId,
+                         std::int64_t const minRank,
+                         std::vector<NodeId> &visited) const;
+
 private Q_SLOTS:
     /**
    * Fuction is called in three cases:
@@ -120,6 +365,61 @@ private Q_SLOTS:
     /// Function is called after detaching a connection.
     void propagateEmptyDataTo(NodeId const nodeId, PortIndex const portIndex);
 
+private:
+    using PortKey = std::tuple<NodeId, PortType, PortIndex>;
+
+    using ConverterPtr = std::shared_ptr<NodeDataConverter const>;
+
+    /// Last conversion of an output port's data.
+    struct ConvertedData
+    {
+        ConverterPtr converter;
+        std::weak_ptr<NodeData> source;
+        std::shared_ptr<NodeData> result;
+    };
+
+    /// Memo key of one input: whether the port holds data, and the hash of that data.
+    using MemoInput = std::pair<bool, std::size_t>;
+
+    /// Outputs computed for one combination of input hashes.
+    struct MemoizedOutputs
+    {
+        std::vector<MemoInput> inputs;
+        std::vector<std::shared_ptr<NodeData>> outputs;
+    };
+
+    /// Memoization state of a node whose model opted in.
+    struct NodeMemo
+    {
+        /// Keys of the delivered inputs, unset for data without a hash.
+        std::vector<std::optional<MemoInput>> inputHashes;
+
+        /// Most recently used entry first.
+        std::list<MemoizedOutputs> entries;
+
+        /// The model's outputs belong to the front entry.
+        bool current = false;
+
+        /// Inputs of the running compute, unset if they cannot be memoized.
+        std::optional<std::vector<MemoInput>> computing;
+
+        MemoizationStats stats;
+    };
+
+    /// Connections attached to a node, split by the node's side.
+    struct NodeConnections
+    {
+        std::unordered_set<ConnectionId> in;
+        std::unordered_set<ConnectionId> out;
+    };
+
+    /// Interned data types of a node's ports.
+    struct PortTypeHandles
+    {
+        std::vector<DataTypeHandle> in;
+        std::vector<DataTypeHandle> out;
+    };
+
 private:
     std::shared_ptr<NodeDelegateModelRegistry> _registry;
 
@@ -129,7 +429,48 @@ private:
 
     std::unordered_set<ConnectionId> _connectivity;
 
+    /// Adjacency index kept in sync with `_connectivity`. Answers
+    /// `connections()` and `allConnectionIds()` in O(degree).
+    std::unordered_map<PortKey, std::unordered_set<ConnectionId>> _portConnections;
+
+    std::unordered_map<NodeId, NodeConnections> _nodeConnections;
+
     mutable std::unordered_map<NodeId, NodeGeometryData> _nodeGeometryData;
+
+    /// Filled on the first lookup of a node, see `portTypeHandle`.
+    mutable std::unordered_map<NodeId, PortTypeHandles> _portTypeHandles;
+
+    /// Converters of the connections between different data types, resolved
+    /// once when the connection is made.
+    std::unordered_map<ConnectionId, ConverterPtr> _connectionConverters;
+
+    /// Conversions of the current output data, dropped when the port has new data.
+    std::unordered_map<PortKey, std::vector<ConvertedData>> _convertedData;
+
+    std::unique_ptr<DataFlowEvaluationEngine> _evaluationEngine;
+
+    std::unique_ptr<NodeProfiler> _profiler;
+
+    std::unordered_map<NodeId, NodeMemo> _memos;
+
+    int _batchUpdateDepth = 0;
+
+    bool _propagating = false;
+
+    /// Connections waiting for the change wave, grouped by the receiving node.
+    std::unordered_map<NodeId, std::unordered_set<ConnectionId>> _pendingPropagation;
+
+    /// Node ranks, every connection goes from a lower to a higher rank while
+    /// `_topologicalOrderValid` is set.
+    mutable std::unordered_map<NodeId, std::int64_t> _topologicalRank;
+
+    mutable std::int64_t _nextTopologicalRank = 0;
+
+    /// Cleared when a connection closes a cycle.
+    mutable bool _topologicalOrderValid = true;
+
+    /// Set when a connection was deleted while the order was invalid.
+    mutable bool _topologicalOrderStale = false;
 };
 
 } // namespace QtNodes
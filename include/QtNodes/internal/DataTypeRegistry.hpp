@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Export.hpp"
+#include "NodeData.hpp"
+#include "QStringStdHash.hpp"
+
+#include <QtCore/QString>
+#include <QtGui/QColor>
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace QtNodes {
+
+/// Dense integer standing for a `NodeDataType::id`.
+using DataTypeHandle = std::uint32_t;
+
+/**
+ * Process wide table interning data type ids.
+ *
+ * Every distinct `NodeDataType::id` gets the next free handle the first time
+ * it is seen, so two ports have the same type exactly when their handles are
+ * equal. Handles are only valid for the running process, serialized graphs
+ * keep the string ids.
+ *
+ * The registry also holds the color `ConnectionStyle::normalColor(QString)`
+ * derives from each id, computed once at interning, or the first valid
+ * `NodeDataType::color` a model gave the type.
+ *
+ * All functions lock the registry, types are interned from the evaluation
+ * workers as well as from the GUI thread.
+ */
+class NODE_EDITOR_PUBLIC DataTypeRegistry
+{
+public:
+    /// @returns the handle of `typeId`, registering it if it is new.
+    static DataTypeHandle intern(QString const &typeId);
+
+    /// Also makes a valid `type.color` the color of the type, unless a model gave one before.
+    static DataTypeHandle intern(NodeDataType const &type);
+
+    static QString const &typeId(DataTypeHandle handle);
+
+    /// Data defined connection color of the type.
+    static QColor color(DataTypeHandle handle);
+
+    /// Color of `typeId` without interning it, derived from the id if it is new.
+    static QColor color(QString const &typeId);
+
+    /// Number of interned types, handles range from 0 to `size() - 1`.
+    static std::size_t size();
+
+private:
+    DataTypeRegistry() = default;
+
+    DataTypeRegistry(DataTypeRegistry const &) = delete;
+
+    DataTypeRegistry &operator=(DataTypeRegistry const &) = delete;
+
+    static DataTypeRegistry &instance();
+
+    /// Expects `_mutex` to be held.
+    DataTypeHandle internLocked(QString const &typeId);
+
+private:
+    mutable std::mutex _mutex;
+
+    std::unordered_map<QString, DataTypeHandle> _handles;
+
+    /// A deque keeps the references returned by `typeId` valid while interning.
+    std::deque<QString> _typeIds;
+
+    std::vector<QColor> _colors;
+
+    /// Set for the types whose color was given by a model.
+    std::vector<bool> _givenColors;
+};
+
+} // namespace QtNodes
@@ -19,6 +19,9 @@ class NODE_EDITOR_PUBLIC DefaultNodePainter : public AbstractNodePainter
 public:
     void paint(QPainter *painter, NodeGraphicsObject &ngo) const override;
 
+    /// Draws a plain filled rect with the node boundary.
+    void paintLowDetail(QPainter *painter, NodeGraphicsObject &ngo) const override;
+
     void drawNodeRect(QPainter *painter, NodeGraphicsObject &ngo) const;
 
     void drawConnectionPoints(QPainter *painter, NodeGraphicsObject &ngo) const;
@@ -43,6 +43,11 @@ public:
 
     double getScale() const;
 
+    /// @brief Below this scale the scene is painted in low detail mode, 0 disables it.
+    void setLowDetailScale(double scale);
+
+    double lowDetailScale() const;
+
 public Q_SLOTS:
     void scaleUp();
 
@@ -76,14 +81,27 @@ protected:
 
     void drawBackground(QPainter *painter, const QRectF &r) override;
 
+    /// Follows palette changes with the background brush.
+    void changeEvent(QEvent *event) override;
+
     void showEvent(QShowEvent *event) override;
 
+    void resizeEvent(QResizeEvent *event) override;
+
+    void scrollContentsBy(int dx, int dy) override;
+
 protected:
     BasicGraphicsScene *nodeScene();
 
     /// Computes scene position for pasting the copied/duplicated node groups.
     QPointF scenePastePosition();
 
+private Q_SLOTS:
+    void updateLevelOfDetail();
+
+    /// Lets a virtualized scene follow the visible area.
+    void updateMaterializedItems();
+
 private:
     QAction *_clearSelectionAction = nullptr;
     QAction *_deleteSelectionAction = nullptr;
@@ -93,5 +111,6 @@ private:
 
     QPointF _clickPos;
     ScaleRange _scaleRange;
+    double _lowDetailScale = 0;
 };
 } // namespace QtNodes
@@ -28,5 +28,12 @@ public:
     QColor BackgroundColor;
     QColor FineGridColor;
     QColor CoarseGridColor;
+
+    /// Scene distance between the lines of the fine and the coarse grid.
+    double FineGridStep = 15.0;
+    double CoarseGridStep = 150.0;
+
+    /// A grid is not drawn once its lines get closer than this on screen, in pixels.
+    double MinimumGridSpacing = 5.0;
 };
 } // namespace QtNodes
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "Export.hpp"
+#include <cstddef>
 #include <memory>
+#include <optional>
 #include <set>
 #include <QColor>
 #include <QDebug>
@@ -40,6 +42,14 @@ public:
     virtual NodeDataType type() const = 0;
 
     virtual bool empty() const = 0;
+
+    /**
+   * Cheap hash of the data's content, used by the memoization of
+   * `NodeDelegateModel`. Equal content must give equal hashes, and since the
+   * content itself is not compared, different content must give different
+   * hashes. Data without a hash never matches memoized outputs.
+   */
+    virtual std::optional<std::size_t> contentHash() const { return std::nullopt; }
 };
 
 } // namespace QtNodes
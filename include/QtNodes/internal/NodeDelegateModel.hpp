@@ -1,9 +1,11 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
 
 #include <QtWidgets/QWidget>
 
+#include "CancellationToken.hpp"
 #include "Definitions.hpp"
 #include "Export.hpp"
 #include "NodeData.hpp"
@@ -12,6 +14,7 @@
 
 namespace QtNodes {
 
+class DataFlowEvaluationEngine;
 class StyleCollection;
 
 /**
@@ -80,6 +83,48 @@ public:
 
     virtual bool resizable() const { return false; }
 
+    /**
+   * Models returning `true` split storing the inputs from computing the
+   * outputs: `setInData` only keeps the new value and the graph model calls
+   * `compute()` afterwards. With the asynchronous evaluation enabled in
+   * DataFlowGraphModel, `compute()` runs on a worker thread and therefore
+   * must not touch the embedded widget or other GUI-thread objects.
+   */
+    virtual bool threadSafeCompute() const { return false; }
+
+    /**
+   * Computes the outputs from the stored inputs and announces them with
+   * `dataUpdated`. Only called for models with `threadSafeCompute()`.
+   */
+    virtual void compute() {}
+
+    /**
+   * Token of the running `compute()`. With the asynchronous evaluation it is
+   * cancelled as soon as newer inputs arrive for the node: the results of
+   * the compute are then dropped, the previous outputs are restored with
+   * `restoreOutData`, and the node computes again with the latest inputs.
+   * Long computes should poll it and return early.
+   */
+    CancellationToken const &cancellationToken() const { return _cancellationToken; }
+
+    /**
+   * Number of input combinations whose outputs are kept for reuse, 0 (the
+   * default) disables the memoization. Only used with `threadSafeCompute()`.
+   *
+   * When the inputs hash, see `NodeData::contentHash()`, like those of a
+   * kept entry, `compute()` is skipped. Nothing is propagated if they are
+   * the inputs of the current outputs, otherwise the kept outputs are handed
+   * back with `restoreOutData` and propagated. The outputs must therefore
+   * depend on the inputs only.
+   */
+    virtual std::size_t memoizationCacheSize() const { return 0; }
+
+    /**
+   * Reinstates an output previously returned by `outData`. Used by the
+   * memoization and to take back the outputs of a superseded compute.
+   */
+    virtual void restoreOutData(std::shared_ptr<NodeData>, PortIndex const) {}
+
 public Q_SLOTS:
 
     virtual void inputConnectionCreated(ConnectionId const &) {}
@@ -104,6 +149,13 @@ Q_SIGNALS:
 
     void embeddedWidgetSizeUpdated();
 
+    /// Call this function when the contents of the embedded widget changed.
+    /**
+   * Scenes painting a snapshot of the widget, see
+   * `BasicGraphicsScene::setDeferredWidgetsEnabled`, retake it.
+   */
+    void embeddedWidgetUpdated();
+
     /// Call this function before deleting the data associated with ports.
     /**
    * The function notifies the Graph Model and makes it remove and recompute the
@@ -127,7 +179,11 @@ Q_SIGNALS:
     void portsInserted();
 
 private:
+    friend class DataFlowEvaluationEngine;
+
     NodeStyle _nodeStyle;
+
+    CancellationToken _cancellationToken;
 };
 
 } // namespace QtNodes
@@ -1,16 +1,22 @@
 #pragma once
 
 #include <QtCore/QUuid>
+#include <QtGui/QPixmap>
 #include <QtWidgets/QGraphicsObject>
 
 #include "NodeState.hpp"
 
+#include <cstdint>
+#include <memory>
+
 class QGraphicsProxyWidget;
+class QTimer;
 
 namespace QtNodes {
 
 class BasicGraphicsScene;
 class AbstractGraphModel;
+class NodeStyle;
 
 class NodeGraphicsObject : public QGraphicsObject
 {
@@ -39,6 +45,21 @@ public:
 
     void setGeometryChanged();
 
+    /// Style used to paint the node, cached while the model's style version holds.
+    NodeStyle const &nodeStyle() const;
+
+    /// Drops the cached style, e.g. after the node was updated.
+    void invalidateNodeStyle();
+
+    /// Re-reads the caption, returns `true` if it changed since the last call.
+    bool refreshCaption();
+
+    /// Toggles the shadow and the embedded widget for low detail painting.
+    void setLowDetail(bool lowDetail);
+
+    /// Applies the scene's `BasicGraphicsScene::ShadowMode`.
+    void updateShadow();
+
     /// Visits all attached connections and corrects
     /// their corresponding end points.
     void moveConnections() const;
@@ -46,6 +67,30 @@ public:
     /// Repaints the node once with reacting ports.
     void reactToConnection(ConnectionGraphicsObject const *cgo);
 
+    /// Hands the embedded widget back to the delegate model.
+    /**
+   * Called before a virtualized scene releases the object, so the widget
+   * survives the proxy and is embedded again by the next object of the node.
+   */
+    void detachEmbeddedWidget();
+
+    /// Whether the embedded widget currently lives in a proxy.
+    bool embeddedWidgetActive() const { return _proxyWidget != nullptr; }
+
+    /// Creates the proxy of a deferred embedded widget.
+    /**
+   * See `BasicGraphicsScene::setDeferredWidgetsEnabled`. The proxy is
+   * released again after the scene's widget release delay without hover
+   * or focus.
+   */
+    void activateEmbeddedWidget();
+
+    /// Replaces the proxy by a snapshot of the widget.
+    void releaseEmbeddedWidget();
+
+    /// Drops the snapshot, the next paint of a released widget takes a new one.
+    void invalidateWidgetSnapshot();
+
 protected:
     void paint(QPainter *painter,
                QStyleOptionGraphicsItem const *option,
@@ -74,6 +119,14 @@ private:
 
     void setLockedState();
 
+    /// Restarts the countdown to `releaseEmbeddedWidget`.
+    void scheduleWidgetRelease();
+
+    /// Hovered, focused or grabbing the mouse.
+    bool embeddedWidgetInUse() const;
+
+    void paintWidgetSnapshot(QPainter *painter);
+
 private:
     NodeId _nodeId;
 
@@ -81,7 +134,19 @@ private:
 
     NodeState _nodeState;
 
+    mutable std::shared_ptr<NodeStyle const> _nodeStyle;
+
+    mutable std::uint64_t _nodeStyleVersion = 0;
+
+    /// Caption the node was last laid out with.
+    QString _caption;
+
     // either nullptr or owned by parent QGraphicsItem
     QGraphicsProxyWidget *_proxyWidget;
+
+    /// Painted instead of a deferred or released proxy.
+    QPixmap _widgetSnapshot;
+
+    QTimer *_widgetReleaseTimer = nullptr;
 };
 } // namespace QtNodes
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "AbstractNodePainter.hpp"
+#include "Definitions.hpp"
+#include "Export.hpp"
+
+#include <memory>
+
+namespace QtNodes {
+
+class DataFlowGraphModel;
+
+/**
+ * Decorates another node painter with a tint showing how expensive the
+ * node is to evaluate, from green for the cheapest to red for the hottest
+ * node. The values come from the graph model's `NodeProfiler`, nodes are
+ * painted untouched while the profiling is disabled.
+ *
+ * The nodes are repainted when they receive new data, call `update()` on
+ * the scene to refresh all of them, e.g. after switching the metric.
+ */
+class NODE_EDITOR_PUBLIC NodeHeatMapPainter : public AbstractNodePainter
+{
+public:
+    enum class Metric
+    {
+        CumulativeComputeTime, ///< All the computes since the profiling started.
+        LastComputeTime,       ///< The most recent compute only.
+    };
+
+public:
+    NodeHeatMapPainter(std::unique_ptr<AbstractNodePainter> painter,
+                       DataFlowGraphModel const &graphModel,
+                       Metric metric = Metric::CumulativeComputeTime);
+
+    void paint(QPainter *painter, NodeGraphicsObject &ngo) const override;
+
+    void paintLowDetail(QPainter *painter, NodeGraphicsObject &ngo) const override;
+
+    Metric metric() const { return _metric; }
+
+    void setMetric(Metric metric) { _metric = metric; }
+
+    /**
+   * The node's metric relative to the highest one, from 0 to 1. Negative
+   * for nodes without any recorded compute.
+   */
+    double heat(NodeId const nodeId) const;
+
+private:
+    void drawHeat(QPainter *painter, NodeGraphicsObject &ngo) const;
+
+private:
+    std::unique_ptr<AbstractNodePainter> _painter;
+
+    DataFlowGraphModel const &_graphModel;
+
+    Metric _metric;
+};
+
+} // namespace QtNodes
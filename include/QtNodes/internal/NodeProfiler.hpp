@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Definitions.hpp"
+#include "Export.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace QtNodes {
+
+/**
+ * Evaluation statistics of a single node, gathered by `NodeProfiler`.
+ *
+ * A compute is a call of `NodeDelegateModel::compute()` for the models
+ * reporting `threadSafeCompute()`, and a call of `setInData` for all the
+ * other models, which compute there.
+ */
+struct NODE_EDITOR_PUBLIC NodeProfile
+{
+    using Duration = std::chrono::steady_clock::duration;
+
+    /// Number of the most recent compute durations kept per node.
+    static constexpr std::size_t HistorySize = 32;
+
+    std::uint64_t setInDataCount = 0;
+    Duration setInDataTime{};
+
+    std::uint64_t computeCount = 0;
+    Duration computeTime{};
+
+    /// From the first input of a wave to the node's next `dataUpdated`.
+    std::uint64_t latencyCount = 0;
+    Duration latencyTime{};
+    Duration lastLatency{};
+
+    /// Deliveries of the node's output data to the connected nodes, the
+    /// conversions and the receivers' `setInData` included.
+    std::uint64_t fanOutCount = 0;
+    Duration fanOutTime{};
+
+    /// Ring buffer of the compute durations, `historyNext` is the oldest
+    /// entry once the buffer is full.
+    std::array<Duration, HistorySize> history{};
+    std::size_t historyNext = 0;
+
+    Duration lastComputeTime() const;
+
+    Duration averageComputeTime() const;
+
+    /// Compute durations from the oldest to the most recent one.
+    std::vector<Duration> recentComputeTimes() const;
+};
+
+/**
+ * Records per-node timings of a `DataFlowGraphModel`.
+ *
+ * Only exists while `DataFlowGraphModel::setProfilingEnabled(true)`, so a
+ * disabled profiler costs the graph model a null pointer check. Samples are
+ * taken with `std::chrono::steady_clock` and stored in fixed size per-node
+ * records. Computes running on worker threads are measured there and
+ * recorded on the graph model's thread.
+ */
+class NODE_EDITOR_PUBLIC NodeProfiler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    using Duration = NodeProfile::Duration;
+
+public:
+    /// `nullptr` for nodes without any recorded sample.
+    NodeProfile const *profile(NodeId const nodeId) const;
+
+    std::vector<NodeId> profiledNodes() const;
+
+    /// Highest `NodeProfile::computeTime` of all the nodes.
+    Duration maxComputeTime() const { return _maxComputeTime; }
+
+    /// Longest single compute of all the nodes.
+    Duration maxSingleComputeTime() const { return _maxSingleComputeTime; }
+
+    void reset();
+
+public:
+    void recordSetInData(NodeId const nodeId, Duration const duration);
+
+    void recordCompute(NodeId const nodeId, Duration const duration);
+
+    void recordFanOut(NodeId const nodeId, Duration const duration);
+
+    /// Starts the latency measurement unless one is already running.
+    void recordInputArrival(NodeId const nodeId, Clock::time_point const time);
+
+    /// Ends the running latency measurement, if any.
+    void recordDataUpdated(NodeId const nodeId, Clock::time_point const time);
+
+    void removeNode(NodeId const nodeId);
+
+private:
+    std::unordered_map<NodeId, NodeProfile> _profiles;
+
+    /// Arrival of the first input not yet answered with `dataUpdated`.
+    std::unordered_map<NodeId, Clock::time_point> _inputArrivals;
+
+    Duration _maxComputeTime{};
+
+    Duration _maxSingleComputeTime{};
+};
+
+} // namespace QtNodes
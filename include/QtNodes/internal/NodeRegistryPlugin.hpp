@@ -0,0 +1,30 @@
+#pragma once
+
+#include <QtCore/QtPlugin>
+
+namespace QtNodes {
+
+class NodeDelegateModelRegistry;
+
+/**
+ * Interface of the Qt plugins providing delegate models to applications
+ * that do not link them, e.g. `qtnodes_run`.
+ *
+ * The plugin class derives from `QObject` and this interface, declares
+ * `Q_INTERFACES(QtNodes::NodeRegistryPlugin)` and
+ * `Q_PLUGIN_METADATA(IID QtNodes_NodeRegistryPlugin_iid)`.
+ */
+class NodeRegistryPlugin
+{
+public:
+    virtual ~NodeRegistryPlugin() = default;
+
+    /// Registers the plugin's delegate models and type converters.
+    virtual void registerModels(NodeDelegateModelRegistry &registry) = 0;
+};
+
+} // namespace QtNodes
+
+#define QtNodes_NodeRegistryPlugin_iid "org.qtnodes.NodeRegistryPlugin/1.0"
+
+Q_DECLARE_INTERFACE(QtNodes::NodeRegistryPlugin, QtNodes_NodeRegistryPlugin_iid)
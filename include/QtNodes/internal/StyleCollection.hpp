@@ -6,6 +6,9 @@
 #include "GraphicsViewStyle.hpp"
 #include "NodeStyle.hpp"
 
+#include <cstdint>
+#include <memory>
+
 namespace QtNodes {
 
 class NODE_EDITOR_PUBLIC StyleCollection
@@ -13,6 +16,12 @@ class NODE_EDITOR_PUBLIC StyleCollection
 public:
     static NodeStyle const &nodeStyle();
 
+    /// Shared immutable copy of `nodeStyle()`, replaced on every `setNodeStyle`.
+    static std::shared_ptr<NodeStyle const> nodeStyleHandle();
+
+    /// Incremented each time the node style is replaced.
+    static std::uint64_t nodeStyleVersion();
+
     static ConnectionStyle const &connectionStyle();
 
     static GraphicsViewStyle const &flowViewStyle();
@@ -36,6 +45,10 @@ private:
 private:
     NodeStyle _nodeStyle;
 
+    std::shared_ptr<NodeStyle const> _nodeStyleHandle;
+
+    std::uint64_t _nodeStyleVersion = 0;
+
     ConnectionStyle _connectionStyle;
 
     GraphicsViewStyle _flowViewStyle;
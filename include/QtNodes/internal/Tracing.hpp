@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Export.hpp"
+
+#include <QtCore/QString>
+
+namespace QtNodes {
+
+/**
+ * Records begin/end events of the library's hot paths and writes them as a
+ * Chrome trace JSON file, viewable in `chrome://tracing` or Perfetto.
+ *
+ * The events are only compiled in when the library is configured with
+ * `-DQT_NODES_TRACING=ON`, otherwise `start()` returns `false` and the
+ * instrumented code carries no trace calls at all. Traced are the change
+ * waves and the computes of `DataFlowGraphModel`, the reconciliation of
+ * `BasicGraphicsScene` with its graph model, the painting of nodes and
+ * connections, and saving and loading. Every event carries the id of the
+ * thread it was recorded on, node events also carry the node id.
+ */
+class NODE_EDITOR_PUBLIC Tracing
+{
+public:
+    /// Whether the library was built with the trace events.
+    static bool compiledIn();
+
+    /**
+   * Starts recording, the events are kept in memory until `stop()`.
+   * Returns `false` if the tracing was not compiled in.
+   */
+    static bool start(QString const &fileName);
+
+    /// Writes the recorded events to the file given to `start()`.
+    static bool stop();
+
+    static bool isActive();
+};
+
+} // namespace QtNodes
@@ -1,18 +1,127 @@
 #pragma once
 
 #include "Definitions.hpp"
+#include "Export.hpp"
 
 #include <QUndoCommand>
+#include <QtCore/QByteArray>
 #include <QtCore/QJsonObject>
 #include <QtCore/QPointF>
 
-#include <unordered_set>
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace QtNodes {
 
+class AbstractGraphModel;
 class BasicGraphicsScene;
 
-class CreateCommand : public QUndoCommand
+/// Node state stored by the undo commands.
+struct NodeSnapshot
+{
+    NodeId nodeId;
+
+    QPointF position;
+
+    /// Compact JSON of the node's "internal-data". Equal states share one blob.
+    std::shared_ptr<QByteArray const> state;
+};
+
+/**
+ * Hands out equal node states as one shared blob.
+ *
+ * Owned by the scene, see `BasicGraphicsScene::nodeStatePool()`, and used
+ * from the GUI thread only. The pool does not keep the blobs alive; entries
+ * of released blobs are pruned as the pool grows.
+ */
+class NODE_EDITOR_PUBLIC NodeStatePool
+{
+public:
+    std::shared_ptr<QByteArray const> intern(QByteArray const &bytes);
+
+    /// Drops the entries of released blobs and the buckets left empty.
+    void prune();
+
+    /// Number of distinct hashes with a live or not yet pruned blob.
+    std::size_t bucketCount() const { return _buckets.size(); }
+
+private:
+    std::unordered_map<std::size_t, std::vector<std::weak_ptr<QByteArray const>>> _buckets;
+
+    /// Bucket count at which `intern` prunes the pool.
+    std::size_t _pruneThreshold = 64;
+};
+
+/**
+ * Immutable snapshot of some nodes and connections.
+ *
+ * Replaces whole-scene JSON documents in the undo history: only the
+ * per-node internal data is serialized, and identical internal data (e.g.
+ * many nodes of one model with default settings) is stored once. The
+ * states are kept whole rather than as deltas, a node's state is only
+ * available through `saveNode()` and `loadNode()` as a complete object.
+ */
+class NODE_EDITOR_PUBLIC GraphFragment
+{
+public:
+    /// Captures the given nodes and connections of `graphModel`.
+    static GraphFragment capture(AbstractGraphModel const &graphModel,
+                                 NodeStatePool &pool,
+                                 std::vector<NodeId> const &nodeIds,
+                                 std::vector<ConnectionId> connectionIds);
+
+    /// Reads the clipboard format produced by `CopyCommand`.
+    static GraphFragment fromJson(QJsonObject const &sceneJson, NodeStatePool &pool);
+
+    bool empty() const { return _nodes.empty() && _connections.empty(); }
+
+    /// Loads nodes, then connections, and selects them.
+    void insert(BasicGraphicsScene *scene) const;
+
+    /// Deletes connections, then nodes.
+    void remove(AbstractGraphModel &graphModel) const;
+
+    /// Gives the nodes fresh ids of `graphModel` and drops dangling connections.
+    void renumber(AbstractGraphModel &graphModel);
+
+    void offset(QPointF const &diff);
+
+    QPointF averagePosition() const;
+
+    /// Approximate heap usage, shared blobs are split between their owners.
+    std::size_t memoryCost() const;
+
+    void clear();
+
+private:
+    std::vector<NodeSnapshot> _nodes;
+
+    std::vector<ConnectionId> _connections;
+};
+
+/**
+ * Base of the commands pushed to `BasicGraphicsScene::undoStack()`.
+ *
+ * The scene sums `memoryCost()` over the history and, when a budget is set,
+ * calls `releaseState()` on the oldest commands. A released command turns
+ * into an obsolete no-op which `QUndoStack` drops once it is reached.
+ */
+class NODE_EDITOR_PUBLIC GraphUndoCommand : public QUndoCommand
+{
+public:
+    using QUndoCommand::QUndoCommand;
+
+    virtual std::size_t memoryCost() const = 0;
+
+    void releaseState();
+
+protected:
+    virtual void clearState() = 0;
+};
+
+class NODE_EDITOR_PUBLIC CreateCommand : public GraphUndoCommand
 {
 public:
     CreateCommand(BasicGraphicsScene *scene, QString const name, QPointF const &mouseScenePos);
@@ -22,17 +131,22 @@ public:
 
     [[nodiscard]] NodeId getNodeId() const;
 
+    std::size_t memoryCost() const override;
+
+protected:
+    void clearState() override;
+
 private:
     BasicGraphicsScene *_scene;
     NodeId _nodeId;
-    QJsonObject _sceneJson;
+    GraphFragment _fragment;
 };
 
 /**
- * Selected scene objects are serialized and then removed from the scene.
+ * Selected scene objects are captured and then removed from the scene.
  * The deleted elements could be restored in `undo`.
  */
-class DeleteCommand : public QUndoCommand
+class NODE_EDITOR_PUBLIC DeleteCommand : public GraphUndoCommand
 {
 public:
     DeleteCommand(BasicGraphicsScene *scene);
@@ -40,18 +154,23 @@ public:
     void undo() override;
     void redo() override;
 
+    std::size_t memoryCost() const override;
+
+protected:
+    void clearState() override;
+
 private:
     BasicGraphicsScene *_scene;
-    QJsonObject _sceneJson;
+    GraphFragment _fragment;
 };
 
-class CopyCommand : public QUndoCommand
+class NODE_EDITOR_PUBLIC CopyCommand : public QUndoCommand
 {
 public:
     CopyCommand(BasicGraphicsScene *scene);
 };
 
-class PasteCommand : public QUndoCommand
+class NODE_EDITOR_PUBLIC PasteCommand : public GraphUndoCommand
 {
 public:
     PasteCommand(BasicGraphicsScene *scene, QPointF const &mouseScenePos);
@@ -59,17 +178,20 @@ public:
     void undo() override;
     void redo() override;
 
+    std::size_t memoryCost() const override;
+
+protected:
+    void clearState() override;
+
 private:
     QJsonObject takeSceneJsonFromClipboard();
-    QJsonObject makeNewNodeIdsInScene(QJsonObject const &sceneJson);
 
 private:
     BasicGraphicsScene *_scene;
-    QPointF const &_mouseScenePos;
-    QJsonObject _newSceneJson;
+    GraphFragment _fragment;
 };
 
-class DisconnectCommand : public QUndoCommand
+class NODE_EDITOR_PUBLIC DisconnectCommand : public GraphUndoCommand
 {
 public:
     DisconnectCommand(BasicGraphicsScene *scene, ConnectionId const);
@@ -77,13 +199,18 @@ public:
     void undo() override;
     void redo() override;
 
+    std::size_t memoryCost() const override;
+
+protected:
+    void clearState() override {}
+
 private:
     BasicGraphicsScene *_scene;
 
     ConnectionId _connId;
 };
 
-class ConnectCommand : public QUndoCommand
+class NODE_EDITOR_PUBLIC ConnectCommand : public GraphUndoCommand
 {
 public:
     ConnectCommand(BasicGraphicsScene *scene, ConnectionId const);
@@ -91,17 +218,28 @@ public:
     void undo() override;
     void redo() override;
 
+    std::size_t memoryCost() const override;
+
+protected:
+    void clearState() override {}
+
 private:
     BasicGraphicsScene *_scene;
 
     ConnectionId _connId;
 };
 
-class MoveNodeCommand : public QUndoCommand
+class NODE_EDITOR_PUBLIC MoveNodeCommand : public GraphUndoCommand
 {
 public:
+    /// Moves the scene's current selection by `diff`.
     MoveNodeCommand(BasicGraphicsScene *scene, QPointF const &diff);
 
+    /// Records an already applied move of `nodeIds` by `diff`, the first `redo` does nothing.
+    MoveNodeCommand(BasicGraphicsScene *scene,
+                    std::shared_ptr<std::vector<NodeId> const> nodeIds,
+                    QPointF const &diff);
+
     void undo() override;
     void redo() override;
 
@@ -116,10 +254,23 @@ public:
    */
     bool mergeWith(QUndoCommand const *c) override;
 
+    std::size_t memoryCost() const override;
+
+protected:
+    void clearState() override;
+
+private:
+    void translate(QPointF const &diff);
+
 private:
     BasicGraphicsScene *_scene;
-    std::unordered_set<NodeId> _selectedNodes;
+
+    /// Shared with the scene's selection cache, so a drag holds a single id set.
+    std::shared_ptr<std::vector<NodeId> const> _nodeIds;
+
     QPointF _diff;
+
+    bool _applied;
 };
 
 } // namespace QtNodes
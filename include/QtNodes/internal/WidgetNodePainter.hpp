@@ -12,6 +12,8 @@ namespace QtNodes {
 
         void paint(QPainter *painter, NodeGraphicsObject &ngo) const override;
 
+        void paintLowDetail(QPainter *painter, NodeGraphicsObject &ngo) const override;
+
         void drawNodeBackground(QPainter *painter, NodeGraphicsObject &ngo) const;
 
         void drawNodeBoundary(QPainter *painter, NodeGraphicsObject &ngo) const;
@@ -1,16 +1,103 @@
 #include "AbstractGraphModel.hpp"
 #include "Definitions.hpp"
+#include "NodeData.hpp"
+#include "StyleCollection.hpp"
 
 #include <QtNodes/ConnectionIdUtils>
 
+#include <QtCore/QJsonDocument>
+
+#include <vector>
+
 namespace QtNodes {
 
+std::shared_ptr<NodeStyle const> AbstractGraphModel::nodeStyle(NodeId const nodeId) const
+{
+    const QVariant style = nodeData(nodeId, NodeRole::Style);
+    if (!style.isValid()) {
+        return StyleCollection::nodeStyleHandle();
+    }
+
+    return std::make_shared<NodeStyle const>(QJsonDocument::fromVariant(style).object());
+}
+
+std::uint64_t AbstractGraphModel::nodeStyleVersion(NodeId const nodeId) const
+{
+    Q_UNUSED(nodeId);
+    return StyleCollection::nodeStyleVersion();
+}
+
+DataTypeHandle AbstractGraphModel::portTypeHandle(NodeId const nodeId,
+                                                  PortType const portType,
+                                                  PortIndex const index) const
+{
+    return DataTypeRegistry::intern(
+        portData<NodeDataType>(nodeId, portType, index, PortRole::DataType));
+}
+
+std::vector<NodeId> AbstractGraphModel::addNodes(std::vector<QString> const &nodeTypes)
+{
+    std::vector<NodeId> nodeIds;
+    nodeIds.reserve(nodeTypes.size());
+
+    for (QString const &nodeType : nodeTypes) {
+        nodeIds.push_back(addNode(nodeType));
+    }
+
+    return nodeIds;
+}
+
+void AbstractGraphModel::addConnections(std::vector<ConnectionId> const &connectionIds)
+{
+    for (ConnectionId const &connectionId : connectionIds) {
+        addConnection(connectionId);
+    }
+}
+
+void AbstractGraphModel::deleteNodes(std::unordered_set<NodeId> const &nodeIds)
+{
+    for (NodeId const nodeId : nodeIds) {
+        deleteNode(nodeId);
+    }
+}
+
+bool AbstractGraphModel::wouldCreateCycle(NodeId const outNodeId, NodeId const inNodeId) const
+{
+    if (outNodeId == inNodeId) {
+        return true;
+    }
+
+    std::unordered_set<NodeId> visited{inNodeId};
+    std::vector<NodeId> stack{inNodeId};
+
+    while (!stack.empty()) {
+        const NodeId nodeId = stack.back();
+        stack.pop_back();
+
+        const PortCount nOutPorts = nodeData<PortCount>(nodeId, NodeRole::OutPortCount);
+        for (PortIndex index = 0; index < nOutPorts; ++index) {
+            for (ConnectionId const &cn : connections(nodeId, PortType::Out, index)) {
+                if (cn.inNodeId == outNodeId) {
+                    return true;
+                }
+
+                if (visited.insert(cn.inNodeId).second) {
+                    stack.push_back(cn.inNodeId);
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
 void AbstractGraphModel::portsAboutToBeDeleted(NodeId const nodeId,
                                                PortType const portType,
                                                PortIndex const first,
                                                PortIndex const last)
 {
     _shiftedByDynamicPortsConnections.clear();
+    _portsChangedNodeId = nodeId;
 
     const auto portCountRole = portType == PortType::In ? NodeRole::InPortCount
                                                         : NodeRole::OutPortCount;
@@ -51,6 +138,14 @@ void AbstractGraphModel::portsAboutToBeDeleted(NodeId const nodeId,
 
 void AbstractGraphModel::portsDeleted()
 {
+    const NodeId nodeId = _portsChangedNodeId;
+    _portsChangedNodeId = InvalidNodeId;
+
+    // The shifted connections are placed with the new ports.
+    if (nodeId != InvalidNodeId) {
+        Q_EMIT nodePortsUpdated(nodeId);
+    }
+
     for (auto const connectionId : _shiftedByDynamicPortsConnections) {
         addConnection(connectionId);
     }
@@ -64,6 +159,7 @@ void AbstractGraphModel::portsAboutToBeInserted(NodeId const nodeId,
                                                 PortIndex const last)
 {
     _shiftedByDynamicPortsConnections.clear();
+    _portsChangedNodeId = nodeId;
 
     const auto portCountRole = portType == PortType::In ? NodeRole::InPortCount
                                                         : NodeRole::OutPortCount;
@@ -92,6 +188,14 @@ void AbstractGraphModel::portsAboutToBeInserted(NodeId const nodeId,
 
 void AbstractGraphModel::portsInserted()
 {
+    const NodeId nodeId = _portsChangedNodeId;
+    _portsChangedNodeId = InvalidNodeId;
+
+    // The shifted connections are placed with the new ports.
+    if (nodeId != InvalidNodeId) {
+        Q_EMIT nodePortsUpdated(nodeId);
+    }
+
     for (auto const connectionId : _shiftedByDynamicPortsConnections) {
         addConnection(connectionId);
     }
@@ -12,7 +12,21 @@ namespace QtNodes {
 AbstractNodeGeometry::AbstractNodeGeometry(AbstractGraphModel &graphModel)
     : _graphModel(graphModel)
 {
-    //
+    _portsConnection = QObject::connect(&_graphModel,
+                                        &AbstractGraphModel::nodePortsUpdated,
+                                        [this](NodeId const nodeId) { invalidate(nodeId); });
+
+    _sizeConnection = QObject::connect(&_graphModel,
+                                       &AbstractGraphModel::nodeSizeUpdated,
+                                       [this](NodeId const nodeId) {
+                                           invalidatePositions(nodeId);
+                                       });
+}
+
+AbstractNodeGeometry::~AbstractNodeGeometry()
+{
+    QObject::disconnect(_portsConnection);
+    QObject::disconnect(_sizeConnection);
 }
 
 QRectF AbstractNodeGeometry::boundingRect(NodeId const nodeId) const
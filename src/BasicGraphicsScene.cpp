@@ -3,12 +3,16 @@
 #include "AbstractNodeGeometry.hpp"
 #include "ConnectionGraphicsObject.hpp"
 #include "ConnectionIdUtils.hpp"
+#include "ConnectionLayer.hpp"
 #include "DefaultHorizontalNodeGeometry.hpp"
 #include "DefaultNodePainter.hpp"
 #include "DefaultVerticalNodeGeometry.hpp"
 #include "GraphicsView.hpp"
 #include "NodeGraphicsObject.hpp"
 #include "QtNodes/InvalidData.hpp"
+#include "SpatialGridIndex.hpp"
+#include "TraceScope.hpp"
+#include "UndoCommands.hpp"
 #include "WidgetHorizontalNodeGeometry.hpp"
 
 #include <QUndoStack>
@@ -23,8 +27,10 @@
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
+#include <QtCore/QTimer>
 #include <QtCore/QtGlobal>
 
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 #include <unordered_set>
@@ -34,11 +40,36 @@
 
 namespace QtNodes {
 
+    namespace {
+        /// Released connection objects kept for reuse by a virtualized scene.
+        constexpr std::size_t maxPooledConnections = 256;
+    }
+
+    /// Nodes and offset of the drag in progress.
+    struct BasicGraphicsScene::DragSession {
+        /// Selection taken when the drag started.
+        std::shared_ptr<std::vector<NodeId> const> nodeIds;
+
+        std::vector<QPointF> startPositions;
+
+        /// Offset accumulated from the mouse events.
+        QPointF offset;
+
+        /// Offset the nodes are currently moved by.
+        QPointF applied;
+
+        bool frameScheduled = false;
+    };
+
     BasicGraphicsScene::BasicGraphicsScene(AbstractGraphModel &graphModel, QObject *parent)
             : QGraphicsScene(parent), _graphModel(graphModel),
               _nodeGeometry(std::make_unique<DefaultHorizontalNodeGeometry>(_graphModel)),
               _nodePainter(std::make_unique<DefaultNodePainter>()), _nodeDrag(false), _undoStack(new QUndoStack(this)),
-              _orientation(Qt::Horizontal) {
+              _nodeStatePool(std::make_unique<NodeStatePool>()), _undoMemoryBudget(0), _undoHistoryCost(0), _undoReleased(0),
+              _undoAccountedLast(nullptr), _orientation(Qt::Horizontal), _lowDetailMode(false),
+              _virtualized(false), _deferredWidgets(false), _widgetReleaseDelay(2000),
+              _nodeShadowMode(ShadowMode::Effect), _connectionBatchingScheduled(false),
+              _dragSessionsEnabled(false), _dragFrameInterval(16) {
         setItemIndexMethod(QGraphicsScene::NoIndex);
 
         connect(&_graphModel,
@@ -61,6 +92,26 @@ namespace QtNodes {
                 this,
                 &BasicGraphicsScene::onNodeDeleted);
 
+        connect(&_graphModel,
+                &AbstractGraphModel::nodesCreated,
+                this,
+                &BasicGraphicsScene::onNodesCreated);
+
+        connect(&_graphModel,
+                &AbstractGraphModel::nodesDeleted,
+                this,
+                &BasicGraphicsScene::onNodesDeleted);
+
+        connect(&_graphModel,
+                &AbstractGraphModel::connectionsCreated,
+                this,
+                &BasicGraphicsScene::onConnectionsCreated);
+
+        connect(&_graphModel,
+                &AbstractGraphModel::connectionsDeleted,
+                this,
+                &BasicGraphicsScene::onConnectionsDeleted);
+
         connect(&_graphModel,
                 &AbstractGraphModel::nodePositionUpdated,
                 this,
@@ -71,10 +122,29 @@ namespace QtNodes {
                 this,
                 &BasicGraphicsScene::onNodeUpdated);
 
+        connect(&_graphModel,
+                &AbstractGraphModel::nodeWidgetUpdated,
+                this,
+                &BasicGraphicsScene::onNodeWidgetUpdated);
+
         connect(this, &BasicGraphicsScene::nodeClicked, this, &BasicGraphicsScene::onNodeClicked);
 
         connect(&_graphModel, &AbstractGraphModel::modelReset, this, &BasicGraphicsScene::onModelReset);
 
+        connect(this, &QGraphicsScene::selectionChanged, this, [this]() { _selectedNodeIds.reset(); });
+
+        connect(this,
+                &QGraphicsScene::selectionChanged,
+                this,
+                &BasicGraphicsScene::scheduleConnectionBatching);
+
+        connect(this,
+                &BasicGraphicsScene::connectionHoverLeft,
+                this,
+                &BasicGraphicsScene::scheduleConnectionBatching);
+
+        connect(_undoStack, &QUndoStack::indexChanged, this, [this]() { enforceUndoMemoryBudget(); });
+
         traverseGraphAndPopulateGraphicsObjects();
     }
 
@@ -104,6 +174,98 @@ namespace QtNodes {
         return *_undoStack;
     }
 
+    NodeStatePool &BasicGraphicsScene::nodeStatePool() {
+        return *_nodeStatePool;
+    }
+
+    void BasicGraphicsScene::setUndoMemoryBudget(std::size_t bytes) {
+        _undoMemoryBudget = bytes;
+
+        // The history is not accounted while unlimited.
+        resetUndoAccounting();
+        enforceUndoMemoryBudget();
+    }
+
+    std::shared_ptr<std::vector<NodeId> const> BasicGraphicsScene::selectedNodeIds() const {
+        if (!_selectedNodeIds) {
+            auto nodeIds = std::make_shared<std::vector<NodeId>>();
+            for (QGraphicsItem *item: selectedItems()) {
+                if (auto n = qgraphicsitem_cast<NodeGraphicsObject *>(item)) {
+                    nodeIds->push_back(n->nodeId());
+                }
+            }
+            std::sort(nodeIds->begin(), nodeIds->end());
+            _selectedNodeIds = std::move(nodeIds);
+        }
+
+        return _selectedNodeIds;
+    }
+
+    void BasicGraphicsScene::enforceUndoMemoryBudget() {
+        if (_undoMemoryBudget == 0) {
+            return;
+        }
+
+        // The latest undoable command and the redo side are never released.
+        const int latest = _undoStack->index() - 1;
+        const std::size_t end = static_cast<std::size_t>(std::max(latest, 0));
+
+        // Commands were removed or replaced below the accounted ones, e.g. a
+        // released command dropped by an undo or the stack's undo limit.
+        const int accounted = static_cast<int>(_undoCommandCosts.size());
+        const bool shifted = accounted > _undoStack->count()
+                             || (accounted > 0
+                                 && _undoStack->command(accounted - 1) != _undoAccountedLast);
+        if (shifted || end < _undoReleased) {
+            resetUndoAccounting();
+        }
+
+        // Undone commands leave the accounting with the cost they entered it.
+        while (_undoCommandCosts.size() > end) {
+            _undoHistoryCost -= _undoCommandCosts.back();
+            _undoCommandCosts.pop_back();
+        }
+
+        while (_undoCommandCosts.size() < end) {
+            const std::size_t cost = undoCommandCost(static_cast<int>(_undoCommandCosts.size()));
+            _undoCommandCosts.push_back(cost);
+            _undoHistoryCost += cost;
+        }
+
+        _undoAccountedLast = end > 0 ? _undoStack->command(static_cast<int>(end) - 1) : nullptr;
+
+        // Merges keep changing the latest command, it is measured every time.
+        const std::size_t latestCost = latest >= 0 ? undoCommandCost(latest) : 0;
+
+        while (_undoHistoryCost + latestCost > _undoMemoryBudget && _undoReleased < end) {
+            auto command = dynamic_cast<GraphUndoCommand *>(
+                const_cast<QUndoCommand *>(_undoStack->command(static_cast<int>(_undoReleased))));
+            if (command) {
+                command->releaseState();
+            }
+
+            _undoHistoryCost -= _undoCommandCosts[_undoReleased];
+            _undoCommandCosts[_undoReleased] = 0;
+            ++_undoReleased;
+        }
+    }
+
+    std::size_t BasicGraphicsScene::undoCommandCost(int const index) const {
+        auto command = dynamic_cast<GraphUndoCommand const *>(_undoStack->command(index));
+        if (!command || command->isObsolete()) {
+            return 0;
+        }
+
+        return command->memoryCost();
+    }
+
+    void BasicGraphicsScene::resetUndoAccounting() {
+        _undoCommandCosts.clear();
+        _undoHistoryCost = 0;
+        _undoReleased = 0;
+        _undoAccountedLast = nullptr;
+    }
+
     std::unique_ptr<ConnectionGraphicsObject> const &BasicGraphicsScene::makeDraftConnection(
             ConnectionId const incompleteConnectionId) {
         _draftConnection = std::make_unique<ConnectionGraphicsObject>(*this, incompleteConnectionId);
@@ -145,6 +307,42 @@ namespace QtNodes {
         return cgo;
     }
 
+    NodeGraphicsObject *BasicGraphicsScene::materializeNode(NodeId nodeId) {
+        if (auto ngo = nodeGraphicsObject(nodeId)) {
+            return ngo;
+        }
+
+        if (!_graphModel.nodeExists(nodeId)) {
+            return nullptr;
+        }
+
+        auto ngo = std::make_unique<NodeGraphicsObject>(*this, nodeId);
+        NodeGraphicsObject *result = ngo.get();
+        _nodeGraphicsObjects[nodeId] = std::move(ngo);
+        return result;
+    }
+
+    ConnectionGraphicsObject *BasicGraphicsScene::materializeConnection(ConnectionId connectionId) {
+        if (!connectionGraphicsObject(connectionId)) {
+            if (!_graphModel.connectionExists(connectionId)) {
+                return nullptr;
+            }
+            createConnectionGraphicsObject(connectionId);
+        }
+
+        return connectionGraphicsObject(connectionId);
+    }
+
+    QTransform BasicGraphicsScene::nodeSceneTransform(NodeId nodeId) const {
+        const auto it = _nodeGraphicsObjects.find(nodeId);
+        if (it != _nodeGraphicsObjects.end()) {
+            return it->second->sceneTransform();
+        }
+
+        const QPointF pos = _graphModel.nodeData<QPointF>(nodeId, NodeRole::Position);
+        return QTransform::fromTranslate(pos.x(), pos.y());
+    }
+
     void BasicGraphicsScene::setOrientation(Qt::Orientation const orientation) {
         if (_orientation != orientation) {
             _orientation = orientation;
@@ -168,14 +366,618 @@ namespace QtNodes {
         onModelReset();
     }
 
+    void BasicGraphicsScene::setSpatialIndexEnabled(bool enabled) {
+        if (enabled == spatialIndexEnabled()) {
+            return;
+        }
+
+        if (!enabled) {
+            // Released items can only be found through the index.
+            setVirtualizationEnabled(false);
+            _nodeIndex.reset();
+            _connectionIndex.reset();
+            return;
+        }
+
+        _nodeIndex = std::make_unique<SpatialGridIndex<NodeId>>();
+        _connectionIndex = std::make_unique<SpatialGridIndex<ConnectionId>>();
+
+        for (auto const &node: _nodeGraphicsObjects) {
+            updateSpatialIndex(*node.second);
+        }
+
+        for (auto const &connection: _connectionGraphicsObjects) {
+            updateSpatialIndex(*connection.second);
+        }
+
+        if (_connectionLayer) {
+            for (ConnectionId const &connectionId: _connectionLayer->connectionIds()) {
+                indexConnection(connectionId);
+            }
+        }
+    }
+
+    std::vector<NodeId> BasicGraphicsScene::nodesInRect(QRectF const &sceneRect) const {
+        if (_nodeIndex) {
+            return _nodeIndex->query(sceneRect);
+        }
+
+        std::vector<NodeId> result;
+        for (auto const &node: _nodeGraphicsObjects) {
+            if (node.second->sceneBoundingRect().intersects(sceneRect)) {
+                result.push_back(node.first);
+            }
+        }
+        return result;
+    }
+
+    std::vector<ConnectionId> BasicGraphicsScene::connectionsInRect(QRectF const &sceneRect) const {
+        if (_connectionIndex) {
+            return _connectionIndex->query(sceneRect);
+        }
+
+        std::vector<ConnectionId> result;
+        if (_connectionLayer) {
+            result = _connectionLayer->connectionsInRect(sceneRect);
+        }
+
+        for (auto const &connection: _connectionGraphicsObjects) {
+            if (connection.second->sceneBoundingRect().intersects(sceneRect)) {
+                result.push_back(connection.first);
+            }
+        }
+        return result;
+    }
+
+    NodeGraphicsObject *BasicGraphicsScene::nodeGraphicsObjectAt(QPointF const &scenePoint) {
+        NodeGraphicsObject *topmost = nullptr;
+
+        auto consider = [&](NodeGraphicsObject *ngo) {
+            if (!ngo || !ngo->isVisible() || !ngo->contains(ngo->mapFromScene(scenePoint))) {
+                return;
+            }
+
+            if (!topmost || ngo->zValue() > topmost->zValue()) {
+                topmost = ngo;
+            }
+        };
+
+        if (_nodeIndex) {
+            for (NodeId const nodeId: _nodeIndex->query(scenePoint)) {
+                consider(nodeGraphicsObject(nodeId));
+            }
+        } else {
+            for (auto const &node: _nodeGraphicsObjects) {
+                consider(node.second.get());
+            }
+        }
+
+        return topmost;
+    }
+
+    void BasicGraphicsScene::updateSpatialIndex(NodeGraphicsObject const &ngo) {
+        if (_nodeIndex) {
+            _nodeIndex->insert(ngo.nodeId(), ngo.sceneBoundingRect());
+        }
+    }
+
+    void BasicGraphicsScene::updateSpatialIndex(ConnectionGraphicsObject const &cgo) {
+        // Draft connections are transient and never looked up.
+        if (_connectionIndex && !cgo.connectionState().requiresPort()) {
+            _connectionIndex->insert(cgo.connectionId(), cgo.sceneBoundingRect());
+        }
+    }
+
+    void BasicGraphicsScene::moveReleasedConnections(NodeId const nodeId) {
+        if (!_virtualized && !_connectionLayer) {
+            return;
+        }
+
+        for (ConnectionId const &connectionId: _graphModel.allConnectionIds(nodeId)) {
+            if (!connectionGraphicsObject(connectionId)) {
+                moveReleasedConnection(connectionId);
+            }
+        }
+    }
+
+    void BasicGraphicsScene::moveReleasedConnection(ConnectionId const connectionId) {
+        if (_connectionIndex) {
+            indexConnection(connectionId);
+        }
+
+        if (_connectionLayer) {
+            _connectionLayer->insert(connectionId);
+        }
+    }
+
+    void BasicGraphicsScene::setLowDetailMode(bool lowDetail) {
+        if (_lowDetailMode == lowDetail) {
+            return;
+        }
+
+        _lowDetailMode = lowDetail;
+
+        for (auto const &node: _nodeGraphicsObjects) {
+            node.second->setLowDetail(lowDetail);
+        }
+
+        // Low detail connections are straight lines with a different shape.
+        for (auto const &connection: _connectionGraphicsObjects) {
+            connection.second->invalidatePath();
+            connection.second->update();
+        }
+
+        if (_connectionLayer) {
+            _connectionLayer->update();
+        }
+    }
+
+    void BasicGraphicsScene::setDeferredWidgetsEnabled(bool enabled) {
+        if (_deferredWidgets == enabled) {
+            return;
+        }
+
+        _deferredWidgets = enabled;
+
+        for (auto const &node: _nodeGraphicsObjects) {
+            NodeGraphicsObject &ngo = *node.second;
+            if (!enabled) {
+                ngo.activateEmbeddedWidget();
+            } else if (!ngo.nodeState().hovered()) {
+                ngo.releaseEmbeddedWidget();
+            }
+        }
+    }
+
+    void BasicGraphicsScene::setWidgetReleaseDelay(int msec) {
+        _widgetReleaseDelay = std::max(0, msec);
+    }
+
+    void BasicGraphicsScene::setNodeShadowMode(ShadowMode mode) {
+        if (_nodeShadowMode == mode) {
+            return;
+        }
+
+        _nodeShadowMode = mode;
+
+        for (auto const &node: _nodeGraphicsObjects) {
+            node.second->updateShadow();
+        }
+    }
+
+    void BasicGraphicsScene::setVirtualizationEnabled(bool enabled) {
+        if (_virtualized == enabled) {
+            return;
+        }
+
+        _virtualized = enabled;
+
+        if (enabled) {
+            setSpatialIndexEnabled(true);
+            _materializedRect = QRectF();
+            updateMaterializedItems();
+            return;
+        }
+
+        _connectionPool.clear();
+        _materializedRect = QRectF();
+
+        for (NodeId const nodeId: _graphModel.allNodeIds()) {
+            materializeNode(nodeId);
+        }
+
+        // Batched connections stay in the layer.
+        if (_connectionLayer) {
+            return;
+        }
+
+        for (NodeId const nodeId: _graphModel.allNodeIds()) {
+            for (ConnectionId const &connectionId: _graphModel.allConnectionIds(nodeId)) {
+                if (connectionId.outNodeId == nodeId) {
+                    materializeConnection(connectionId);
+                }
+            }
+        }
+    }
+
+    void BasicGraphicsScene::setBatchedConnectionsEnabled(bool enabled) {
+        if (enabled == batchedConnectionsEnabled()) {
+            return;
+        }
+
+        if (enabled) {
+            _connectionLayer = std::make_unique<ConnectionLayer>(*this);
+
+            // Connections released by the virtualization.
+            for (NodeId const nodeId: _graphModel.allNodeIds()) {
+                for (ConnectionId const &connectionId: _graphModel.allConnectionIds(nodeId)) {
+                    if (connectionId.outNodeId == nodeId
+                        && !connectionGraphicsObject(connectionId)) {
+                        _connectionLayer->insert(connectionId);
+                    }
+                }
+            }
+
+            batchReleasableConnections();
+            return;
+        }
+
+        const std::vector<ConnectionId> connectionIds = _connectionLayer->connectionIds();
+        _connectionLayer.reset();
+
+        for (ConnectionId const &connectionId: connectionIds) {
+            placeConnection(connectionId);
+        }
+    }
+
+    void BasicGraphicsScene::updateMaterializedItems() {
+        NODE_EDITOR_TRACE_SCOPE("materializeItems");
+
+        if (!_virtualized) {
+            return;
+        }
+
+        QRectF visible;
+        for (QGraphicsView *view: views()) {
+            visible |= view->mapToScene(view->viewport()->rect()).boundingRect();
+        }
+
+        if (visible.isEmpty()) {
+            materializeRegion(QRectF());
+            return;
+        }
+
+        // Half a viewport of margin on every side, so small pans create nothing.
+        const double margin = 0.5 * std::max(visible.width(), visible.height());
+        const QRectF region = visible.adjusted(-margin, -margin, margin, margin);
+
+        // After zooming in, the old area is shrunk once it is much larger than needed.
+        const double area = region.width() * region.height();
+        const double materializedArea = _materializedRect.width() * _materializedRect.height();
+
+        if (_materializedRect.contains(visible) && materializedArea <= 4.0 * area) {
+            return;
+        }
+
+        materializeRegion(region);
+    }
+
+    void BasicGraphicsScene::materializeRegion(QRectF const &region) {
+        _materializedRect = region;
+
+        // Released first, so that the pooled connection objects are reused below.
+        std::vector<ConnectionId> releasedConnections;
+        for (auto const &connection: _connectionGraphicsObjects) {
+            ConnectionGraphicsObject const &cgo = *connection.second;
+            if (!region.intersects(cgo.sceneBoundingRect()) && isReleasable(cgo)) {
+                releasedConnections.push_back(connection.first);
+            }
+        }
+
+        std::vector<NodeId> releasedNodes;
+        for (auto const &node: _nodeGraphicsObjects) {
+            NodeGraphicsObject const &ngo = *node.second;
+            if (!region.intersects(ngo.sceneBoundingRect()) && isReleasable(ngo)) {
+                releasedNodes.push_back(node.first);
+            }
+        }
+
+        for (ConnectionId const &connectionId: releasedConnections) {
+            releaseConnection(connectionId);
+        }
+
+        for (NodeId const nodeId: releasedNodes) {
+            releaseNode(nodeId);
+        }
+
+        if (region.isEmpty()) {
+            return;
+        }
+
+        for (NodeId const nodeId: _nodeIndex->query(region)) {
+            materializeNode(nodeId);
+        }
+
+        // The layer draws the connections, its own paint skips the hidden ones.
+        if (_connectionLayer) {
+            return;
+        }
+
+        for (ConnectionId const &connectionId: _connectionIndex->query(region)) {
+            if (!connectionGraphicsObject(connectionId)) {
+                createConnectionGraphicsObject(connectionId);
+            }
+        }
+    }
+
+    bool BasicGraphicsScene::isReleasable(QGraphicsObject const &object) const {
+        if (object.isSelected() || object.isUnderMouse() || mouseGrabberItem() == &object) {
+            return false;
+        }
+
+        QGraphicsItem const *focus = focusItem();
+        return !focus || (focus != &object && !object.isAncestorOf(focus));
+    }
+
+    void BasicGraphicsScene::releaseNode(NodeId const nodeId) {
+        const auto it = _nodeGraphicsObjects.find(nodeId);
+        if (it == _nodeGraphicsObjects.end()) {
+            return;
+        }
+
+        // The index keeps the last rect of the node.
+        it->second->detachEmbeddedWidget();
+        _nodeGraphicsObjects.erase(it);
+    }
+
+    void BasicGraphicsScene::releaseConnection(ConnectionId const connectionId) {
+        const auto it = _connectionGraphicsObjects.find(connectionId);
+        if (it == _connectionGraphicsObjects.end()) {
+            return;
+        }
+
+        UniqueConnectionGraphicsObject cgo = std::move(it->second);
+        _connectionGraphicsObjects.erase(it);
+
+        if (_connectionPool.size() < maxPooledConnections) {
+            removeItem(cgo.get());
+            _connectionPool.push_back(std::move(cgo));
+        }
+
+        if (_connectionLayer) {
+            _connectionLayer->insert(connectionId);
+        }
+    }
+
+    void BasicGraphicsScene::scheduleConnectionBatching() {
+        if (!_connectionLayer || _connectionBatchingScheduled) {
+            return;
+        }
+
+        _connectionBatchingScheduled = true;
+
+        // Deferred, the request comes from event handlers of the objects themselves.
+        QTimer::singleShot(0, this, [this]() { batchReleasableConnections(); });
+    }
+
+    void BasicGraphicsScene::batchReleasableConnections() {
+        _connectionBatchingScheduled = false;
+
+        if (!_connectionLayer) {
+            return;
+        }
+
+        std::vector<ConnectionId> releasedConnections;
+        for (auto const &connection: _connectionGraphicsObjects) {
+            ConnectionGraphicsObject const &cgo = *connection.second;
+            if (!cgo.connectionState().hovered() && isReleasable(cgo)) {
+                releasedConnections.push_back(connection.first);
+            }
+        }
+
+        for (ConnectionId const &connectionId: releasedConnections) {
+            releaseConnection(connectionId);
+        }
+    }
+
+    void BasicGraphicsScene::setDragSessionsEnabled(bool enabled) {
+        if (!enabled && _dragSession) {
+            endDragSession();
+        }
+
+        _dragSessionsEnabled = enabled;
+    }
+
+    void BasicGraphicsScene::setDragFrameInterval(int msec) {
+        _dragFrameInterval = std::max(0, msec);
+    }
+
+    void BasicGraphicsScene::beginDragSession() {
+        if (_dragSession) {
+            endDragSession();
+        }
+
+        _dragSession = std::make_unique<DragSession>();
+        _dragSession->nodeIds = selectedNodeIds();
+
+        _dragSession->startPositions.reserve(_dragSession->nodeIds->size());
+        for (NodeId const nodeId: *_dragSession->nodeIds) {
+            _dragSession->startPositions.push_back(
+                _graphModel.nodeData(nodeId, NodeRole::Position).value<QPointF>());
+        }
+    }
+
+    void BasicGraphicsScene::updateDragSession(QPointF const &diff) {
+        if (!_dragSession) {
+            return;
+        }
+
+        _dragSession->offset += diff;
+
+        if (_dragSession->frameScheduled) {
+            return;
+        }
+
+        _dragSession->frameScheduled = true;
+
+        QTimer::singleShot(_dragFrameInterval, this, [this]() {
+            if (_dragSession) {
+                applyDragFrame();
+            }
+        });
+    }
+
+    void BasicGraphicsScene::endDragSession() {
+        if (!_dragSession) {
+            return;
+        }
+
+        applyDragFrame();
+
+        const std::unique_ptr<DragSession> session = std::move(_dragSession);
+
+        if (!session->applied.isNull()) {
+            _undoStack->push(new MoveNodeCommand(this, session->nodeIds, session->applied));
+        }
+    }
+
+    void BasicGraphicsScene::applyDragFrame() {
+        NODE_EDITOR_TRACE_SCOPE("dragFrame");
+
+        DragSession &session = *_dragSession;
+        session.frameScheduled = false;
+
+        if (session.offset == session.applied) {
+            return;
+        }
+
+        session.applied = session.offset;
+
+        std::vector<NodeGraphicsObject *> moved;
+        moved.reserve(session.nodeIds->size());
+
+        for (std::size_t i = 0; i < session.nodeIds->size(); ++i) {
+            const NodeId nodeId = (*session.nodeIds)[i];
+
+            // The connections are updated once below, not after every node.
+            NodeGraphicsObject *ngo = nodeGraphicsObject(nodeId);
+            const bool sendsChanges = ngo
+                                      && ngo->flags().testFlag(
+                                          QGraphicsItem::ItemSendsScenePositionChanges);
+            if (sendsChanges) {
+                ngo->setFlag(QGraphicsItem::ItemSendsScenePositionChanges, false);
+            }
+
+            _graphModel.setNodeData(nodeId,
+                                    NodeRole::Position,
+                                    session.startPositions[i] + session.applied);
+
+            if (sendsChanges) {
+                ngo->setFlag(QGraphicsItem::ItemSendsScenePositionChanges, true);
+                moved.push_back(ngo);
+            }
+        }
+
+        std::unordered_set<ConnectionId> connections;
+        QRectF movedRect;
+
+        for (NodeGraphicsObject *ngo: moved) {
+            const auto nodeConnections = _graphModel.allConnectionIds(ngo->nodeId());
+            connections.insert(nodeConnections.begin(), nodeConnections.end());
+
+            movedRect |= ngo->sceneBoundingRect();
+        }
+
+        for (ConnectionId const &connectionId: connections) {
+            if (auto cgo = connectionGraphicsObject(connectionId)) {
+                cgo->move();
+            } else if (_virtualized || _connectionLayer) {
+                moveReleasedConnection(connectionId);
+            }
+        }
+
+        if (!movedRect.isNull()) {
+            setSceneRect(sceneRect().united(movedRect));
+        }
+    }
+
+    QRectF BasicGraphicsScene::indexNode(NodeId const nodeId) {
+        const QPointF pos = _graphModel.nodeData<QPointF>(nodeId, NodeRole::Position);
+        const QRectF rect = _nodeGeometry->boundingRect(nodeId).translated(pos);
+        _nodeIndex->insert(nodeId, rect);
+        return rect;
+    }
+
+    QRectF BasicGraphicsScene::indexConnection(ConnectionId const connectionId) {
+        const QPointF out = _nodeGeometry->portScenePosition(connectionId.outNodeId,
+                                                             PortType::Out,
+                                                             connectionId.outPortIndex,
+                                                             nodeSceneTransform(
+                                                                 connectionId.outNodeId));
+        const QPointF in = _nodeGeometry->portScenePosition(connectionId.inNodeId,
+                                                            PortType::In,
+                                                            connectionId.inPortIndex,
+                                                            nodeSceneTransform(
+                                                                connectionId.inNodeId));
+        const QRectF rect = ConnectionGraphicsObject::pathBoundingRect(out, in, _orientation);
+        _connectionIndex->insert(connectionId, rect);
+        return rect;
+    }
+
+    void BasicGraphicsScene::relocateReleasedNode(NodeId const nodeId) {
+        const bool visible = _materializedRect.intersects(indexNode(nodeId));
+
+        for (ConnectionId const &connectionId: _graphModel.allConnectionIds(nodeId)) {
+            if (auto cgo = connectionGraphicsObject(connectionId)) {
+                cgo->move();
+            } else {
+                placeConnection(connectionId);
+            }
+        }
+
+        if (visible) {
+            materializeNode(nodeId);
+        }
+    }
+
+    void BasicGraphicsScene::createConnectionGraphicsObject(ConnectionId const connectionId) {
+        if (_connectionLayer) {
+            _connectionLayer->remove(connectionId);
+        }
+
+        if (_connectionPool.empty()) {
+            _connectionGraphicsObjects[connectionId]
+                = std::make_unique<ConnectionGraphicsObject>(*this, connectionId);
+            return;
+        }
+
+        UniqueConnectionGraphicsObject cgo = std::move(_connectionPool.back());
+        _connectionPool.pop_back();
+
+        addItem(cgo.get());
+        cgo->reset(connectionId);
+        _connectionGraphicsObjects[connectionId] = std::move(cgo);
+    }
+
+    void BasicGraphicsScene::placeConnection(ConnectionId const connectionId) {
+        if (_connectionLayer) {
+            if (_connectionIndex) {
+                indexConnection(connectionId);
+            }
+            _connectionLayer->insert(connectionId);
+        } else if (!_virtualized || _materializedRect.intersects(indexConnection(connectionId))) {
+            createConnectionGraphicsObject(connectionId);
+        }
+    }
+
     QMenu *BasicGraphicsScene::createSceneMenu(QPointF const scenePos) {
         Q_UNUSED(scenePos);
         return nullptr;
     }
 
     void BasicGraphicsScene::traverseGraphAndPopulateGraphicsObjects() {
+        NODE_EDITOR_TRACE_SCOPE("populateScene");
+
         const auto allNodeIds = _graphModel.allNodeIds();
 
+        if (_virtualized) {
+            for (NodeId const nodeId: allNodeIds) {
+                _nodeGeometry->recomputeSize(nodeId);
+                indexNode(nodeId);
+            }
+
+            for (NodeId const nodeId: allNodeIds) {
+                for (ConnectionId const &connectionId: _graphModel.allConnectionIds(nodeId)) {
+                    if (connectionId.outNodeId == nodeId) {
+                        placeConnection(connectionId);
+                    }
+                }
+            }
+
+            materializeRegion(_materializedRect);
+            return;
+        }
+
         // First create all the nodes.
         for (NodeId const nodeId: allNodeIds) {
             _nodeGraphicsObjects[nodeId] = std::make_unique<NodeGraphicsObject>(*this, nodeId);
@@ -190,8 +992,7 @@ namespace QtNodes {
                                                                            PortType::Out,
                                                                            index);
                     for (const auto &cid : outConnectionIds) {
-                        _connectionGraphicsObjects[cid]
-                            = std::make_unique<ConnectionGraphicsObject>(*this, cid);
+                        placeConnection(cid);
                     }
             }
         }
@@ -212,6 +1013,14 @@ namespace QtNodes {
             _connectionGraphicsObjects.erase(it);
         }
 
+        if (_connectionIndex) {
+            _connectionIndex->remove(connectionId);
+        }
+
+        if (_connectionLayer) {
+            _connectionLayer->remove(connectionId);
+        }
+
         // TODO: do we need it?
         if (_draftConnection && _draftConnection->connectionId() == connectionId) {
             _draftConnection.reset();
@@ -222,20 +1031,102 @@ namespace QtNodes {
 
     void BasicGraphicsScene::onConnectionCreated(const ConnectionId connectionId)
     {
-        _connectionGraphicsObjects[connectionId]
-            = std::make_unique<ConnectionGraphicsObject>(*this, connectionId);
+        placeConnection(connectionId);
         updateAttachedNodes(connectionId, PortType::Out);
         updateAttachedNodes(connectionId, PortType::In);
     }
 
+    void BasicGraphicsScene::onConnectionsDeleted(std::vector<ConnectionId> const &connectionIds) {
+        NODE_EDITOR_TRACE_SCOPE("connectionsDeleted");
+
+        std::unordered_set<NodeId> attachedNodes;
+
+        for (ConnectionId const &connectionId: connectionIds) {
+            _connectionGraphicsObjects.erase(connectionId);
+
+            if (_connectionIndex) {
+                _connectionIndex->remove(connectionId);
+            }
+
+            if (_connectionLayer) {
+                _connectionLayer->remove(connectionId);
+            }
+
+            if (_draftConnection && _draftConnection->connectionId() == connectionId) {
+                _draftConnection.reset();
+            }
+
+            attachedNodes.insert(connectionId.outNodeId);
+            attachedNodes.insert(connectionId.inNodeId);
+        }
+
+        for (NodeId const nodeId: attachedNodes) {
+            if (auto node = nodeGraphicsObject(nodeId)) {
+                node->update();
+            }
+        }
+    }
+
+    void BasicGraphicsScene::onConnectionsCreated(std::vector<ConnectionId> const &connectionIds) {
+        NODE_EDITOR_TRACE_SCOPE("connectionsCreated");
+
+        _connectionGraphicsObjects.reserve(_connectionGraphicsObjects.size() + connectionIds.size());
+
+        std::unordered_set<NodeId> attachedNodes;
+
+        for (ConnectionId const &connectionId: connectionIds) {
+            placeConnection(connectionId);
+
+            attachedNodes.insert(connectionId.outNodeId);
+            attachedNodes.insert(connectionId.inNodeId);
+        }
+
+        for (NodeId const nodeId: attachedNodes) {
+            if (auto node = nodeGraphicsObject(nodeId)) {
+                node->update();
+            }
+        }
+    }
+
+    void BasicGraphicsScene::onNodesDeleted(std::vector<NodeId> const &nodeIds) {
+        NODE_EDITOR_TRACE_SCOPE("nodesDeleted");
+
+        for (NodeId const nodeId: nodeIds) {
+            onNodeDeleted(nodeId);
+        }
+    }
+
+    void BasicGraphicsScene::onNodesCreated(std::vector<NodeId> const &nodeIds) {
+        NODE_EDITOR_TRACE_SCOPE("nodesCreated");
+
+        _nodeGraphicsObjects.reserve(_nodeGraphicsObjects.size() + nodeIds.size());
+
+        for (NodeId const nodeId: nodeIds) {
+            onNodeCreated(nodeId);
+        }
+    }
+
     void BasicGraphicsScene::onNodeDeleted(NodeId const nodeId) {
         auto it = _nodeGraphicsObjects.find(nodeId);
         if (it != _nodeGraphicsObjects.end()) {
             _nodeGraphicsObjects.erase(it);
         }
+
+        if (_nodeIndex) {
+            _nodeIndex->remove(nodeId);
+        }
+
+        _nodeGeometry->invalidate(nodeId);
     }
 
     void BasicGraphicsScene::onNodeCreated(NodeId const nodeId) {
+        if (_virtualized) {
+            _nodeGeometry->recomputeSize(nodeId);
+            if (!_materializedRect.intersects(indexNode(nodeId))) {
+                return;
+            }
+        }
+
         _nodeGraphicsObjects[nodeId] = std::make_unique<NodeGraphicsObject>(*this, nodeId);
     }
 
@@ -243,18 +1134,53 @@ namespace QtNodes {
         auto node = nodeGraphicsObject(nodeId);
         if (node) {
             node->setPos(_graphModel.nodeData(nodeId, NodeRole::Position).value<QPointF>());
+            updateSpatialIndex(*node);
             node->update();
             _nodeDrag = true;
+        } else if (_virtualized) {
+            relocateReleasedNode(nodeId);
         }
     }
 
     void BasicGraphicsScene::onNodeUpdated(NodeId const nodeId) {
         auto node = nodeGraphicsObject(nodeId);
         if (node) {
+            node->refreshCaption();
+            node->invalidateNodeStyle();
+            node->invalidateWidgetSnapshot();
             node->setGeometryChanged();
+            _nodeGeometry->invalidate(nodeId);
             _nodeGeometry->recomputeSize(nodeId);
+            updateSpatialIndex(*node);
             node->update();
             node->moveConnections();
+        } else if (_virtualized) {
+            _nodeGeometry->invalidate(nodeId);
+            _nodeGeometry->recomputeSize(nodeId);
+            relocateReleasedNode(nodeId);
+        }
+    }
+
+    void BasicGraphicsScene::onNodeDataUpdated(NodeId const nodeId) {
+        // Released nodes are measured again when they are materialized.
+        auto node = nodeGraphicsObject(nodeId);
+        if (!node) {
+            return;
+        }
+
+        if (node->refreshCaption()) {
+            onNodeUpdated(nodeId);
+            return;
+        }
+
+        node->update();
+    }
+
+    void BasicGraphicsScene::onNodeWidgetUpdated(NodeId const nodeId) {
+        auto node = nodeGraphicsObject(nodeId);
+        if (node && !node->embeddedWidgetActive()) {
+            node->invalidateWidgetSnapshot();
+            node->update();
         }
     }
 
@@ -267,9 +1193,29 @@ namespace QtNodes {
     }
 
     void BasicGraphicsScene::onModelReset() {
+        NODE_EDITOR_TRACE_SCOPE("modelReset");
+
+        _dragSession.reset();
         _connectionGraphicsObjects.clear();
         _nodeGraphicsObjects.clear();
+        _nodeGeometry->invalidateAll();
+        if (_nodeIndex) {
+            _nodeIndex->clear();
+            _connectionIndex->clear();
+        }
+
+        // The layer outlives `clear()`, which deletes every item of the scene.
+        if (_connectionLayer) {
+            removeItem(_connectionLayer.get());
+            _connectionLayer->clear();
+        }
+
         clear();
+
+        if (_connectionLayer) {
+            addItem(_connectionLayer.get());
+        }
+
         traverseGraphAndPopulateGraphicsObjects();
     }
 
@@ -380,5 +1326,17 @@ namespace QtNodes {
         }
     }
 
+    bool BasicGraphicsScene::event(QEvent *event) {
+        // Also delivered after an application font change.
+        if (event->type() == QEvent::FontChange) {
+            _nodeGeometry->invalidateAll();
+            for (NodeId const nodeId : _graphModel.allNodeIds()) {
+                onNodeUpdated(nodeId);
+            }
+        }
+
+        return QGraphicsScene::event(event);
+    }
+
 
 } // namespace QtNodes
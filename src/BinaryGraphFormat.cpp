@@ -0,0 +1,222 @@
+#include "BinaryGraphFormat.hpp"
+
+#include <QtCore/QIODevice>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QtEndian>
+
+namespace QtNodes {
+
+namespace {
+
+constexpr QDataStream::Version StreamVersion = QDataStream::Qt_5_11;
+
+bool isKnownSection(quint32 tag)
+{
+    using BinaryGraphFormat::Section;
+
+    return tag == static_cast<quint32>(Section::Nodes)
+           || tag == static_cast<quint32>(Section::Connections)
+           || tag == static_cast<quint32>(Section::End);
+}
+
+} // namespace
+
+bool BinaryGraphFormat::isBinaryGraph(QIODevice &device)
+{
+    const QByteArray head = device.peek(sizeof(quint32));
+    if (head.size() != sizeof(quint32)) {
+        return false;
+    }
+
+    return qFromBigEndian<quint32>(head.constData()) == Magic;
+}
+
+QJsonObject BinaryNodeRecord::internalDataJson() const
+{
+    return QJsonDocument::fromJson(internalData).object();
+}
+
+BinaryGraphWriter::BinaryGraphWriter(QIODevice &device)
+    : _stream(&device)
+{
+    _stream.setVersion(StreamVersion);
+    _stream << BinaryGraphFormat::Magic << BinaryGraphFormat::Version;
+}
+
+void BinaryGraphWriter::beginSection(BinaryGraphFormat::Section section, quint64 recordCount)
+{
+    _stream << static_cast<quint32>(section) << recordCount;
+}
+
+void BinaryGraphWriter::writeNode(NodeId const nodeId,
+                                  QPointF const &position,
+                                  QJsonObject const &internalData)
+{
+    _recordBuffer.clear();
+
+    {
+        QDataStream record(&_recordBuffer, QIODevice::WriteOnly);
+        record.setVersion(StreamVersion);
+        record << static_cast<qint64>(nodeId) << position.x() << position.y()
+               << QJsonDocument(internalData).toJson(QJsonDocument::Compact);
+    }
+
+    _stream.writeBytes(_recordBuffer.constData(), static_cast<uint>(_recordBuffer.size()));
+}
+
+void BinaryGraphWriter::writeConnection(ConnectionId const &connectionId)
+{
+    constexpr uint recordSize = 4 * sizeof(qint64);
+
+    _stream << static_cast<quint32>(recordSize) << static_cast<qint64>(connectionId.outNodeId)
+            << static_cast<qint64>(connectionId.outPortIndex)
+            << static_cast<qint64>(connectionId.inNodeId)
+            << static_cast<qint64>(connectionId.inPortIndex);
+}
+
+void BinaryGraphWriter::finish()
+{
+    beginSection(BinaryGraphFormat::Section::End, 0);
+}
+
+bool BinaryGraphWriter::hasError() const
+{
+    return _stream.status() != QDataStream::Ok;
+}
+
+BinaryGraphReader::BinaryGraphReader(QIODevice &device)
+    : _stream(&device)
+{
+    _stream.setVersion(StreamVersion);
+}
+
+bool BinaryGraphReader::readHeader()
+{
+    quint32 magic = 0;
+    _stream >> magic >> _version;
+
+    if (_stream.status() != QDataStream::Ok || magic != BinaryGraphFormat::Magic) {
+        return fail(QStringLiteral("Not a binary graph file"));
+    }
+
+    if (_version == 0 || _version > BinaryGraphFormat::Version) {
+        return fail(QStringLiteral("Unsupported binary graph version %1").arg(_version));
+    }
+
+    return true;
+}
+
+bool BinaryGraphReader::nextSection(BinaryGraphFormat::Section &section, quint64 &recordCount)
+{
+    QByteArray skipped;
+
+    while (!hasError()) {
+        while (_remainingRecords > 0) {
+            if (!readRecord(skipped)) {
+                return false;
+            }
+        }
+
+        quint32 tag = 0;
+        _stream >> tag >> recordCount;
+
+        if (_stream.status() != QDataStream::Ok) {
+            return fail(QStringLiteral("Truncated binary graph"));
+        }
+
+        _remainingRecords = recordCount;
+
+        if (tag == static_cast<quint32>(BinaryGraphFormat::Section::End)) {
+            section = BinaryGraphFormat::Section::End;
+            return false;
+        }
+
+        if (isKnownSection(tag)) {
+            section = static_cast<BinaryGraphFormat::Section>(tag);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool BinaryGraphReader::readNode(BinaryNodeRecord &record)
+{
+    QByteArray payload;
+    if (!readRecord(payload)) {
+        return false;
+    }
+
+    QDataStream stream(payload);
+    stream.setVersion(StreamVersion);
+
+    qint64 id = 0;
+    double x = 0.0;
+    double y = 0.0;
+    stream >> id >> x >> y >> record.internalData;
+
+    if (stream.status() != QDataStream::Ok) {
+        return fail(QStringLiteral("Corrupted node record"));
+    }
+
+    record.id = static_cast<NodeId>(id);
+    record.position = QPointF(x, y);
+
+    return true;
+}
+
+bool BinaryGraphReader::readConnection(ConnectionId &connectionId)
+{
+    QByteArray payload;
+    if (!readRecord(payload)) {
+        return false;
+    }
+
+    QDataStream stream(payload);
+    stream.setVersion(StreamVersion);
+
+    qint64 outNodeId = 0;
+    qint64 outPortIndex = 0;
+    qint64 inNodeId = 0;
+    qint64 inPortIndex = 0;
+    stream >> outNodeId >> outPortIndex >> inNodeId >> inPortIndex;
+
+    if (stream.status() != QDataStream::Ok) {
+        return fail(QStringLiteral("Corrupted connection record"));
+    }
+
+    connectionId = ConnectionId{static_cast<NodeId>(outNodeId),
+                                static_cast<PortIndex>(outPortIndex),
+                                static_cast<NodeId>(inNodeId),
+                                static_cast<PortIndex>(inPortIndex)};
+
+    return true;
+}
+
+bool BinaryGraphReader::readRecord(QByteArray &payload)
+{
+    if (hasError() || _remainingRecords == 0) {
+        return false;
+    }
+
+    _stream >> payload;
+
+    if (_stream.status() != QDataStream::Ok) {
+        return fail(QStringLiteral("Truncated binary graph"));
+    }
+
+    --_remainingRecords;
+
+    return true;
+}
+
+bool BinaryGraphReader::fail(QString const &error)
+{
+    if (_errorString.isEmpty()) {
+        _errorString = error;
+    }
+
+    return false;
+}
+
+} // namespace QtNodes
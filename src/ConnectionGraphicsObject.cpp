@@ -10,6 +10,7 @@
 #include "NodeConnectionInteraction.hpp"
 #include "NodeGraphicsObject.hpp"
 #include "StyleCollection.hpp"
+#include "TraceScope.hpp"
 #include "locateNode.hpp"
 
 #include <QtWidgets/QGraphicsBlurEffect>
@@ -60,16 +61,12 @@ void ConnectionGraphicsObject::initializePosition()
         const PortType attachedPort = oppositePort(_connectionState.requiredPort());
         const PortIndex portIndex = getPortIndex(attachedPort, _connectionId);
         const NodeId nodeId = getNodeId(attachedPort, _connectionId);
-        const NodeGraphicsObject *ngo = nodeScene()->nodeGraphicsObject(nodeId);
-        if (ngo) {
-            const QTransform nodeSceneTransform = ngo->sceneTransform();
-            const AbstractNodeGeometry &geometry = nodeScene()->nodeGeometry();
-            const QPointF pos = geometry.portScenePosition(nodeId,
-                                                           attachedPort,
-                                                           portIndex,
-                                                           nodeSceneTransform);
-            this->setPos(pos);
-        }
+        const AbstractNodeGeometry &geometry = nodeScene()->nodeGeometry();
+        const QPointF pos = geometry.portScenePosition(nodeId,
+                                                       attachedPort,
+                                                       portIndex,
+                                                       nodeScene()->nodeSceneTransform(nodeId));
+        this->setPos(pos);
     }
 
     move();
@@ -92,9 +89,19 @@ ConnectionId const &ConnectionGraphicsObject::connectionId() const
 
 QRectF ConnectionGraphicsObject::boundingRect() const
 {
-    const auto points = pointsC1C2();
+    if (_boundingRect.isNull()) {
+        _boundingRect = pathBoundingRect(_out, _in, nodeScene()->orientation());
+    }
+    return _boundingRect;
+}
+
+QRectF ConnectionGraphicsObject::pathBoundingRect(QPointF const &out,
+                                                  QPointF const &in,
+                                                  Qt::Orientation orientation)
+{
+    const auto points = pointsC1C2(out, in, orientation);
     // `normalized()` fixes inverted rects.
-    const QRectF basicRect = QRectF(_out, _in).normalized();
+    const QRectF basicRect = QRectF(out, in).normalized();
     const QRectF c1c2Rect = QRectF(points.first, points.second).normalized();
     QRectF commonRect = basicRect.united(c1c2Rect);
     const auto &connectionStyle = StyleCollection::connectionStyle();
@@ -118,10 +125,47 @@ QPainterPath ConnectionGraphicsObject::shape() const
     //return path;
 
 #else
-    return ConnectionPainter::getPainterStroke(*this);
+    if (_shape.isEmpty()) {
+        _shape = ConnectionPainter::getPainterStroke(*this);
+    }
+    return _shape;
 #endif
 }
 
+bool ConnectionGraphicsObject::contains(QPointF const &point) const
+{
+    return boundingRect().contains(point) && ConnectionPainter::hitTest(*this, point);
+}
+
+QPainterPath const &ConnectionGraphicsObject::cubicPath() const
+{
+    if (_cubicPath.isEmpty()) {
+        const auto c1c2 = pointsC1C2();
+        _cubicPath = QPainterPath(_out);
+        _cubicPath.cubicTo(c1c2.first, c1c2.second, _in);
+    }
+    return _cubicPath;
+}
+
+QPainterPath const &ConnectionGraphicsObject::cubicOutline(double width) const
+{
+    if (_cubicOutline.isEmpty() || _cubicOutlineWidth != width) {
+        QPainterPathStroker stroker;
+        stroker.setWidth(width);
+        _cubicOutline = stroker.createStroke(cubicPath());
+        _cubicOutlineWidth = width;
+    }
+    return _cubicOutline;
+}
+
+void ConnectionGraphicsObject::invalidatePath()
+{
+    _boundingRect = QRectF();
+    _cubicPath = QPainterPath();
+    _shape = QPainterPath();
+    _cubicOutline = QPainterPath();
+}
+
 QPointF const &ConnectionGraphicsObject::endPoint(PortType portType) const
 {
     Q_ASSERT(portType != PortType::None);
@@ -135,6 +179,8 @@ void ConnectionGraphicsObject::setEndPoint(PortType portType, QPointF const &poi
     } else {
         _out = point;
     }
+
+    invalidatePath();
 }
 
 void ConnectionGraphicsObject::move()
@@ -146,23 +192,24 @@ void ConnectionGraphicsObject::move()
             return;
         }
 
-        const NodeGraphicsObject *ngo = nodeScene()->nodeGraphicsObject(nodeId);
-
-        if (ngo) {
-            const AbstractNodeGeometry &geometry = nodeScene()->nodeGeometry();
-            const QPointF scenePos = geometry.portScenePosition(nodeId,
-                                                                portType,
-                                                                getPortIndex(portType, cId),
-                                                                ngo->sceneTransform());
-            const QPointF connectionPos = sceneTransform().inverted().map(scenePos);
-            setEndPoint(portType, connectionPos);
-        }
+        // Released nodes of a virtualized scene are placed from the model.
+        const AbstractNodeGeometry &geometry = nodeScene()->nodeGeometry();
+        const QTransform nodeSceneTransform = nodeScene()->nodeSceneTransform(nodeId);
+        const QPointF scenePos = geometry.portScenePosition(nodeId,
+                                                            portType,
+                                                            getPortIndex(portType, cId),
+                                                            nodeSceneTransform);
+        const QPointF connectionPos = sceneTransform().inverted().map(scenePos);
+        setEndPoint(portType, connectionPos);
     };
 
+    // Announced with the old bounds, the ends then drop the cached path.
+    prepareGeometryChange();
+
     moveEnd(_connectionId, PortType::Out);
     moveEnd(_connectionId, PortType::In);
 
-    prepareGeometryChange();
+    nodeScene()->updateSpatialIndex(*this);
 
     update();
 }
@@ -177,10 +224,27 @@ ConnectionState &ConnectionGraphicsObject::connectionState()
     return _connectionState;
 }
 
+void ConnectionGraphicsObject::reset(ConnectionId const connectionId)
+{
+    _connectionId = connectionId;
+    _connectionState.setHovered(false);
+    _connectionState.resetLastHoveredNode();
+    _out = QPointF(0, 0);
+    _in = QPointF(0, 0);
+    invalidatePath();
+
+    setSelected(false);
+    setPos(0, 0);
+
+    initializePosition();
+}
+
 void ConnectionGraphicsObject::paint(QPainter *painter,
                                      QStyleOptionGraphicsItem const *option,
                                      QWidget *)
 {
+    NODE_EDITOR_TRACE_SCOPE("ConnectionGraphicsObject::paint");
+
     if (!scene()) {
         return;
     }
@@ -270,13 +334,20 @@ void ConnectionGraphicsObject::hoverLeaveEvent(QGraphicsSceneHoverEvent *event)
 
 std::pair<QPointF, QPointF> ConnectionGraphicsObject::pointsC1C2() const
 {
-    switch (nodeScene()->orientation()) {
+    return pointsC1C2(_out, _in, nodeScene()->orientation());
+}
+
+std::pair<QPointF, QPointF> ConnectionGraphicsObject::pointsC1C2(QPointF const &out,
+                                                                 QPointF const &in,
+                                                                 Qt::Orientation orientation)
+{
+    switch (orientation) {
     case Qt::Horizontal:
-        return pointsC1C2Horizontal();
+        return pointsC1C2Horizontal(out, in);
         break;
 
     case Qt::Vertical:
-        return pointsC1C2Vertical();
+        return pointsC1C2Vertical(out, in);
         break;
     }
 
@@ -296,16 +367,17 @@ void ConnectionGraphicsObject::addGraphicsEffect()
     //effect->setColor(QColor(Qt::gray).darker(800));
 }
 
-std::pair<QPointF, QPointF> ConnectionGraphicsObject::pointsC1C2Horizontal() const
+std::pair<QPointF, QPointF> ConnectionGraphicsObject::pointsC1C2Horizontal(QPointF const &out,
+                                                                           QPointF const &in)
 {
     constexpr double defaultOffset = 200;
-    const double xDistance = _in.x() - _out.x();
+    const double xDistance = in.x() - out.x();
     double horizontalOffset = qMin(defaultOffset, std::abs(xDistance));
     double verticalOffset = 0;
     double ratioX = 0.5;
 
     if (xDistance <= 0) {
-        const double yDistance = _in.y() - _out.y() + 20;
+        const double yDistance = in.y() - out.y() + 20;
         const double vector = yDistance < 0 ? -1.0 : 1.0;
         verticalOffset = qMin(defaultOffset, std::abs(yDistance)) * vector;
         ratioX = 1.0;
@@ -313,21 +385,22 @@ std::pair<QPointF, QPointF> ConnectionGraphicsObject::pointsC1C2Horizontal() con
 
     horizontalOffset *= ratioX;
 
-    const QPointF c1(_out.x() + horizontalOffset, _out.y() + verticalOffset);
-    const QPointF c2(_in.x() - horizontalOffset, _in.y() - verticalOffset);
+    const QPointF c1(out.x() + horizontalOffset, out.y() + verticalOffset);
+    const QPointF c2(in.x() - horizontalOffset, in.y() - verticalOffset);
     return std::make_pair(c1, c2);
 }
 
-std::pair<QPointF, QPointF> ConnectionGraphicsObject::pointsC1C2Vertical() const
+std::pair<QPointF, QPointF> ConnectionGraphicsObject::pointsC1C2Vertical(QPointF const &out,
+                                                                         QPointF const &in)
 {
     constexpr double defaultOffset = 200;
-    const double yDistance = _in.y() - _out.y();
+    const double yDistance = in.y() - out.y();
     double verticalOffset = qMin(defaultOffset, std::abs(yDistance));
     double horizontalOffset = 0;
     double ratioY = 0.5;
 
     if (yDistance <= 0) {
-        const double xDistance = _in.x() - _out.x() + 20;
+        const double xDistance = in.x() - out.x() + 20;
         const double vector = xDistance < 0 ? -1.0 : 1.0;
         horizontalOffset = qMin(defaultOffset, std::abs(xDistance)) * vector;
         ratioY = 1.0;
@@ -335,8 +408,8 @@ std::pair<QPointF, QPointF> ConnectionGraphicsObject::pointsC1C2Vertical() const
 
     verticalOffset *= ratioY;
 
-    const QPointF c1(_out.x() + horizontalOffset, _out.y() + verticalOffset);
-    const QPointF c2(_in.x() - horizontalOffset, _in.y() - verticalOffset);
+    const QPointF c1(out.x() + horizontalOffset, out.y() + verticalOffset);
+    const QPointF c2(in.x() - horizontalOffset, in.y() - verticalOffset);
     return std::make_pair(c1, c2);
 }
 
@@ -0,0 +1,266 @@
+#include "ConnectionLayer.hpp"
+
+#include "AbstractNodeGeometry.hpp"
+#include "BasicGraphicsScene.hpp"
+#include "ConnectionGraphicsObject.hpp"
+#include "ConnectionIdUtils.hpp"
+#include "ConnectionPainter.hpp"
+#include "ConnectionStyle.hpp"
+#include "StyleCollection.hpp"
+#include "TraceScope.hpp"
+
+#include <QtGui/QLinearGradient>
+#include <QtGui/QPainter>
+#include <QtGui/QPainterPath>
+#include <QtGui/QPainterPathStroker>
+#include <QtWidgets/QGraphicsSceneHoverEvent>
+#include <QtWidgets/QStyleOptionGraphicsItem>
+
+#include <map>
+
+namespace QtNodes {
+
+ConnectionLayer::ConnectionLayer(BasicGraphicsScene &scene)
+    : _scene(scene)
+{
+    scene.addItem(this);
+
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+
+    setAcceptHoverEvents(true);
+    setAcceptedMouseButtons(Qt::NoButton);
+
+    // Below the connection graphics objects.
+    setZValue(-2.0);
+}
+
+void ConnectionLayer::insert(ConnectionId const connectionId)
+{
+    AbstractNodeGeometry &geometry = _scene.nodeGeometry();
+
+    auto endPoint = [&](PortType portType) {
+        const NodeId nodeId = getNodeId(portType, connectionId);
+        return geometry.portScenePosition(nodeId,
+                                          portType,
+                                          getPortIndex(portType, connectionId),
+                                          _scene.nodeSceneTransform(nodeId));
+    };
+
+    Record record;
+    record.out = endPoint(PortType::Out);
+    record.in = endPoint(PortType::In);
+    record.rect = ConnectionGraphicsObject::pathBoundingRect(record.out,
+                                                             record.in,
+                                                             _scene.orientation());
+
+    const auto colors = ConnectionPainter::normalColors(_scene.graphModel(), connectionId);
+    record.outColor = colors.first;
+    record.inColor = colors.second;
+
+    const auto it = _records.find(connectionId);
+    if (it != _records.end()) {
+        update(it->second.rect);
+        it->second = record;
+    } else {
+        _records.emplace(connectionId, record);
+    }
+
+    _grid.insert(connectionId, record.rect);
+
+    if (!_bounds.contains(record.rect)) {
+        prepareGeometryChange();
+        _bounds |= record.rect;
+    }
+
+    update(record.rect);
+}
+
+void ConnectionLayer::remove(ConnectionId const connectionId)
+{
+    const auto it = _records.find(connectionId);
+    if (it == _records.end()) {
+        return;
+    }
+
+    // The bounds are not shrunk, they only limit the repainted area.
+    update(it->second.rect);
+
+    _grid.remove(connectionId);
+    _records.erase(it);
+}
+
+void ConnectionLayer::clear()
+{
+    prepareGeometryChange();
+
+    _records.clear();
+    _grid.clear();
+    _bounds = QRectF();
+}
+
+bool ConnectionLayer::hasConnection(ConnectionId const &connectionId) const
+{
+    return _records.find(connectionId) != _records.end();
+}
+
+std::vector<ConnectionId> ConnectionLayer::connectionIds() const
+{
+    std::vector<ConnectionId> result;
+    result.reserve(_records.size());
+
+    for (auto const &record : _records) {
+        result.push_back(record.first);
+    }
+
+    return result;
+}
+
+std::vector<ConnectionId> ConnectionLayer::connectionsInRect(QRectF const &sceneRect) const
+{
+    return _grid.query(sceneRect);
+}
+
+ConnectionId const *ConnectionLayer::connectionAt(QPointF const &scenePoint) const
+{
+    const bool lowDetail = _scene.lowDetailMode();
+    const Qt::Orientation orientation = _scene.orientation();
+
+    for (ConnectionId const &connectionId : _grid.query(scenePoint)) {
+        const auto it = _records.find(connectionId);
+        Record const &record = it->second;
+
+        if (ConnectionPainter::hitTest(record.out, record.in, orientation, lowDetail, scenePoint)) {
+            return &it->first;
+        }
+    }
+
+    return nullptr;
+}
+
+QRectF ConnectionLayer::boundingRect() const
+{
+    return _bounds;
+}
+
+bool ConnectionLayer::contains(QPointF const &point) const
+{
+    // The layer stays at the scene origin, item and scene coordinates are the same.
+    return connectionAt(point) != nullptr;
+}
+
+void ConnectionLayer::paint(QPainter *painter, QStyleOptionGraphicsItem const *option, QWidget *)
+{
+    NODE_EDITOR_TRACE_SCOPE("ConnectionLayer::paint");
+
+    const std::vector<ConnectionId> visible = _grid.query(option->exposedRect);
+    if (visible.empty()) {
+        return;
+    }
+
+    if (_scene.lowDetailMode()) {
+        paintLowDetail(painter, visible);
+        return;
+    }
+
+    auto const &connectionStyle = StyleCollection::connectionStyle();
+
+    const Qt::Orientation orientation = _scene.orientation();
+    const double pointRadius = connectionStyle.pointDiameter() / 2.0;
+
+    QPen pen;
+    pen.setWidth(connectionStyle.lineWidth());
+
+    // One path per color, stroked with a single call each.
+    std::map<QRgb, QPainterPath> paths;
+
+    QPainterPath endPoints;
+    // Ports with several connections repeat the same circle.
+    endPoints.setFillRule(Qt::WindingFill);
+
+    for (ConnectionId const &connectionId : visible) {
+        Record const &record = _records.at(connectionId);
+        const auto c1c2 = ConnectionGraphicsObject::pointsC1C2(record.out, record.in, orientation);
+
+        if (record.outColor == record.inColor) {
+            QPainterPath &path = paths[record.outColor.rgba()];
+            path.moveTo(record.out);
+            path.cubicTo(c1c2.first, c1c2.second, record.in);
+        } else {
+            // The gradient follows the geometry, these are drawn one by one.
+            QPainterPath cubic(record.out);
+            cubic.cubicTo(c1c2.first, c1c2.second, record.in);
+
+            QPainterPathStroker stroker;
+            stroker.setWidth(pen.width());
+            const QPainterPath outline = stroker.createStroke(cubic);
+
+            QLinearGradient gradient(outline.boundingRect().topLeft(),
+                                     outline.boundingRect().bottomRight());
+            gradient.setColorAt(0, record.outColor);
+            gradient.setColorAt(1, record.inColor);
+
+            painter->setPen(Qt::NoPen);
+            painter->setBrush(gradient);
+            painter->drawPath(outline);
+        }
+
+        endPoints.addEllipse(record.out, pointRadius, pointRadius);
+        endPoints.addEllipse(record.in, pointRadius, pointRadius);
+    }
+
+    painter->setBrush(Qt::NoBrush);
+    for (auto const &path : paths) {
+        pen.setColor(QColor::fromRgba(path.first));
+        painter->setPen(pen);
+        painter->drawPath(path.second);
+    }
+
+    painter->setPen(connectionStyle.constructionColor());
+    painter->setBrush(connectionStyle.constructionColor());
+    painter->drawPath(endPoints);
+}
+
+void ConnectionLayer::paintLowDetail(QPainter *painter,
+                                     std::vector<ConnectionId> const &connectionIds) const
+{
+    auto const &connectionStyle = StyleCollection::connectionStyle();
+
+    std::vector<QLineF> lines;
+    lines.reserve(connectionIds.size());
+
+    for (ConnectionId const &connectionId : connectionIds) {
+        Record const &record = _records.at(connectionId);
+        lines.emplace_back(record.out, record.in);
+    }
+
+    QPen pen(connectionStyle.normalColor());
+    pen.setWidthF(connectionStyle.lineWidth());
+
+    painter->setPen(pen);
+    painter->setBrush(Qt::NoBrush);
+    painter->drawLines(lines.data(), static_cast<int>(lines.size()));
+}
+
+void ConnectionLayer::hoverEnterEvent(QGraphicsSceneHoverEvent *event)
+{
+    materializeAt(event->scenePos());
+}
+
+void ConnectionLayer::hoverMoveEvent(QGraphicsSceneHoverEvent *event)
+{
+    materializeAt(event->scenePos());
+}
+
+void ConnectionLayer::materializeAt(QPointF const &scenePoint)
+{
+    ConnectionId const *connectionId = connectionAt(scenePoint);
+    if (!connectionId) {
+        return;
+    }
+
+    // Copied, the record is removed when the object is created.
+    const ConnectionId id = *connectionId;
+    _scene.materializeConnection(id);
+}
+
+} // namespace QtNodes
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "ConnectionIdHash.hpp"
+#include "Definitions.hpp"
+#include "SpatialGridIndex.hpp"
+
+#include <QtCore/QPointF>
+#include <QtCore/QRectF>
+#include <QtGui/QColor>
+#include <QtWidgets/QGraphicsItem>
+
+#include <unordered_map>
+#include <vector>
+
+namespace QtNodes {
+
+class BasicGraphicsScene;
+
+/**
+ * Single scene item drawing the connections which have no
+ * `ConnectionGraphicsObject`.
+ *
+ * Every connection is kept as a record of its ends and colors, registered
+ * in a grid by its bounds. `paint` visits only the records intersecting the
+ * exposed rect and draws all the connections of one color with a single
+ * path. Picking measures the distance to the curves found in the grid cell
+ * under the cursor.
+ *
+ * The layer does not handle clicks. When the mouse hovers a connection the
+ * scene gives it a graphics object, which then handles selection and
+ * dragging as usual.
+ */
+class ConnectionLayer : public QGraphicsItem
+{
+public:
+    explicit ConnectionLayer(BasicGraphicsScene &scene);
+
+    /// Adds `connectionId` or recomputes its geometry and colors from the model.
+    void insert(ConnectionId const connectionId);
+
+    void remove(ConnectionId const connectionId);
+
+    void clear();
+
+    bool hasConnection(ConnectionId const &connectionId) const;
+
+    std::vector<ConnectionId> connectionIds() const;
+
+    /// @returns ids of the batched connections whose bounds intersect `sceneRect`.
+    std::vector<ConnectionId> connectionsInRect(QRectF const &sceneRect) const;
+
+    /// @returns the batched connection under `scenePoint` or nullptr.
+    ConnectionId const *connectionAt(QPointF const &scenePoint) const;
+
+public:
+    QRectF boundingRect() const override;
+
+    bool contains(QPointF const &point) const override;
+
+    void paint(QPainter *painter,
+               QStyleOptionGraphicsItem const *option,
+               QWidget *widget = nullptr) override;
+
+protected:
+    void hoverEnterEvent(QGraphicsSceneHoverEvent *event) override;
+
+    void hoverMoveEvent(QGraphicsSceneHoverEvent *event) override;
+
+private:
+    struct Record
+    {
+        QPointF out;
+        QPointF in;
+        QRectF rect;
+        QColor outColor;
+        QColor inColor;
+    };
+
+    /// Hands the connection under `scenePoint` over to a graphics object.
+    void materializeAt(QPointF const &scenePoint);
+
+    void paintLowDetail(QPainter *painter, std::vector<ConnectionId> const &connectionIds) const;
+
+private:
+    BasicGraphicsScene &_scene;
+
+    std::unordered_map<ConnectionId, Record> _records;
+
+    SpatialGridIndex<ConnectionId> _grid;
+
+    QRectF _bounds;
+};
+
+} // namespace QtNodes
@@ -3,38 +3,77 @@
 #include <QtGui/QIcon>
 
 #include "AbstractGraphModel.hpp"
+#include "BasicGraphicsScene.hpp"
 #include "ConnectionGraphicsObject.hpp"
 #include "ConnectionState.hpp"
+#include "CubicBezier.hpp"
 #include "Definitions.hpp"
 #include "NodeData.hpp"
 #include "StyleCollection.hpp"
 
 namespace QtNodes {
 
-    static QPainterPath cubicPath(ConnectionGraphicsObject const &connection) {
-        const QPointF &in = connection.endPoint(PortType::In);
-        const QPointF &out = connection.endPoint(PortType::Out);
-        const auto c1c2 = connection.pointsC1C2();
-        // cubic spline
-        QPainterPath cubic(out);
-        cubic.cubicTo(c1c2.first, c1c2.second, in);
-        return cubic;
+    /// Width of the area around a connection which reacts to the mouse.
+    constexpr double strokeWidth = 10.0;
+
+    static bool lowDetail(ConnectionGraphicsObject const &cgo) {
+        const BasicGraphicsScene *scene = cgo.nodeScene();
+        return scene && scene->lowDetailMode() && !cgo.connectionState().requiresPort();
     }
 
     QPainterPath ConnectionPainter::getPainterStroke(ConnectionGraphicsObject const &connection) {
-        const auto cubic = cubicPath(connection);
-        const QPointF &out = connection.endPoint(PortType::Out);
-        QPainterPath result(out);
-        constexpr unsigned long segments = 20;
-
-        for (auto i = 0UL; i < segments; ++i) {
-            const double ratio = static_cast<double>(i + 1) / segments;
-            result.lineTo(cubic.pointAtPercent(ratio));
+        QPainterPathStroker stroker;
+        stroker.setWidth(strokeWidth);
+
+        if (lowDetail(connection)) {
+            QPainterPath result(connection.endPoint(PortType::Out));
+            result.lineTo(connection.endPoint(PortType::In));
+            return stroker.createStroke(result);
         }
 
-        QPainterPathStroker stroker;
-        stroker.setWidth(10.0);
-        return stroker.createStroke(result);
+        return stroker.createStroke(connection.cubicPath());
+    }
+
+    bool ConnectionPainter::hitTest(ConnectionGraphicsObject const &connection,
+                                    QPointF const &point) {
+        return hitTest(connection.endPoint(PortType::Out),
+                       connection.endPoint(PortType::In),
+                       connection.nodeScene()->orientation(),
+                       lowDetail(connection),
+                       point);
+    }
+
+    bool ConnectionPainter::hitTest(QPointF const &out,
+                                    QPointF const &in,
+                                    Qt::Orientation orientation,
+                                    bool lowDetail,
+                                    QPointF const &point) {
+        if (lowDetail) {
+            return CubicBezier::distanceToSegment(QLineF(out, in), point) <= 0.5 * strokeWidth;
+        }
+
+        const auto c1c2 = ConnectionGraphicsObject::pointsC1C2(out, in, orientation);
+        const CubicBezier curve{out, c1c2.first, c1c2.second, in};
+        return curve.distanceTo(point) <= 0.5 * strokeWidth;
+    }
+
+    std::pair<QColor, QColor> ConnectionPainter::normalColors(AbstractGraphModel const &graphModel,
+                                                              ConnectionId const &connectionId) {
+        auto const &connectionStyle = QtNodes::StyleCollection::connectionStyle();
+
+        if (!connectionStyle.useDataDefinedColors()) {
+            return std::make_pair(connectionStyle.normalColor(), connectionStyle.normalColor());
+        }
+
+        const DataTypeHandle typeOut = graphModel.portTypeHandle(connectionId.outNodeId,
+                                                                 PortType::Out,
+                                                                 connectionId.outPortIndex);
+        const DataTypeHandle typeIn = graphModel.portTypeHandle(connectionId.inNodeId,
+                                                                PortType::In,
+                                                                connectionId.inPortIndex);
+
+        return std::make_pair(connectionStyle.normalColor(typeOut),
+                              connectionStyle.normalColor(typeIn));
     }
 
 #ifdef NODE_DEBUG_DRAWING
@@ -58,7 +97,7 @@ namespace QtNodes {
             painter->drawEllipse(points.second, 3, 3);
 
             painter->setBrush(Qt::NoBrush);
-            painter->drawPath(cubicPath(cgo));
+            painter->drawPath(cgo.cubicPath());
         }
 
         {
@@ -80,9 +119,8 @@ namespace QtNodes {
             pen.setStyle(Qt::DashLine);
             painter->setPen(pen);
             painter->setBrush(Qt::NoBrush);
-            const auto cubic = cubicPath(cgo);
             // cubic spline
-            painter->drawPath(cubic);
+            painter->drawPath(cgo.cubicPath());
         }
     }
 
@@ -104,8 +142,7 @@ namespace QtNodes {
             painter->setBrush(Qt::NoBrush);
 
             // cubic spline
-            const auto cubic = cubicPath(cgo);
-            painter->drawPath(cubic);
+            painter->drawPath(cgo.cubicPath());
         }
     }
 
@@ -119,32 +156,14 @@ namespace QtNodes {
 
         auto const &connectionStyle = QtNodes::StyleCollection::connectionStyle();
 
-        QColor normalColorOut = connectionStyle.normalColor();
-        QColor normalColorIn = connectionStyle.normalColor();
-        QColor selectedColor = connectionStyle.selectedColor();
+        const auto colors = ConnectionPainter::normalColors(cgo.graphModel(), cgo.connectionId());
+        const QColor normalColorOut = colors.first;
+        const QColor normalColorIn = colors.second;
 
+        QColor selectedColor = connectionStyle.selectedColor();
         bool useGradientColor = true;
 
-        AbstractGraphModel const &graphModel = cgo.graphModel();
-
         if (connectionStyle.useDataDefinedColors()) {
-            using QtNodes::PortType;
-            const auto cId = cgo.connectionId();
-            const auto dataTypeOut = graphModel
-                                         .portData(cId.outNodeId,
-                                                   PortType::Out,
-                                                   cId.outPortIndex,
-                                                   PortRole::DataType)
-                                         .value<NodeDataType>();
-            const auto dataTypeIn = graphModel
-                                        .portData(cId.inNodeId,
-                                                  PortType::In,
-                                                  cId.inPortIndex,
-                                                  PortRole::DataType)
-                                        .value<NodeDataType>();
-
-            normalColorOut = dataTypeOut.color;
-            normalColorIn = dataTypeIn.color;
             useGradientColor = (normalColorOut != normalColorIn);
             selectedColor = normalColorOut.darker(200);
         }
@@ -159,15 +178,13 @@ namespace QtNodes {
 
         const bool selected = cgo.isSelected();
 
-        const auto cubic = cubicPath(cgo);
+        QPainterPath const &cubic = cgo.cubicPath();
         if (useGradientColor) {
             p.setColor(normalColorOut);
             if (selected) {
                 p.setColor(selectedColor);
             }
-            QPainterPathStroker stroker;
-            stroker.setWidth(p.width());
-            const QPainterPath outline = stroker.createStroke(cubic);
+            QPainterPath const &outline = cgo.cubicOutline(p.width());
             QLinearGradient gradient(outline.boundingRect().topLeft(), outline.boundingRect().bottomRight());
             gradient.setColorAt(0, normalColorOut);
             gradient.setColorAt(1, normalColorIn);
@@ -186,7 +203,22 @@ namespace QtNodes {
         }
     }
 
+    static void drawLowDetailLine(QPainter *painter, ConnectionGraphicsObject const &cgo) {
+        auto const &connectionStyle = QtNodes::StyleCollection::connectionStyle();
+
+        QPen p(cgo.isSelected() ? connectionStyle.selectedColor() : connectionStyle.normalColor());
+        p.setWidthF(connectionStyle.lineWidth());
+        painter->setPen(p);
+        painter->setBrush(Qt::NoBrush);
+        painter->drawLine(cgo.out(), cgo.in());
+    }
+
     void ConnectionPainter::paint(QPainter *painter, ConnectionGraphicsObject const &cgo) {
+        if (lowDetail(cgo)) {
+            drawLowDetailLine(painter, cgo);
+            return;
+        }
+
         drawHoveredOrSelected(painter, cgo);
 
         drawSketchLine(painter, cgo);
@@ -5,8 +5,11 @@
 
 #include "Definitions.hpp"
 
+#include <utility>
+
 namespace QtNodes {
 
+class AbstractGraphModel;
 class ConnectionGeometry;
 class ConnectionGraphicsObject;
 
@@ -16,6 +19,28 @@ public:
     static void paint(QPainter *painter, ConnectionGraphicsObject const &cgo);
 
     static QPainterPath getPainterStroke(ConnectionGraphicsObject const &cgo);
+
+    /// Whether `point`, in item coordinates, lies within the stroke of the connection.
+    /**
+   * Measures the distance to the Bézier curve directly, without building
+   * the stroke.
+   */
+    static bool hitTest(ConnectionGraphicsObject const &cgo, QPointF const &point);
+
+    /// Same test for a connection given by its ends, e.g. one drawn by a batched layer.
+    static bool hitTest(QPointF const &out,
+                        QPointF const &in,
+                        Qt::Orientation orientation,
+                        bool lowDetail,
+                        QPointF const &point);
+
+    /// Colors of the out and in ends of an unselected connection.
+    /**
+   * Both are `ConnectionStyle::normalColor()` unless the style uses data
+   * defined colors.
+   */
+    static std::pair<QColor, QColor> normalColors(AbstractGraphModel const &graphModel,
+                                                  ConnectionId const &connectionId);
 };
 
 } // namespace QtNodes
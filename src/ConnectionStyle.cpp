@@ -1,5 +1,6 @@
 #include "ConnectionStyle.hpp"
 
+#include "DataTypeRegistry.hpp"
 #include "StyleCollection.hpp"
 
 #include <QtCore/QJsonArray>
@@ -8,9 +9,9 @@
 
 #include <QDebug>
 
-#include <random>
-
 using QtNodes::ConnectionStyle;
+using QtNodes::DataTypeHandle;
+using QtNodes::DataTypeRegistry;
 
 inline void initResources()
 {
@@ -156,17 +157,12 @@ QColor ConnectionStyle::normalColor() const
 
 QColor ConnectionStyle::normalColor(QString typeId) const
 {
-    std::size_t hash = qHash(typeId);
-
-    std::size_t const hue_range = 0xFF;
-
-    std::mt19937 gen(static_cast<unsigned int>(hash));
-    std::uniform_int_distribution<int> distrib(0, hue_range);
-
-    int hue = distrib(gen);
-    int sat = 120 + hash % 129;
+    return DataTypeRegistry::color(typeId);
+}
 
-    return QColor::fromHsl(hue, sat, 160);
+QColor ConnectionStyle::normalColor(DataTypeHandle typeHandle) const
+{
+    return DataTypeRegistry::color(typeHandle);
 }
 
 QColor ConnectionStyle::selectedColor() const
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <QtCore/QLineF>
+#include <QtCore/QPointF>
+
+#include <algorithm>
+#include <cmath>
+
+namespace QtNodes {
+
+/**
+ * Cubic Bézier segment with a point-to-curve distance query.
+ *
+ * The closest parameter is bracketed by sampling the curve and then refined
+ * with Newton steps on `(B(t) - p) . B'(t) = 0`, which converges in a few
+ * iterations for the smooth connection curves drawn by the scene.
+ */
+struct CubicBezier
+{
+    QPointF p0;
+    QPointF p1;
+    QPointF p2;
+    QPointF p3;
+
+    QPointF pointAt(double t) const
+    {
+        const double u = 1.0 - t;
+        return u * u * u * p0 + 3.0 * u * u * t * p1 + 3.0 * u * t * t * p2 + t * t * t * p3;
+    }
+
+    QPointF derivativeAt(double t) const
+    {
+        const double u = 1.0 - t;
+        return 3.0 * u * u * (p1 - p0) + 6.0 * u * t * (p2 - p1) + 3.0 * t * t * (p3 - p2);
+    }
+
+    QPointF secondDerivativeAt(double t) const
+    {
+        return 6.0 * (1.0 - t) * (p2 - 2.0 * p1 + p0) + 6.0 * t * (p3 - 2.0 * p2 + p1);
+    }
+
+    /// @returns the parameter in [0, 1] of the curve point closest to `point`.
+    double closestParameter(QPointF const &point) const
+    {
+        constexpr int samples = 16;
+        constexpr int newtonSteps = 4;
+
+        double bestT = 0.0;
+        double bestDistance = squaredDistance(pointAt(0.0), point);
+
+        for (int i = 1; i <= samples; ++i) {
+            const double t = static_cast<double>(i) / samples;
+            const double distance = squaredDistance(pointAt(t), point);
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                bestT = t;
+            }
+        }
+
+        double t = bestT;
+        for (int i = 0; i < newtonSteps; ++i) {
+            const QPointF diff = pointAt(t) - point;
+            const QPointF d1 = derivativeAt(t);
+            const QPointF d2 = secondDerivativeAt(t);
+
+            const double denominator = QPointF::dotProduct(d1, d1) + QPointF::dotProduct(diff, d2);
+            if (std::abs(denominator) < 1e-9) {
+                break;
+            }
+
+            t = clampParameter(t - QPointF::dotProduct(diff, d1) / denominator);
+        }
+
+        // Newton may wander off on nearly straight curves, keep the better one.
+        return squaredDistance(pointAt(t), point) < bestDistance ? t : bestT;
+    }
+
+    double distanceTo(QPointF const &point) const
+    {
+        return std::sqrt(squaredDistance(pointAt(closestParameter(point)), point));
+    }
+
+    static double clampParameter(double t) { return std::min(1.0, std::max(0.0, t)); }
+
+    static double squaredDistance(QPointF const &a, QPointF const &b)
+    {
+        const QPointF d = a - b;
+        return QPointF::dotProduct(d, d);
+    }
+
+    /// Distance from `point` to the segment `line`.
+    static double distanceToSegment(QLineF const &line, QPointF const &point)
+    {
+        const QPointF direction = line.p2() - line.p1();
+        const double length = QPointF::dotProduct(direction, direction);
+
+        double t = 0.0;
+        if (length > 0.0) {
+            t = clampParameter(QPointF::dotProduct(point - line.p1(), direction) / length);
+        }
+
+        return std::sqrt(squaredDistance(line.p1() + t * direction, point));
+    }
+};
+
+} // namespace QtNodes
@@ -0,0 +1,254 @@
+#include "DataFlowEvaluationEngine.hpp"
+
+#include "DataFlowGraphModel.hpp"
+#include "NodeDelegateModel.hpp"
+#include "TraceScope.hpp"
+
+#include <QtCore/QMetaObject>
+#include <QtCore/QRunnable>
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+namespace QtNodes {
+
+namespace {
+
+class ComputeTask : public QRunnable
+{
+public:
+    explicit ComputeTask(std::function<void()> job)
+        : _job(std::move(job))
+    {}
+
+    void run() override { _job(); }
+
+private:
+    std::function<void()> _job;
+};
+
+} // namespace
+
+DataFlowEvaluationEngine::DataFlowEvaluationEngine(DataFlowGraphModel &graphModel)
+    : _graphModel(graphModel)
+{}
+
+DataFlowEvaluationEngine::~DataFlowEvaluationEngine()
+{
+    _threadPool.waitForDone();
+}
+
+void DataFlowEvaluationEngine::schedule(NodeId const nodeId)
+{
+    const auto it = _tasks.find(nodeId);
+    if (it != _tasks.end()) {
+        it->second.rerun = true;
+        it->second.token.cancel();
+        return;
+    }
+
+    if (auto model = _graphModel.delegateModel<NodeDelegateModel>(nodeId)) {
+        start(nodeId, model);
+    }
+}
+
+bool DataFlowEvaluationEngine::isComputing(NodeId const nodeId) const
+{
+    return _tasks.find(nodeId) != _tasks.end();
+}
+
+void DataFlowEvaluationEngine::deferInput(NodeId const nodeId,
+                                          PortIndex const portIndex,
+                                          std::shared_ptr<NodeData> nodeData)
+{
+    const auto it = _tasks.find(nodeId);
+    if (it != _tasks.end()) {
+        it->second.deferredInputs[portIndex] = std::move(nodeData);
+        it->second.token.cancel();
+    }
+}
+
+void DataFlowEvaluationEngine::deferConnection(NodeId const nodeId, ConnectionId const connectionId)
+{
+    const auto it = _tasks.find(nodeId);
+    if (it == _tasks.end()) {
+        return;
+    }
+
+    auto &connections = it->second.deferredConnections;
+    if (std::find(connections.begin(), connections.end(), connectionId) == connections.end()) {
+        connections.push_back(connectionId);
+    }
+}
+
+void DataFlowEvaluationEngine::recordUpdatedPort(NodeId const nodeId, PortIndex const portIndex)
+{
+    std::lock_guard<std::mutex> lock(_updatedPortsMutex);
+
+    auto &ports = _updatedPorts[nodeId];
+    if (std::find(ports.begin(), ports.end(), portIndex) == ports.end()) {
+        ports.push_back(portIndex);
+    }
+}
+
+void DataFlowEvaluationEngine::retire(NodeId const nodeId, std::unique_ptr<NodeDelegateModel> model)
+{
+    const auto it = _tasks.find(nodeId);
+    if (it == _tasks.end()) {
+        return;
+    }
+
+    // Requests made for the deleted node die with it.
+    it->second.token.cancel();
+    it->second.rerun = false;
+    it->second.deferredInputs.clear();
+    it->second.deferredConnections.clear();
+    it->second.retired = std::move(model);
+}
+
+void DataFlowEvaluationEngine::start(NodeId const nodeId, NodeDelegateModel *model)
+{
+    NodeTask &task = _tasks.emplace(nodeId, NodeTask()).first->second;
+
+    const auto outPorts = model->nPorts(PortType::Out);
+    task.previousOutputs.reserve(outPorts);
+    for (PortIndex portIndex = 0; portIndex < outPorts; ++portIndex) {
+        task.previousOutputs.push_back(model->outData(portIndex));
+    }
+
+    // Assigned before the worker starts and replaced after it has finished,
+    // the model's token is never written while the compute reads it.
+    model->_cancellationToken = task.token;
+
+    Q_EMIT model->computingStarted();
+
+    DataFlowGraphModel *graphModel = &_graphModel;
+
+    // The profiler is not thread-safe, the duration is recorded in `finish`.
+    const bool profiling = _graphModel.profilingEnabled();
+
+    _threadPool.start(new ComputeTask([this, graphModel, nodeId, model, profiling]() {
+        NODE_EDITOR_TRACE_NODE_SCOPE("compute", nodeId);
+
+        NodeProfiler::Duration duration{};
+
+        if (profiling) {
+            const auto start = NodeProfiler::Clock::now();
+            model->compute();
+            duration = NodeProfiler::Clock::now() - start;
+        } else {
+            model->compute();
+        }
+
+        QMetaObject::invokeMethod(
+            graphModel,
+            [this, nodeId, duration, profiling]() {
+                if (profiling && _graphModel.profiler() && _graphModel.nodeExists(nodeId)) {
+                    _graphModel.profiler()->recordCompute(nodeId, duration);
+                }
+                finish(nodeId);
+            },
+            Qt::QueuedConnection);
+    }));
+}
+
+void DataFlowEvaluationEngine::finish(NodeId const nodeId)
+{
+    const auto it = _tasks.find(nodeId);
+    if (it == _tasks.end()) {
+        return;
+    }
+
+    NodeTask task = std::move(it->second);
+    _tasks.erase(it);
+
+    const std::vector<PortIndex> updatedPorts = takeUpdatedPorts(nodeId);
+
+    // Newer inputs arrived during the compute, its results are stale.
+    const bool superseded = task.token.isCancelled();
+
+    // Results of a node deleted in the meantime are dropped with its model.
+    if (task.retired) {
+        task.retired.reset();
+    } else if (auto model = _graphModel.delegateModel<NodeDelegateModel>(nodeId)) {
+        model->_cancellationToken = CancellationToken();
+
+        if (superseded) {
+            // The compute wrote its outputs into the model already.
+            for (std::size_t i = 0; i < task.previousOutputs.size(); ++i) {
+                model->restoreOutData(task.previousOutputs[i], static_cast<PortIndex>(i));
+            }
+            _graphModel.forgetComputedOutputs(nodeId);
+        } else {
+            _graphModel.memoizeOutputs(nodeId, *model);
+        }
+
+        Q_EMIT model->computingFinished();
+
+        // All the updated ports form a single change wave, together with the
+        // connections made during the compute.
+        if (!superseded) {
+            const DataFlowGraphModel::BatchUpdate batch(_graphModel);
+            for (PortIndex const portIndex : updatedPorts) {
+                _graphModel.onOutPortDataUpdated(nodeId, portIndex);
+            }
+            for (ConnectionId const &connectionId : task.deferredConnections) {
+                _graphModel.schedulePropagation(connectionId);
+            }
+            task.deferredConnections.clear();
+        }
+    }
+
+    auto model = _graphModel.delegateModel<NodeDelegateModel>(nodeId);
+    if (!model) {
+        return;
+    }
+
+    for (auto const &input : task.deferredInputs) {
+        _graphModel.setModelInData(nodeId, *model, input.second, input.first);
+
+        Q_EMIT _graphModel.inPortDataWasSet(nodeId, PortType::In, input.first);
+    }
+
+    // Goes through the graph model, the latest inputs may be memoized.
+    if (task.rerun || !task.deferredInputs.empty()) {
+        _graphModel.requestCompute(nodeId);
+    }
+
+    if (task.deferredConnections.empty()) {
+        return;
+    }
+
+    // Superseded, the connections wait for the outputs of the next compute.
+    const auto rerunIt = _tasks.find(nodeId);
+    if (rerunIt != _tasks.end()) {
+        auto &connections = rerunIt->second.deferredConnections;
+        connections.insert(connections.end(),
+                           task.deferredConnections.begin(),
+                           task.deferredConnections.end());
+        return;
+    }
+
+    const DataFlowGraphModel::BatchUpdate batch(_graphModel);
+    for (ConnectionId const &connectionId : task.deferredConnections) {
+        _graphModel.schedulePropagation(connectionId);
+    }
+}
+
+std::vector<PortIndex> DataFlowEvaluationEngine::takeUpdatedPorts(NodeId const nodeId)
+{
+    std::lock_guard<std::mutex> lock(_updatedPortsMutex);
+
+    std::vector<PortIndex> result;
+
+    const auto it = _updatedPorts.find(nodeId);
+    if (it != _updatedPorts.end()) {
+        result = std::move(it->second);
+        _updatedPorts.erase(it);
+    }
+
+    return result;
+}
+
+} // namespace QtNodes
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "CancellationToken.hpp"
+#include "Definitions.hpp"
+
+#include <QtCore/QThreadPool>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace QtNodes {
+
+class DataFlowGraphModel;
+class NodeData;
+class NodeDelegateModel;
+
+/**
+ * Runs `NodeDelegateModel::compute()` of thread-safe models on a thread pool.
+ *
+ * A node never computes concurrently with itself. Inputs arriving while the
+ * node computes are held back and delivered, followed by a new compute, once
+ * the running one has returned. Ports announced with `dataUpdated` during the
+ * compute are propagated on the graph model's thread afterwards, so downstream
+ * nodes only see complete results and always compute after their inputs.
+ *
+ * The latest inputs win: newer inputs or compute requests cancel the running
+ * compute's token, and the results of a cancelled compute are dropped instead
+ * of propagated, even if it ran to completion. The outputs the model had
+ * before are handed back with `NodeDelegateModel::restoreOutData`.
+ */
+class DataFlowEvaluationEngine
+{
+public:
+    explicit DataFlowEvaluationEngine(DataFlowGraphModel &graphModel);
+
+    /// Waits for the running computations.
+    ~DataFlowEvaluationEngine();
+
+    QThreadPool &threadPool() { return _threadPool; }
+
+    /**
+   * Starts a compute of the node or queues one after the running compute,
+   * superseding the latter.
+   */
+    void schedule(NodeId const nodeId);
+
+    bool isComputing(NodeId const nodeId) const;
+
+    bool isBusy() const { return !_tasks.empty(); }
+
+    /**
+   * Stores the input until the running compute of the node has returned,
+   * the running compute is superseded.
+   */
+    void deferInput(NodeId const nodeId,
+                    PortIndex const portIndex,
+                    std::shared_ptr<NodeData> nodeData);
+
+    /**
+   * Delays the propagation of the node's output through the connection,
+   * e.g. one made during the compute, until the running compute and the
+   * computes it was superseded by have returned.
+   */
+    void deferConnection(NodeId const nodeId, ConnectionId const connectionId);
+
+    /// Thread-safe, called for `dataUpdated` emitted while the node computes.
+    void recordUpdatedPort(NodeId const nodeId, PortIndex const portIndex);
+
+    /// Keeps the model of a deleted node alive until its compute returns.
+    void retire(NodeId const nodeId, std::unique_ptr<NodeDelegateModel> model);
+
+private:
+    void start(NodeId const nodeId, NodeDelegateModel *model);
+
+    /// Called on the graph model's thread after `compute()` returned.
+    void finish(NodeId const nodeId);
+
+    std::vector<PortIndex> takeUpdatedPorts(NodeId const nodeId);
+
+private:
+    /// Exists for every node with a compute in flight.
+    struct NodeTask
+    {
+        /// Shared with the model while it computes.
+        CancellationToken token;
+
+        bool rerun = false;
+
+        std::map<PortIndex, std::shared_ptr<NodeData>> deferredInputs;
+
+        /// Outgoing connections waiting for the outputs of the compute.
+        std::vector<ConnectionId> deferredConnections;
+
+        std::unique_ptr<NodeDelegateModel> retired;
+
+        /// Outputs of the model before the compute, restored if it is superseded.
+        std::vector<std::shared_ptr<NodeData>> previousOutputs;
+    };
+
+    DataFlowGraphModel &_graphModel;
+
+    QThreadPool _threadPool;
+
+    std::unordered_map<NodeId, NodeTask> _tasks;
+
+    std::mutex _updatedPortsMutex;
+
+    std::unordered_map<NodeId, std::vector<PortIndex>> _updatedPorts;
+};
+
+} // namespace QtNodes
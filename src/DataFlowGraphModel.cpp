@@ -1,8 +1,19 @@
 #include "DataFlowGraphModel.hpp"
+#include "BinaryGraphFormat.hpp"
 #include "ConvertersRegister.hpp"
+#include "DataFlowEvaluationEngine.hpp"
+#include "DataTypeRegistry.hpp"
+#include "TraceScope.hpp"
 
 #include <QJsonArray>
-
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QScopedValueRollback>
+#include <QtCore/QThread>
+
+#include <algorithm>
+#include <exception>
 #include <stdexcept>
 
 namespace QtNodes {
@@ -11,6 +22,8 @@ DataFlowGraphModel::DataFlowGraphModel(std::shared_ptr<NodeDelegateModelRegistry
     : _registry(std::move(registry))
 {}
 
+DataFlowGraphModel::~DataFlowGraphModel() = default;
+
 std::unordered_set<NodeId> DataFlowGraphModel::allNodeIds() const
 {
     std::unordered_set<NodeId> nodeIds;
@@ -22,12 +35,14 @@ std::unordered_set<ConnectionId> DataFlowGraphModel::allConnectionIds(NodeId con
 {
     std::unordered_set<ConnectionId> result;
 
-    std::copy_if(_connectivity.begin(),
-                 _connectivity.end(),
-                 std::inserter(result, std::end(result)),
-                 [&nodeId](ConnectionId const &cid) {
-                     return cid.inNodeId == nodeId || cid.outNodeId == nodeId;
-                 });
+    const auto it = _nodeConnections.find(nodeId);
+    if (it == _nodeConnections.end()) {
+        return result;
+    }
+
+    result.reserve(it->second.in.size() + it->second.out.size());
+    result.insert(it->second.in.begin(), it->second.in.end());
+    result.insert(it->second.out.begin(), it->second.out.end());
 
     return result;
 }
@@ -36,17 +51,12 @@ std::unordered_set<ConnectionId> DataFlowGraphModel::connections(NodeId nodeId,
                                                                  PortType portType,
                                                                  PortIndex portIndex) const
 {
-    std::unordered_set<ConnectionId> result;
-
-    std::copy_if(_connectivity.begin(),
-                 _connectivity.end(),
-                 std::inserter(result, std::end(result)),
-                 [&portType, &portIndex, &nodeId](ConnectionId const &cid) {
-                     return (getNodeId(portType, cid) == nodeId
-                             && getPortIndex(portType, cid) == portIndex);
-                 });
+    const auto it = _portConnections.find(PortKey{nodeId, portType, portIndex});
+    if (it == _portConnections.end()) {
+        return {};
+    }
 
-    return result;
+    return it->second;
 }
 
 bool DataFlowGraphModel::connectionExists(ConnectionId const connectionId) const
@@ -55,90 +65,249 @@ bool DataFlowGraphModel::connectionExists(ConnectionId const connectionId) const
 }
 
 NodeId DataFlowGraphModel::addNode(QString const nodeType)
+{
+    const NodeId newId = createNode(nodeType);
+
+    if (newId != InvalidNodeId) {
+        Q_EMIT nodeCreated(newId);
+    }
+
+    return newId;
+}
+
+NodeId DataFlowGraphModel::createNode(QString const &nodeType)
 {
     std::unique_ptr<NodeDelegateModel> model = _registry->create(nodeType);
 
-    if (model) {
-        const NodeId newId = newNodeId();
-
-        connect(model.get(),
-                &NodeDelegateModel::dataUpdated,
-                [newId, this](PortIndex const portIndex) {
-                    onOutPortDataUpdated(newId, portIndex);
-                });
-
-        connect(model.get(),
-                &NodeDelegateModel::portsAboutToBeDeleted,
-                this,
-                [newId, this](PortType const portType, PortIndex const first, PortIndex const last) {
-                    portsAboutToBeDeleted(newId, portType, first, last);
-                });
-
-        connect(model.get(),
-                &NodeDelegateModel::portsDeleted,
-                this,
-                &DataFlowGraphModel::portsDeleted);
-
-        connect(model.get(),
-                &NodeDelegateModel::portsAboutToBeInserted,
-                this,
-                [newId, this](PortType const portType, PortIndex const first, PortIndex const last) {
-                    portsAboutToBeInserted(newId, portType, first, last);
-                });
-
-        connect(model.get(),
-                &NodeDelegateModel::portsInserted,
-                this,
-                &DataFlowGraphModel::portsInserted);
-
-        _models[newId] = std::move(model);
+    if (!model) {
+        return InvalidNodeId;
+    }
 
-        Q_EMIT nodeCreated(newId);
+    const NodeId newId = newNodeId();
+
+    connectDelegateModel(newId, model.get());
+
+    _models[newId] = std::move(model);
+
+    appendToTopologicalOrder(newId);
+
+    return newId;
+}
+
+std::vector<NodeId> DataFlowGraphModel::addNodes(std::vector<QString> const &nodeTypes)
+{
+    std::vector<NodeId> nodeIds;
+    nodeIds.reserve(nodeTypes.size());
+
+    std::vector<NodeId> created;
+    created.reserve(nodeTypes.size());
+
+    _models.reserve(_models.size() + nodeTypes.size());
+
+    for (QString const &nodeType : nodeTypes) {
+        const NodeId nodeId = createNode(nodeType);
+        nodeIds.push_back(nodeId);
+        if (nodeId != InvalidNodeId) {
+            created.push_back(nodeId);
+        }
+    }
 
-        return newId;
+    if (!created.empty()) {
+        Q_EMIT nodesCreated(created);
     }
 
-    return InvalidNodeId;
+    return nodeIds;
+}
+
+void DataFlowGraphModel::connectDelegateModel(NodeId const nodeId, NodeDelegateModel *model)
+{
+    connect(
+        model,
+        &NodeDelegateModel::dataUpdated,
+        this,
+        [nodeId, this](PortIndex const portIndex) {
+            // Results computed on a worker thread are propagated by the
+            // evaluation engine once the compute has returned.
+            if (QThread::currentThread() != thread()) {
+                if (_evaluationEngine) {
+                    _evaluationEngine->recordUpdatedPort(nodeId, portIndex);
+                } else {
+                    QMetaObject::invokeMethod(
+                        this,
+                        [nodeId, portIndex, this]() { onOutPortDataUpdated(nodeId, portIndex); },
+                        Qt::QueuedConnection);
+                }
+                return;
+            }
+
+            if (_evaluationEngine && _evaluationEngine->isComputing(nodeId)) {
+                _evaluationEngine->recordUpdatedPort(nodeId, portIndex);
+                return;
+            }
+
+            onOutPortDataUpdated(nodeId, portIndex);
+        },
+        Qt::DirectConnection);
+
+    connect(model, &NodeDelegateModel::embeddedWidgetUpdated, this, [nodeId, this]() {
+        Q_EMIT nodeWidgetUpdated(nodeId);
+    });
+
+    connect(model,
+            &NodeDelegateModel::portsAboutToBeDeleted,
+            this,
+            [nodeId, this](PortType const portType, PortIndex const first, PortIndex const last) {
+                portsAboutToBeDeleted(nodeId, portType, first, last);
+            });
+
+    connect(model,
+            &NodeDelegateModel::portsDeleted,
+            this,
+            [nodeId, this]() {
+                _portTypeHandles.erase(nodeId);
+                portsDeleted();
+            });
+
+    connect(model,
+            &NodeDelegateModel::portsAboutToBeInserted,
+            this,
+            [nodeId, this](PortType const portType, PortIndex const first, PortIndex const last) {
+                portsAboutToBeInserted(nodeId, portType, first, last);
+            });
+
+    connect(model,
+            &NodeDelegateModel::portsInserted,
+            this,
+            [nodeId, this]() {
+                _portTypeHandles.erase(nodeId);
+                portsInserted();
+            });
 }
 
 bool DataFlowGraphModel::connectionPossible(const ConnectionId connectionId) const
 {
-    const auto getDataType = [&](const PortType portType) {
-        return portData(getNodeId(portType, connectionId),
-                        portType,
-                        getPortIndex(portType, connectionId),
-                        PortRole::DataType)
-            .value<NodeDataType>();
-    };
+    const DataTypeHandle out = portTypeHandle(connectionId, PortType::Out);
+    const DataTypeHandle in = portTypeHandle(connectionId, PortType::In);
+    return out == in || _registry->convertersRegister()->contains(FromToTypes{out, in});
+}
 
-    const auto datOut = getDataType(PortType::Out);
-    const auto datIn = getDataType(PortType::In);
-    const bool isSame = datOut.id == datIn.id;
-    return isSame || _registry->convertersRegister()->contains(FromToTypes{datOut.id, datIn.id});
+DataTypeHandle DataFlowGraphModel::portTypeHandle(ConnectionId const &connectionId,
+                                                  PortType const portType) const
+{
+    return portTypeHandle(getNodeId(portType, connectionId),
+                          portType,
+                          getPortIndex(portType, connectionId));
+}
+
+DataTypeHandle DataFlowGraphModel::portTypeHandle(NodeId const nodeId,
+                                                  PortType const portType,
+                                                  PortIndex const portIndex) const
+{
+    // Called for every port while a connection is dragged and on every
+    // repaint, the types are read from the delegates once per node.
+    const auto it = _models.find(nodeId);
+    if (it == _models.end() || portType == PortType::None) {
+        return DataTypeRegistry::intern(QString());
+    }
+
+    NodeDelegateModel const &model = *it->second;
+
+    auto cached = _portTypeHandles.find(nodeId);
+    if (cached == _portTypeHandles.end()) {
+        PortTypeHandles handles;
+        for (PortType const side : {PortType::In, PortType::Out}) {
+            auto &sideHandles = (side == PortType::In) ? handles.in : handles.out;
+            const std::size_t n = model.nPorts(side);
+            sideHandles.reserve(n);
+            for (PortIndex index = 0; index < static_cast<PortIndex>(n); ++index) {
+                sideHandles.push_back(DataTypeRegistry::intern(model.dataType(side, index)));
+            }
+        }
+        cached = _portTypeHandles.emplace(nodeId, std::move(handles)).first;
+    }
+
+    auto const &handles = (portType == PortType::In) ? cached->second.in : cached->second.out;
+    if (portIndex < 0 || static_cast<std::size_t>(portIndex) >= handles.size()) {
+        // The ports changed without notification.
+        return DataTypeRegistry::intern(model.dataType(portType, portIndex));
+    }
+
+    return handles[static_cast<std::size_t>(portIndex)];
 }
 
 void DataFlowGraphModel::addConnection(ConnectionId const connectionId)
 {
-    _connectivity.insert(connectionId);
+    insertConnection(connectionId);
 
     sendConnectionCreation(connectionId);
 
-    const QVariant portDataToPropagate = portData(connectionId.outNodeId,
-                                                  PortType::Out,
-                                                  connectionId.outPortIndex,
-                                                  PortRole::Data);
+    schedulePropagation(connectionId);
 
-    setPortData(connectionId.inNodeId,
-                PortType::In,
-                connectionId.inPortIndex,
-                portDataToPropagate,
-                PortRole::Data);
+    if (_batchUpdateDepth == 0) {
+        propagatePending();
+    }
+}
+
+void DataFlowGraphModel::addConnections(std::vector<ConnectionId> const &connectionIds)
+{
+    std::vector<ConnectionId> created;
+    created.reserve(connectionIds.size());
+
+    _connectivity.reserve(_connectivity.size() + connectionIds.size());
+
+    for (ConnectionId const &connectionId : connectionIds) {
+        if (insertConnection(connectionId)) {
+            created.push_back(connectionId);
+        }
+    }
+
+    if (created.empty()) {
+        return;
+    }
+
+    Q_EMIT connectionsCreated(created);
+
+    const BatchUpdate batch(*this);
+
+    for (ConnectionId const &connectionId : created) {
+        notifyConnectionCreated(connectionId);
+        schedulePropagation(connectionId);
+    }
+}
+
+bool DataFlowGraphModel::insertConnection(ConnectionId const connectionId)
+{
+    if (!_connectivity.insert(connectionId).second) {
+        return false;
+    }
+
+    indexConnection(connectionId);
+
+    if (_topologicalOrderValid) {
+        insertIntoTopologicalOrder(connectionId);
+    }
+
+    const DataTypeHandle out = portTypeHandle(connectionId, PortType::Out);
+    const DataTypeHandle in = portTypeHandle(connectionId, PortType::In);
+    if (out != in) {
+        auto converter = _registry->convertersRegister()->node_data_converter(FromToTypes{out, in});
+        if (converter) {
+            _connectionConverters.emplace(connectionId, std::move(converter));
+        }
+    }
+
+    return true;
 }
 
 void DataFlowGraphModel::sendConnectionCreation(ConnectionId const connectionId)
 {
     Q_EMIT connectionCreated(connectionId);
 
+    notifyConnectionCreated(connectionId);
+}
+
+void DataFlowGraphModel::notifyConnectionCreated(ConnectionId const connectionId)
+{
     const auto iti = _models.find(connectionId.inNodeId);
     const auto ito = _models.find(connectionId.outNodeId);
     if (iti != _models.end() && ito != _models.end()) {
@@ -153,6 +322,11 @@ void DataFlowGraphModel::sendConnectionDeletion(ConnectionId const connectionId)
 {
     Q_EMIT connectionDeleted(connectionId);
 
+    notifyConnectionDeleted(connectionId);
+}
+
+void DataFlowGraphModel::notifyConnectionDeleted(ConnectionId const connectionId)
+{
     const auto iti = _models.find(connectionId.inNodeId);
     const auto ito = _models.find(connectionId.outNodeId);
     if (iti != _models.end() && ito != _models.end()) {
@@ -163,6 +337,260 @@ void DataFlowGraphModel::sendConnectionDeletion(ConnectionId const connectionId)
     }
 }
 
+void DataFlowGraphModel::indexConnection(ConnectionId const connectionId)
+{
+    _portConnections[PortKey{connectionId.outNodeId, PortType::Out, connectionId.outPortIndex}]
+        .insert(connectionId);
+    _portConnections[PortKey{connectionId.inNodeId, PortType::In, connectionId.inPortIndex}]
+        .insert(connectionId);
+
+    _nodeConnections[connectionId.outNodeId].out.insert(connectionId);
+    _nodeConnections[connectionId.inNodeId].in.insert(connectionId);
+}
+
+void DataFlowGraphModel::unindexConnection(ConnectionId const connectionId)
+{
+    const auto erasePort = [this, &connectionId](PortKey const &key) {
+        const auto it = _portConnections.find(key);
+        if (it == _portConnections.end()) {
+            return;
+        }
+
+        it->second.erase(connectionId);
+        if (it->second.empty()) {
+            _portConnections.erase(it);
+        }
+    };
+
+    erasePort(PortKey{connectionId.outNodeId, PortType::Out, connectionId.outPortIndex});
+    erasePort(PortKey{connectionId.inNodeId, PortType::In, connectionId.inPortIndex});
+
+    const auto eraseNode = [this, &connectionId](NodeId const nodeId, PortType const portType) {
+        const auto it = _nodeConnections.find(nodeId);
+        if (it == _nodeConnections.end()) {
+            return;
+        }
+
+        auto &side = (portType == PortType::In) ? it->second.in : it->second.out;
+        side.erase(connectionId);
+        if (it->second.in.empty() && it->second.out.empty()) {
+            _nodeConnections.erase(it);
+        }
+    };
+
+    eraseNode(connectionId.outNodeId, PortType::Out);
+    eraseNode(connectionId.inNodeId, PortType::In);
+}
+
+void DataFlowGraphModel::appendToTopologicalOrder(NodeId const nodeId)
+{
+    if (_topologicalRank.emplace(nodeId, _nextTopologicalRank).second) {
+        ++_nextTopologicalRank;
+    }
+}
+
+void DataFlowGraphModel::insertIntoTopologicalOrder(ConnectionId const connectionId)
+{
+    const NodeId outNodeId = connectionId.outNodeId;
+    const NodeId inNodeId = connectionId.inNodeId;
+
+    appendToTopologicalOrder(outNodeId);
+    appendToTopologicalOrder(inNodeId);
+
+    if (outNodeId == inNodeId) {
+        _topologicalOrderValid = false;
+        return;
+    }
+
+    const std::int64_t lowerRank = _topologicalRank[inNodeId];
+    const std::int64_t upperRank = _topologicalRank[outNodeId];
+
+    // The connection agrees with the current order.
+    if (upperRank < lowerRank) {
+        return;
+    }
+
+    std::vector<NodeId> forward;
+    if (!collectForward(inNodeId, upperRank, outNodeId, forward)) {
+        _topologicalOrderValid = false;
+        return;
+    }
+
+    std::vector<NodeId> backward;
+    collectBackward(outNodeId, lowerRank, backward);
+
+    const auto byRank = [this](NodeId const a, NodeId const b) {
+        return _topologicalRank[a] < _topologicalRank[b];
+    };
+
+    std::sort(forward.begin(), forward.end(), byRank);
+    std::sort(backward.begin(), backward.end(), byRank);
+
+    // The affected nodes reuse their own ranks: everything upstream of the
+    // connection's out node now precedes everything downstream of its in node.
+    std::vector<std::int64_t> ranks;
+    ranks.reserve(forward.size() + backward.size());
+    for (NodeId const nodeId : backward) {
+        ranks.push_back(_topologicalRank[nodeId]);
+    }
+    for (NodeId const nodeId : forward) {
+        ranks.push_back(_topologicalRank[nodeId]);
+    }
+    std::sort(ranks.begin(), ranks.end());
+
+    std::size_t i = 0;
+    for (NodeId const nodeId : backward) {
+        _topologicalRank[nodeId] = ranks[i++];
+    }
+    for (NodeId const nodeId : forward) {
+        _topologicalRank[nodeId] = ranks[i++];
+    }
+}
+
+void DataFlowGraphModel::rebuildTopologicalOrder() const
+{
+    std::unordered_map<NodeId, std::size_t> inDegree;
+    inDegree.reserve(_topologicalRank.size());
+
+    for (auto const &p : _topologicalRank) {
+        const auto it = _nodeConnections.find(p.first);
+        inDegree.emplace(p.first, it == _nodeConnections.end() ? 0 : it->second.in.size());
+    }
+
+    std::vector<NodeId> order;
+    order.reserve(inDegree.size());
+
+    for (auto const &p : inDegree) {
+        if (p.second == 0) {
+            order.push_back(p.first);
+        }
+    }
+
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        const auto it = _nodeConnections.find(order[i]);
+        if (it == _nodeConnections.end()) {
+            continue;
+        }
+
+        for (auto const &cn : it->second.out) {
+            if (--inDegree[cn.inNodeId] == 0) {
+                order.push_back(cn.inNodeId);
+            }
+        }
+    }
+
+    _topologicalOrderValid = order.size() == inDegree.size();
+    _topologicalOrderStale = false;
+
+    if (!_topologicalOrderValid) {
+        for (auto const &p : inDegree) {
+            if (p.second > 0) {
+                order.push_back(p.first);
+            }
+        }
+    }
+
+    _nextTopologicalRank = 0;
+    for (NodeId const nodeId : order) {
+        _topologicalRank[nodeId] = _nextTopologicalRank++;
+    }
+}
+
+bool DataFlowGraphModel::collectForward(NodeId const nodeId,
+                                        std::int64_t const maxRank,
+                                        NodeId const stopNodeId,
+                                        std::vector<NodeId> &visited) const
+{
+    std::unordered_set<NodeId> seen{nodeId};
+    std::vector<NodeId> stack{nodeId};
+
+    while (!stack.empty()) {
+        const NodeId current = stack.back();
+        stack.pop_back();
+        visited.push_back(current);
+
+        const auto it = _nodeConnections.find(current);
+        if (it == _nodeConnections.end()) {
+            continue;
+        }
+
+        for (auto const &cn : it->second.out) {
+            if (cn.inNodeId == stopNodeId) {
+                return false;
+            }
+
+            const auto rankIt = _topologicalRank.find(cn.inNodeId);
+            if (rankIt == _topologicalRank.end() || rankIt->second > maxRank) {
+                continue;
+            }
+
+            if (seen.insert(cn.inNodeId).second) {
+                stack.push_back(cn.inNodeId);
+            }
+        }
+    }
+
+    return true;
+}
+
+void DataFlowGraphModel::collectBackward(NodeId const nodeId,
+                                         std::int64_t const minRank,
+                                         std::vector<NodeId> &visited) const
+{
+    std::unordered_set<NodeId> seen{nodeId};
+    std::vector<NodeId> stack{nodeId};
+
+    while (!stack.empty()) {
+        const NodeId current = stack.back();
+        stack.pop_back();
+        visited.push_back(current);
+
+        const auto it = _nodeConnections.find(current);
+        if (it == _nodeConnections.end()) {
+            continue;
+        }
+
+        for (auto const &cn : it->second.in) {
+            const auto rankIt = _topologicalRank.find(cn.outNodeId);
+            if (rankIt == _topologicalRank.end() || rankIt->second <= minRank) {
+                continue;
+            }
+
+            if (seen.insert(cn.outNodeId).second) {
+                stack.push_back(cn.outNodeId);
+            }
+        }
+    }
+}
+
+bool DataFlowGraphModel::wouldCreateCycle(NodeId const outNodeId, NodeId const inNodeId) const
+{
+    if (outNodeId == inNodeId) {
+        return true;
+    }
+
+    if (!_topologicalOrderValid && _topologicalOrderStale) {
+        rebuildTopologicalOrder();
+    }
+
+    if (!_topologicalOrderValid) {
+        return AbstractGraphModel::wouldCreateCycle(outNodeId, inNodeId);
+    }
+
+    const auto outIt = _topologicalRank.find(outNodeId);
+    const auto inIt = _topologicalRank.find(inNodeId);
+    if (outIt == _topologicalRank.end() || inIt == _topologicalRank.end()) {
+        return false;
+    }
+
+    if (outIt->second < inIt->second) {
+        return false;
+    }
+
+    std::vector<NodeId> visited;
+    return !collectForward(inNodeId, outIt->second, outNodeId, visited);
+}
+
 bool DataFlowGraphModel::nodeExists(NodeId const nodeId) const
 {
     return _models.contains(nodeId);
@@ -228,6 +656,12 @@ QVariant DataFlowGraphModel::nodeData(NodeId nodeId, NodeRole role) const
     return result;
 }
 
+std::shared_ptr<NodeStyle const> DataFlowGraphModel::nodeStyle(NodeId const nodeId) const
+{
+    Q_UNUSED(nodeId);
+    return StyleCollection::nodeStyleHandle();
+}
+
 NodeFlags DataFlowGraphModel::nodeFlags(NodeId nodeId) const
 {
     const auto it = _models.find(nodeId);
@@ -255,7 +689,11 @@ bool DataFlowGraphModel::setNodeData(NodeId nodeId, NodeRole role, QVariant valu
     } break;
 
     case NodeRole::Size: {
-        _nodeGeometryData[nodeId].size = value.value<QSize>();
+        QSize &size = _nodeGeometryData[nodeId].size;
+        if (size != value.value<QSize>()) {
+            size = value.value<QSize>();
+            Q_EMIT nodeSizeUpdated(nodeId);
+        }
         result = true;
     } break;
 
@@ -340,10 +778,10 @@ bool DataFlowGraphModel::setPortData(
     switch (role) {
     case PortRole::Data:
         if (portType == PortType::In) {
-            model->setInData(value.value<std::shared_ptr<NodeData>>(), portIndex);
-
-            // Triggers repainting on the scene.
-            Q_EMIT inPortDataWasSet(nodeId, portType, portIndex);
+            if (deliverInData(nodeId, portIndex, value.value<std::shared_ptr<NodeData>>())
+                && model->threadSafeCompute()) {
+                requestCompute(nodeId);
+            }
         }
         break;
 
@@ -362,6 +800,7 @@ bool DataFlowGraphModel::deleteConnection(ConnectionId const connectionId)
     if (it != _connectivity.end()) {
         disconnected = true;
         _connectivity.erase(it);
+        removeConnection(connectionId);
     }
 
     if (disconnected) {
@@ -373,6 +812,18 @@ bool DataFlowGraphModel::deleteConnection(ConnectionId const connectionId)
     return disconnected;
 }
 
+void DataFlowGraphModel::removeConnection(ConnectionId const connectionId)
+{
+    unindexConnection(connectionId);
+
+    _connectionConverters.erase(connectionId);
+
+    // The removed connection may have been the one closing the cycle.
+    if (!_topologicalOrderValid) {
+        _topologicalOrderStale = true;
+    }
+}
+
 bool DataFlowGraphModel::deleteNode(NodeId const nodeId)
 {
     // Delete connections to this node first.
@@ -381,12 +832,628 @@ bool DataFlowGraphModel::deleteNode(NodeId const nodeId)
         deleteConnection(cId);
     }
 
-    _nodeGeometryData.erase(nodeId);
-    _models.erase(nodeId);
+    destroyNode(nodeId);
+
     Q_EMIT nodeDeleted(nodeId);
     return true;
 }
 
+void DataFlowGraphModel::deleteNodes(std::unordered_set<NodeId> const &nodeIds)
+{
+    std::vector<NodeId> deleted;
+    deleted.reserve(nodeIds.size());
+
+    std::unordered_set<ConnectionId> connectionIds;
+
+    for (NodeId const nodeId : nodeIds) {
+        if (!nodeExists(nodeId)) {
+            continue;
+        }
+
+        deleted.push_back(nodeId);
+
+        const auto it = _nodeConnections.find(nodeId);
+        if (it != _nodeConnections.end()) {
+            connectionIds.insert(it->second.in.begin(), it->second.in.end());
+            connectionIds.insert(it->second.out.begin(), it->second.out.end());
+        }
+    }
+
+    if (deleted.empty()) {
+        return;
+    }
+
+    const BatchUpdate batch(*this);
+
+    if (!connectionIds.empty()) {
+        const std::vector<ConnectionId> removed(connectionIds.begin(), connectionIds.end());
+
+        for (ConnectionId const &connectionId : removed) {
+            _connectivity.erase(connectionId);
+            removeConnection(connectionId);
+        }
+
+        Q_EMIT connectionsDeleted(removed);
+
+        for (ConnectionId const &connectionId : removed) {
+            notifyConnectionDeleted(connectionId);
+
+            // Surviving nodes lose their inputs.
+            if (nodeIds.find(connectionId.inNodeId) == nodeIds.end()) {
+                propagateEmptyDataTo(connectionId.inNodeId, connectionId.inPortIndex);
+            }
+        }
+    }
+
+    for (NodeId const nodeId : deleted) {
+        destroyNode(nodeId);
+    }
+
+    Q_EMIT nodesDeleted(deleted);
+}
+
+void DataFlowGraphModel::destroyNode(NodeId const nodeId)
+{
+    _nodeConnections.erase(nodeId);
+    _nodeGeometryData.erase(nodeId);
+    _portTypeHandles.erase(nodeId);
+    _pendingPropagation.erase(nodeId);
+    _topologicalRank.erase(nodeId);
+    _memos.erase(nodeId);
+
+    if (_profiler) {
+        _profiler->removeNode(nodeId);
+    }
+
+    for (auto it = _convertedData.begin(); it != _convertedData.end();) {
+        if (std::get<0>(it->first) == nodeId) {
+            it = _convertedData.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    const auto it = _models.find(nodeId);
+    if (it != _models.end()) {
+        if (_evaluationEngine) {
+            _evaluationEngine->retire(nodeId, std::move(it->second));
+        }
+        _models.erase(it);
+    }
+}
+
+void DataFlowGraphModel::beginBatchUpdate()
+{
+    ++_batchUpdateDepth;
+}
+
+void DataFlowGraphModel::endBatchUpdate()
+{
+    if (_batchUpdateDepth == 0) {
+        return;
+    }
+
+    if (--_batchUpdateDepth != 0) {
+        return;
+    }
+
+    try {
+        propagatePending();
+    } catch (std::exception const &e) {
+        _pendingPropagation.clear();
+        qWarning() << "Propagating a batch update failed:" << e.what();
+    } catch (...) {
+        _pendingPropagation.clear();
+        qWarning() << "Propagating a batch update failed";
+    }
+}
+
+DataFlowGraphModel::BatchUpdate::BatchUpdate(DataFlowGraphModel &model)
+    : _model(model)
+    , _uncaughtExceptions(std::uncaught_exceptions())
+{
+    _model.beginBatchUpdate();
+}
+
+DataFlowGraphModel::BatchUpdate::~BatchUpdate() noexcept
+{
+    // Propagating while unwinding could throw again, and the queued updates
+    // may belong to the half-done change.
+    if (std::uncaught_exceptions() > _uncaughtExceptions) {
+        if (_model._batchUpdateDepth > 0 && --_model._batchUpdateDepth == 0) {
+            _model._pendingPropagation.clear();
+        }
+        return;
+    }
+
+    _model.endBatchUpdate();
+}
+
+void DataFlowGraphModel::setAsynchronousEvaluation(bool enabled)
+{
+    if (enabled == asynchronousEvaluation()) {
+        return;
+    }
+
+    if (enabled) {
+        _evaluationEngine = std::make_unique<DataFlowEvaluationEngine>(*this);
+    } else {
+        waitForEvaluation();
+        _evaluationEngine.reset();
+    }
+}
+
+void DataFlowGraphModel::setProfilingEnabled(bool enabled)
+{
+    if (enabled == profilingEnabled()) {
+        return;
+    }
+
+    _profiler = enabled ? std::make_unique<NodeProfiler>() : nullptr;
+}
+
+QThreadPool *DataFlowGraphModel::evaluationThreadPool()
+{
+    return _evaluationEngine ? &_evaluationEngine->threadPool() : nullptr;
+}
+
+bool DataFlowGraphModel::waitForEvaluation(int msecs)
+{
+    const QDeadlineTimer deadline(msecs);
+
+    while (_evaluationEngine && _evaluationEngine->isBusy()) {
+        if (deadline.hasExpired()) {
+            return false;
+        }
+
+        _evaluationEngine->threadPool().waitForDone(10);
+
+        // Delivers the "compute finished" notifications posted by the workers.
+        QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+    }
+
+    return true;
+}
+
+void DataFlowGraphModel::requestCompute(NodeId const nodeId)
+{
+    const auto it = _models.find(nodeId);
+    if (it == _models.end()) {
+        return;
+    }
+
+    const auto &model = it->second;
+
+    // Supersedes the running compute, the model must not be touched meanwhile.
+    if (_evaluationEngine && _evaluationEngine->isComputing(nodeId)) {
+        _evaluationEngine->schedule(nodeId);
+        return;
+    }
+
+    if (reuseMemoizedOutputs(nodeId, *model)) {
+        return;
+    }
+
+    if (_evaluationEngine) {
+        _evaluationEngine->schedule(nodeId);
+        return;
+    }
+
+    Q_EMIT model->computingStarted();
+
+    NODE_EDITOR_TRACE_NODE_SCOPE("compute", nodeId);
+
+    if (_profiler) {
+        const auto start = NodeProfiler::Clock::now();
+        model->compute();
+        _profiler->recordCompute(nodeId, NodeProfiler::Clock::now() - start);
+    } else {
+        model->compute();
+    }
+
+    memoizeOutputs(nodeId, *model);
+
+    Q_EMIT model->computingFinished();
+}
+
+bool DataFlowGraphModel::reuseMemoizedOutputs(NodeId const nodeId, NodeDelegateModel &model)
+{
+    if (model.memoizationCacheSize() == 0) {
+        return false;
+    }
+
+    NodeMemo &memo = _memos[nodeId];
+    memo.computing.reset();
+
+    const auto inPorts = model.nPorts(PortType::In);
+
+    std::vector<MemoInput> inputs;
+    inputs.reserve(inPorts);
+
+    for (PortIndex portIndex = 0; portIndex < inPorts; ++portIndex) {
+        // Ports which never received data are empty.
+        const auto index = static_cast<std::size_t>(portIndex);
+        const auto input = index < memo.inputHashes.size() ? memo.inputHashes[index]
+                                                           : MemoInput(false, 0);
+        if (!input) {
+            ++memo.stats.misses;
+            return false;
+        }
+        inputs.push_back(*input);
+    }
+
+    const auto entry = std::find_if(memo.entries.begin(),
+                                    memo.entries.end(),
+                                    [&inputs](MemoizedOutputs const &e) {
+                                        return e.inputs == inputs;
+                                    });
+
+    if (entry == memo.entries.end()) {
+        ++memo.stats.misses;
+        memo.computing = std::move(inputs);
+        return false;
+    }
+
+    ++memo.stats.hits;
+
+    // The model already holds these outputs, downstream has seen them.
+    if (entry == memo.entries.begin() && memo.current) {
+        return true;
+    }
+
+    memo.entries.splice(memo.entries.begin(), memo.entries, entry);
+    memo.current = true;
+
+    const std::vector<std::shared_ptr<NodeData>> outputs = memo.entries.front().outputs;
+
+    for (std::size_t index = 0; index < outputs.size(); ++index) {
+        model.restoreOutData(outputs[index], static_cast<PortIndex>(index));
+    }
+
+    // All the restored ports form a single change wave.
+    {
+        const BatchUpdate batch(*this);
+        for (std::size_t index = 0; index < outputs.size(); ++index) {
+            onOutPortDataUpdated(nodeId, static_cast<PortIndex>(index));
+        }
+    }
+
+    return true;
+}
+
+void DataFlowGraphModel::memoizeOutputs(NodeId const nodeId, NodeDelegateModel &model)
+{
+    const auto it = _memos.find(nodeId);
+    if (it == _memos.end()) {
+        return;
+    }
+
+    NodeMemo &memo = it->second;
+
+    // Computed from inputs without a hash.
+    if (!memo.computing) {
+        memo.current = false;
+        return;
+    }
+
+    MemoizedOutputs entry{std::move(*memo.computing), {}};
+    memo.computing.reset();
+
+    const auto outPorts = model.nPorts(PortType::Out);
+    entry.outputs.reserve(outPorts);
+    for (PortIndex portIndex = 0; portIndex < outPorts; ++portIndex) {
+        entry.outputs.push_back(model.outData(portIndex));
+    }
+
+    memo.entries.push_front(std::move(entry));
+
+    while (memo.entries.size() > model.memoizationCacheSize()) {
+        memo.entries.pop_back();
+    }
+
+    memo.current = !memo.entries.empty();
+}
+
+void DataFlowGraphModel::forgetComputedOutputs(NodeId const nodeId)
+{
+    const auto it = _memos.find(nodeId);
+    if (it == _memos.end()) {
+        return;
+    }
+
+    it->second.computing.reset();
+    it->second.current = false;
+}
+
+DataFlowGraphModel::MemoizationStats DataFlowGraphModel::memoizationStats(NodeId const nodeId) const
+{
+    const auto it = _memos.find(nodeId);
+    return it != _memos.end() ? it->second.stats : MemoizationStats();
+}
+
+void DataFlowGraphModel::clearMemoizedOutputs(NodeId const nodeId)
+{
+    const auto it = _memos.find(nodeId);
+    if (it == _memos.end()) {
+        return;
+    }
+
+    it->second.entries.clear();
+    it->second.current = false;
+    it->second.computing.reset();
+}
+
+bool DataFlowGraphModel::deliverInData(NodeId const nodeId,
+                                       PortIndex const portIndex,
+                                       std::shared_ptr<NodeData> nodeData)
+{
+    const auto it = _models.find(nodeId);
+    if (it == _models.end()) {
+        return false;
+    }
+
+    // The node is busy on a worker thread, the input is delivered once the
+    // running compute has returned.
+    if (_evaluationEngine && _evaluationEngine->isComputing(nodeId)) {
+        _evaluationEngine->deferInput(nodeId, portIndex, std::move(nodeData));
+        return false;
+    }
+
+    setModelInData(nodeId, *it->second, std::move(nodeData), portIndex);
+
+    // Triggers repainting on the scene.
+    Q_EMIT inPortDataWasSet(nodeId, PortType::In, portIndex);
+
+    return true;
+}
+
+void DataFlowGraphModel::setModelInData(NodeId const nodeId,
+                                        NodeDelegateModel &model,
+                                        std::shared_ptr<NodeData> nodeData,
+                                        PortIndex const portIndex)
+{
+    NODE_EDITOR_TRACE_NODE_SCOPE("setInData", nodeId);
+
+    if (model.threadSafeCompute() && model.memoizationCacheSize() > 0) {
+        auto &inputHashes = _memos[nodeId].inputHashes;
+        const auto index = static_cast<std::size_t>(portIndex);
+        if (inputHashes.size() <= index) {
+            inputHashes.resize(index + 1, MemoInput(false, 0));
+        }
+
+        // Empty inputs are keyed like ports without data, apart from any hash.
+        if (!nodeData) {
+            inputHashes[index] = MemoInput(false, 0);
+        } else if (const auto hash = nodeData->contentHash()) {
+            inputHashes[index] = MemoInput(true, *hash);
+        } else {
+            inputHashes[index].reset();
+        }
+    }
+
+    if (!_profiler) {
+        model.setInData(std::move(nodeData), portIndex);
+        return;
+    }
+
+    const auto start = NodeProfiler::Clock::now();
+    _profiler->recordInputArrival(nodeId, start);
+
+    model.setInData(std::move(nodeData), portIndex);
+
+    const auto duration = NodeProfiler::Clock::now() - start;
+
+    // The profiler may have been disabled by the model.
+    if (_profiler) {
+        _profiler->recordSetInData(nodeId, duration);
+
+        // Models without `compute()` do their work here.
+        if (!model.threadSafeCompute()) {
+            _profiler->recordCompute(nodeId, duration);
+        }
+    }
+}
+
+std::shared_ptr<NodeData> DataFlowGraphModel::convertData(ConnectionId const &connectionId,
+                                                          std::shared_ptr<NodeData> nodeData)
+{
+    const auto converterIt = _connectionConverters.find(connectionId);
+    if (!nodeData || converterIt == _connectionConverters.end()) {
+        return nodeData;
+    }
+
+    ConverterPtr const &converter = converterIt->second;
+
+    auto &converted
+        = _convertedData[PortKey{connectionId.outNodeId, PortType::Out, connectionId.outPortIndex}];
+
+    for (ConvertedData &entry : converted) {
+        if (entry.converter != converter) {
+            continue;
+        }
+
+        if (entry.source.lock() != nodeData) {
+            entry.source = nodeData;
+            entry.result = (*converter)(nodeData);
+        }
+
+        return entry.result;
+    }
+
+    auto result = (*converter)(nodeData);
+    converted.push_back(ConvertedData{converter, nodeData, result});
+
+    return result;
+}
+
+void DataFlowGraphModel::schedulePropagation(ConnectionId const connectionId)
+{
+    _pendingPropagation[connectionId.inNodeId].insert(connectionId);
+}
+
+void DataFlowGraphModel::propagatePending()
+{
+    if (_propagating) {
+        return;
+    }
+
+    // Reset even if a model throws, later waves would be dropped otherwise.
+    const QScopedValueRollback<bool> propagating(_propagating, true);
+
+    NODE_EDITOR_TRACE_SCOPE("propagationWave");
+
+    while (!_pendingPropagation.empty()) {
+        std::vector<NodeId> seeds;
+        seeds.reserve(_pendingPropagation.size());
+        for (auto const &p : _pendingPropagation) {
+            seeds.push_back(p.first);
+        }
+
+        for (NodeId const nodeId : downstreamOrder(seeds)) {
+            const auto pendingIt = _pendingPropagation.find(nodeId);
+            if (pendingIt == _pendingPropagation.end()) {
+                continue;
+            }
+
+            const std::unordered_set<ConnectionId> pending = std::move(pendingIt->second);
+            _pendingPropagation.erase(pendingIt);
+
+            const auto modelIt = _models.find(nodeId);
+            if (modelIt == _models.end()) {
+                continue;
+            }
+
+            bool delivered = false;
+            for (auto const &cn : pending) {
+                if (!connectionExists(cn)) {
+                    continue;
+                }
+
+                // The outputs are being written on a worker thread, they are
+                // read once the compute has returned.
+                if (_evaluationEngine && _evaluationEngine->isComputing(cn.outNodeId)) {
+                    _evaluationEngine->deferConnection(cn.outNodeId, cn);
+                    continue;
+                }
+
+                const bool profiling = _profiler != nullptr;
+                const auto start = profiling ? NodeProfiler::Clock::now()
+                                             : NodeProfiler::Clock::time_point();
+
+                auto nodeData = portData(cn.outNodeId, PortType::Out, cn.outPortIndex, PortRole::Data)
+                                    .value<std::shared_ptr<NodeData>>();
+
+                nodeData = convertData(cn, std::move(nodeData));
+
+                delivered = deliverInData(nodeId, cn.inPortIndex, std::move(nodeData)) || delivered;
+
+                if (profiling && _profiler) {
+                    _profiler->recordFanOut(cn.outNodeId, NodeProfiler::Clock::now() - start);
+                }
+            }
+
+            // One compute for all the inputs of the wave.
+            if (delivered && modelIt->second->threadSafeCompute()) {
+                requestCompute(nodeId);
+            }
+        }
+    }
+}
+
+std::vector<NodeId> DataFlowGraphModel::downstreamOrder(std::vector<NodeId> const &seeds) const
+{
+    // Collects the affected sub-graph.
+    std::unordered_map<NodeId, std::size_t> inDegree;
+    std::vector<NodeId> stack(seeds.begin(), seeds.end());
+
+    for (NodeId const nodeId : seeds) {
+        inDegree.emplace(nodeId, 0);
+    }
+
+    while (!stack.empty()) {
+        const NodeId nodeId = stack.back();
+        stack.pop_back();
+
+        const auto it = _nodeConnections.find(nodeId);
+        if (it == _nodeConnections.end()) {
+            continue;
+        }
+
+        for (auto const &cn : it->second.out) {
+            if (inDegree.emplace(cn.inNodeId, 0).second) {
+                stack.push_back(cn.inNodeId);
+            }
+        }
+    }
+
+    for (auto const &p : inDegree) {
+        const auto it = _nodeConnections.find(p.first);
+        if (it == _nodeConnections.end()) {
+            continue;
+        }
+
+        for (auto const &cn : it->second.out) {
+            ++inDegree[cn.inNodeId];
+        }
+    }
+
+    if (!_topologicalOrderValid && _topologicalOrderStale) {
+        rebuildTopologicalOrder();
+    }
+
+    // Acyclic graphs are already ranked, the sub-graph only needs sorting.
+    if (_topologicalOrderValid) {
+        std::vector<std::pair<std::int64_t, NodeId>> ranked;
+        ranked.reserve(inDegree.size());
+        for (auto const &p : inDegree) {
+            const auto rankIt = _topologicalRank.find(p.first);
+            ranked.emplace_back(rankIt == _topologicalRank.end() ? -1 : rankIt->second, p.first);
+        }
+        std::sort(ranked.begin(), ranked.end());
+
+        std::vector<NodeId> order;
+        order.reserve(ranked.size());
+        for (auto const &p : ranked) {
+            order.push_back(p.second);
+        }
+        return order;
+    }
+
+    // Kahn's algorithm over the sub-graph.
+    std::vector<NodeId> order;
+    order.reserve(inDegree.size());
+
+    for (auto const &p : inDegree) {
+        if (p.second == 0) {
+            order.push_back(p.first);
+        }
+    }
+
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        const auto it = _nodeConnections.find(order[i]);
+        if (it == _nodeConnections.end()) {
+            continue;
+        }
+
+        for (auto const &cn : it->second.out) {
+            if (--inDegree[cn.inNodeId] == 0) {
+                order.push_back(cn.inNodeId);
+            }
+        }
+    }
+
+    // Nodes on a cycle never reach zero, they are visited last.
+    if (order.size() < inDegree.size()) {
+        for (auto const &p : inDegree) {
+            if (p.second > 0) {
+                order.push_back(p.first);
+            }
+        }
+    }
+
+    return order;
+}
+
 QJsonObject DataFlowGraphModel::saveNode(NodeId const nodeId) const
 {
     QJsonObject nodeJson;
@@ -406,6 +1473,8 @@ QJsonObject DataFlowGraphModel::saveNode(NodeId const nodeId) const
 
 QJsonObject DataFlowGraphModel::save() const
 {
+    NODE_EDITOR_TRACE_SCOPE("save");
+
     QJsonObject sceneJson;
     QJsonArray nodesJsonArray;
     for (auto const nodeId : allNodeIds()) {
@@ -433,31 +1502,37 @@ void DataFlowGraphModel::loadNode(QJsonObject const &nodeJson)
     // because all the new ids were created past the removed nodes.
     const NodeId restoredNodeId = nodeJson["id"].toInt();
 
-    _nextNodeId = std::max(_nextNodeId, restoredNodeId + 1);
+    const QJsonObject posJson = nodeJson["position"].toObject();
+    const QPointF pos(posJson["x"].toDouble(), posJson["y"].toDouble());
 
-    const QJsonObject internalDataJson = nodeJson["internal-data"].toObject();
+    restoreNode(restoredNodeId, pos, nodeJson["internal-data"].toObject());
+}
+
+void DataFlowGraphModel::restoreNode(NodeId const restoredNodeId,
+                                     QPointF const &pos,
+                                     QJsonObject const &internalDataJson)
+{
+    _nextNodeId = std::max(_nextNodeId, restoredNodeId + 1);
 
     const QString delegateModelName = internalDataJson["model-name"].toString();
 
     std::unique_ptr<NodeDelegateModel> model = _registry->create(delegateModelName);
 
     if (model) {
-        connect(model.get(),
-                &NodeDelegateModel::dataUpdated,
-                [restoredNodeId, this](PortIndex const portIndex) {
-                    onOutPortDataUpdated(restoredNodeId, portIndex);
-                });
+        connectDelegateModel(restoredNodeId, model.get());
 
         _models[restoredNodeId] = std::move(model);
 
-        Q_EMIT nodeCreated(restoredNodeId);
+        appendToTopologicalOrder(restoredNodeId);
 
-        const QJsonObject posJson = nodeJson["position"].toObject();
-        const QPointF pos(posJson["x"].toDouble(), posJson["y"].toDouble());
+        Q_EMIT nodeCreated(restoredNodeId);
 
         setNodeData(restoredNodeId, NodeRole::Position, pos);
 
         _models[restoredNodeId]->load(internalDataJson);
+
+        // Loading may reconfigure the ports.
+        _portTypeHandles.erase(restoredNodeId);
     } else {
         throw std::logic_error(std::string("No registered model with name ")
                                + delegateModelName.toLocal8Bit().data());
@@ -466,6 +1541,12 @@ void DataFlowGraphModel::loadNode(QJsonObject const &nodeJson)
 
 void DataFlowGraphModel::load(QJsonObject const &jsonDocument)
 {
+    NODE_EDITOR_TRACE_SCOPE("load");
+
+    // Every node receives its restored inputs once, after all the
+    // connections are in place.
+    const BatchUpdate batch(*this);
+
     QJsonArray nodesJsonArray = jsonDocument["nodes"].toArray();
 
     for (QJsonValueRef nodeJson : nodesJsonArray) {
@@ -474,24 +1555,102 @@ void DataFlowGraphModel::load(QJsonObject const &jsonDocument)
 
     QJsonArray connectionJsonArray = jsonDocument["connections"].toArray();
 
+    _connectivity.reserve(_connectivity.size() + connectionJsonArray.size());
+
+    // Emits `connectionCreated` per connection, as listeners of loaded graphs expect.
     for (QJsonValueRef connection : connectionJsonArray) {
         const QJsonObject connJson = connection.toObject();
-        const ConnectionId connId = fromJson(connJson);
-        // Restore the connection
-        addConnection(connId);
+        addConnection(fromJson(connJson));
+    }
+}
+
+bool DataFlowGraphModel::saveBinary(QIODevice &device) const
+{
+    NODE_EDITOR_TRACE_SCOPE("saveBinary");
+
+    BinaryGraphWriter writer(device);
+
+    writer.beginSection(BinaryGraphFormat::Section::Nodes, _models.size());
+    for (auto const &p : _models) {
+        const auto geometryIt = _nodeGeometryData.find(p.first);
+        const QPointF pos = (geometryIt != _nodeGeometryData.end()) ? geometryIt->second.pos
+                                                                    : QPointF();
+
+        writer.writeNode(p.first, pos, p.second->save());
+    }
+
+    writer.beginSection(BinaryGraphFormat::Section::Connections, _connectivity.size());
+    for (auto const &cid : _connectivity) {
+        writer.writeConnection(cid);
+    }
+
+    writer.finish();
+
+    return !writer.hasError();
+}
+
+bool DataFlowGraphModel::loadBinary(QIODevice &device)
+{
+    NODE_EDITOR_TRACE_SCOPE("loadBinary");
+
+    BinaryGraphReader reader(device);
+    if (!reader.readHeader()) {
+        return false;
+    }
+
+    // Same as in load(): the graph is evaluated once everything is restored.
+    const BatchUpdate batch(*this);
+
+    BinaryGraphFormat::Section section = BinaryGraphFormat::Section::End;
+    quint64 recordCount = 0;
+    BinaryNodeRecord nodeRecord;
+    ConnectionId connectionId;
+
+    while (reader.nextSection(section, recordCount)) {
+        switch (section) {
+        case BinaryGraphFormat::Section::Nodes:
+            while (reader.readNode(nodeRecord)) {
+                restoreNode(nodeRecord.id, nodeRecord.position, nodeRecord.internalDataJson());
+            }
+            break;
+
+        case BinaryGraphFormat::Section::Connections:
+            _connectivity.reserve(_connectivity.size() + recordCount);
+            while (reader.readConnection(connectionId)) {
+                addConnection(connectionId);
+            }
+            break;
+
+        case BinaryGraphFormat::Section::End:
+            break;
+        }
     }
+
+    return !reader.hasError();
 }
 
 void DataFlowGraphModel::onOutPortDataUpdated(NodeId const nodeId, PortIndex const portIndex)
 {
-    std::unordered_set<ConnectionId> const &connected = connections(nodeId,
-                                                                    PortType::Out,
-                                                                    portIndex);
+    NODE_EDITOR_TRACE_NODE_SCOPE("onOutPortDataUpdated", nodeId);
+
+    if (_profiler) {
+        _profiler->recordDataUpdated(nodeId, NodeProfiler::Clock::now());
+    }
+
+    // The model may have changed its data in place.
+    _convertedData.erase(PortKey{nodeId, PortType::Out, portIndex});
 
-    const QVariant portDataToPropagate = portData(nodeId, PortType::Out, portIndex, PortRole::Data);
+    const auto it = _portConnections.find(PortKey{nodeId, PortType::Out, portIndex});
+    if (it == _portConnections.end()) {
+        return;
+    }
+
+    for (auto const &cn : it->second) {
+        schedulePropagation(cn);
+    }
 
-    for (auto const &cn : connected) {
-        setPortData(cn.inNodeId, PortType::In, cn.inPortIndex, portDataToPropagate, PortRole::Data);
+    if (_batchUpdateDepth == 0) {
+        propagatePending();
     }
 }
 
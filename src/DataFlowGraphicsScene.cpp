@@ -1,5 +1,6 @@
 #include "DataFlowGraphicsScene.hpp"
 
+#include "BinaryGraphFormat.hpp"
 #include "ConnectionGraphicsObject.hpp"
 #include "GraphicsView.hpp"
 #include "NodeDelegateModelRegistry.hpp"
@@ -34,7 +35,9 @@ DataFlowGraphicsScene::DataFlowGraphicsScene(DataFlowGraphModel &graphModel, QOb
 {
     connect(&_graphModel,
             &DataFlowGraphModel::inPortDataWasSet,
-            [this](NodeId const nodeId, PortType const, PortIndex const) { onNodeUpdated(nodeId); });
+            [this](NodeId const nodeId, PortType const, PortIndex const) {
+                onNodeDataUpdated(nodeId);
+            });
 }
 
 // TODO constructor for an empyt scene?
@@ -145,16 +148,23 @@ void DataFlowGraphicsScene::save() const
     QString fileName = QFileDialog::getSaveFileName(nullptr,
                                                     tr("Open Flow Scene"),
                                                     QDir::homePath(),
-                                                    tr("Flow Scene Files (*.flow)"));
+                                                    tr("Flow Scene Files (*.flow);;"
+                                                       "Binary Flow Scene Files (*.flowb)"));
 
     if (!fileName.isEmpty()) {
-        if (!fileName.endsWith("flow", Qt::CaseInsensitive)) {
+        const bool binary = fileName.endsWith(".flowb", Qt::CaseInsensitive);
+
+        if (!binary && !fileName.endsWith("flow", Qt::CaseInsensitive)) {
             fileName += ".flow";
         }
 
         QFile file(fileName);
         if (file.open(QIODevice::WriteOnly)) {
-            file.write(QJsonDocument(_graphModel.save()).toJson());
+            if (binary) {
+                _graphModel.saveBinary(file);
+            } else {
+                file.write(QJsonDocument(_graphModel.save()).toJson());
+            }
         }
     }
 }
@@ -164,7 +174,7 @@ void DataFlowGraphicsScene::load()
     const QString fileName = QFileDialog::getOpenFileName(nullptr,
                                                           tr("Open Flow Scene"),
                                                           QDir::homePath(),
-                                                          tr("Flow Scene Files (*.flow)"));
+                                                          tr("Flow Scene Files (*.flow *.flowb)"));
 
     if (!QFileInfo::exists(fileName)) {
         return;
@@ -176,8 +186,14 @@ void DataFlowGraphicsScene::load()
     }
 
     clearScene();
-    const QByteArray wholeFile = file.readAll();
-    _graphModel.load(QJsonDocument::fromJson(wholeFile).object());
+
+    if (BinaryGraphFormat::isBinaryGraph(file)) {
+        _graphModel.loadBinary(file);
+    } else {
+        const QByteArray wholeFile = file.readAll();
+        _graphModel.load(QJsonDocument::fromJson(wholeFile).object());
+    }
+
     Q_EMIT sceneLoaded();
 }
 
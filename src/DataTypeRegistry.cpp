@@ -0,0 +1,113 @@
+#include "DataTypeRegistry.hpp"
+
+#include <QtCore/QHash>
+
+#include <random>
+
+namespace QtNodes {
+
+namespace {
+
+QColor colorFromTypeId(QString const &typeId)
+{
+    std::size_t hash = qHash(typeId);
+
+    std::size_t const hue_range = 0xFF;
+
+    std::mt19937 gen(static_cast<unsigned int>(hash));
+    std::uniform_int_distribution<int> distrib(0, hue_range);
+
+    int hue = distrib(gen);
+    int sat = 120 + hash % 129;
+
+    return QColor::fromHsl(hue, sat, 160);
+}
+
+} // namespace
+
+DataTypeHandle DataTypeRegistry::intern(QString const &typeId)
+{
+    auto &registry = instance();
+    const std::lock_guard<std::mutex> lock(registry._mutex);
+
+    return registry.internLocked(typeId);
+}
+
+DataTypeHandle DataTypeRegistry::intern(NodeDataType const &type)
+{
+    auto &registry = instance();
+    const std::lock_guard<std::mutex> lock(registry._mutex);
+
+    const DataTypeHandle handle = registry.internLocked(type.id);
+
+    // Models disagreeing on the color of a type do not repaint each other's connections.
+    if (type.color.isValid() && !registry._givenColors[handle]) {
+        registry._colors[handle] = type.color;
+        registry._givenColors[handle] = true;
+    }
+
+    return handle;
+}
+
+QString const &DataTypeRegistry::typeId(DataTypeHandle handle)
+{
+    auto &registry = instance();
+    const std::lock_guard<std::mutex> lock(registry._mutex);
+
+    // Elements of a deque stay in place while it grows.
+    return registry._typeIds[handle];
+}
+
+QColor DataTypeRegistry::color(DataTypeHandle handle)
+{
+    auto &registry = instance();
+    const std::lock_guard<std::mutex> lock(registry._mutex);
+
+    return registry._colors[handle];
+}
+
+QColor DataTypeRegistry::color(QString const &typeId)
+{
+    auto &registry = instance();
+    const std::lock_guard<std::mutex> lock(registry._mutex);
+
+    const auto it = registry._handles.find(typeId);
+    if (it == registry._handles.end()) {
+        return colorFromTypeId(typeId);
+    }
+
+    return registry._colors[it->second];
+}
+
+std::size_t DataTypeRegistry::size()
+{
+    auto &registry = instance();
+    const std::lock_guard<std::mutex> lock(registry._mutex);
+
+    return registry._typeIds.size();
+}
+
+DataTypeRegistry &DataTypeRegistry::instance()
+{
+    static DataTypeRegistry registry;
+    return registry;
+}
+
+DataTypeHandle DataTypeRegistry::internLocked(QString const &typeId)
+{
+    const auto it = _handles.find(typeId);
+    if (it != _handles.end()) {
+        return it->second;
+    }
+
+    const auto handle = static_cast<DataTypeHandle>(_typeIds.size());
+
+    _handles.emplace(typeId, handle);
+    _typeIds.push_back(typeId);
+    _colors.push_back(colorFromTypeId(typeId));
+    _givenColors.push_back(false);
+
+    return handle;
+}
+
+} // namespace QtNodes
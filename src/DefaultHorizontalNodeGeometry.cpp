@@ -16,6 +16,13 @@ DefaultHorizontalNodeGeometry::DefaultHorizontalNodeGeometry(AbstractGraphModel
     , _fontMetrics(QFont())
     , _boldFontMetrics(QFont())
 {
+    updateFontMetrics();
+}
+
+void DefaultHorizontalNodeGeometry::updateFontMetrics() const
+{
+    _fontMetrics = QFontMetrics(QFont());
+
     QFont f;
     f.setBold(true);
     _boldFontMetrics = QFontMetrics(f);
@@ -30,21 +37,24 @@ QSize DefaultHorizontalNodeGeometry::size(NodeId const nodeId) const
 
 void DefaultHorizontalNodeGeometry::recomputeSize(NodeId const nodeId) const
 {
+    NodeLayout &layout = _layouts[nodeId];
+    layout.measure(_graphModel, nodeId, _fontMetrics, _boldFontMetrics);
+
     unsigned int height = maxVerticalPortsExtent(nodeId);
 
     if (auto w = _graphModel.nodeData<QWidget *>(nodeId, NodeRole::Widget)) {
         height = std::max(height, static_cast<unsigned int>(w->height()));
     }
 
-    const QRectF capRect = captionRect(nodeId);
+    const QRectF capRect = layout.captionRect;
 
     height += capRect.height();
 
     height += _portSpasing; // space above caption
     height += _portSpasing; // space below caption
 
-    const unsigned int inPortWidth = maxPortsTextAdvance(nodeId, PortType::In);
-    const unsigned int outPortWidth = maxPortsTextAdvance(nodeId, PortType::Out);
+    const unsigned int inPortWidth = layout.in.textAdvance;
+    const unsigned int outPortWidth = layout.out.textAdvance;
 
     unsigned int width = inPortWidth + outPortWidth + 4 * _portSpasing;
 
@@ -63,105 +73,37 @@ QPointF DefaultHorizontalNodeGeometry::portPosition(NodeId const nodeId,
                                                     PortType const portType,
                                                     PortIndex const portIndex) const
 {
-    unsigned int const step = _portSize + _portSpasing;
-
-    QPointF result;
-
-    double totalHeight = 0.0;
-
-    totalHeight += captionRect(nodeId).height();
-    totalHeight += _portSpasing;
-
-    totalHeight += step * portIndex;
-    totalHeight += step / 2.0;
-
-    QSize size = _graphModel.nodeData<QSize>(nodeId, NodeRole::Size);
-
-    switch (portType) {
-    case PortType::In: {
-        double x = 0.0;
-
-        result = QPointF(x, totalHeight);
-        break;
-    }
-
-    case PortType::Out: {
-        double x = size.width();
-
-        result = QPointF(x, totalHeight);
-        break;
-    }
-
-    default:
-        break;
+    if (portType == PortType::None) {
+        return QPointF();
     }
 
-    return result;
+    return layout(nodeId).side(portType).position(portIndex);
 }
 
 QPointF DefaultHorizontalNodeGeometry::portTextPosition(NodeId const nodeId,
                                                         PortType const portType,
                                                         PortIndex const portIndex) const
 {
-    QPointF p = portPosition(nodeId, portType, portIndex);
-
-    QRectF rect = portTextRect(nodeId, portType, portIndex);
-
-    p.setY(p.y() + rect.height() / 4.0);
-
-    QSize size = _graphModel.nodeData<QSize>(nodeId, NodeRole::Size);
-
-    switch (portType) {
-    case PortType::In:
-        p.setX(_portSpasing);
-        break;
-
-    case PortType::Out:
-        p.setX(size.width() - _portSpasing - rect.width());
-        break;
-
-    default:
-        break;
+    if (portType == PortType::None) {
+        return QPointF();
     }
 
-    return p;
+    return layout(nodeId).side(portType).textPosition(portIndex);
 }
 
 QRectF DefaultHorizontalNodeGeometry::captionRect(NodeId const nodeId) const
 {
-    if (!_graphModel.nodeData<bool>(nodeId, NodeRole::CaptionVisible))
-        return QRect();
-
-    QString name = _graphModel.nodeData<QString>(nodeId, NodeRole::Caption);
-
-    return _boldFontMetrics.boundingRect(name);
+    return layout(nodeId).captionRect;
 }
 
 QPointF DefaultHorizontalNodeGeometry::captionPosition(NodeId const nodeId) const
 {
-    QSize size = _graphModel.nodeData<QSize>(nodeId, NodeRole::Size);
-    return QPointF(0.5 * (size.width() - captionRect(nodeId).width()),
-                   0.5 * _portSpasing + captionRect(nodeId).height());
+    return layout(nodeId).captionPosition;
 }
 
 QPointF DefaultHorizontalNodeGeometry::widgetPosition(NodeId const nodeId) const
 {
-    QSize size = _graphModel.nodeData<QSize>(nodeId, NodeRole::Size);
-
-    unsigned int captionHeight = captionRect(nodeId).height();
-
-    if (auto w = _graphModel.nodeData<QWidget *>(nodeId, NodeRole::Widget)) {
-        // If the widget wants to use as much vertical space as possible,
-        // place it immediately after the caption.
-        if (w->sizePolicy().verticalPolicy() & QSizePolicy::ExpandFlag) {
-            return QPointF(2.0 * _portSpasing + maxPortsTextAdvance(nodeId, PortType::In),
-                           captionHeight);
-        } else {
-            return QPointF(2.0 * _portSpasing + maxPortsTextAdvance(nodeId, PortType::In),
-                           (captionHeight + size.height() - w->height()) / 2.0);
-        }
-    }
-    return QPointF();
+    return layout(nodeId).widgetPosition;
 }
 
 QRect DefaultHorizontalNodeGeometry::resizeHandleRect(NodeId const nodeId) const
@@ -173,67 +115,112 @@ QRect DefaultHorizontalNodeGeometry::resizeHandleRect(NodeId const nodeId) const
     return QRect(size.width() - _portSpasing, size.height() - _portSpasing, rectSize, rectSize);
 }
 
-QRectF DefaultHorizontalNodeGeometry::portTextRect(NodeId const nodeId,
-                                                   PortType const portType,
-                                                   PortIndex const portIndex) const
+void DefaultHorizontalNodeGeometry::invalidate(NodeId const nodeId) const
 {
-    QString s;
-    if (_graphModel.portData<bool>(nodeId, portType, portIndex, PortRole::CaptionVisible)) {
-        s = _graphModel.portData<QString>(nodeId, portType, portIndex, PortRole::Caption);
-    } else {
-        auto portData = _graphModel.portData(nodeId, portType, portIndex, PortRole::DataType);
+    _layouts.erase(nodeId);
+}
 
-        s = portData.value<NodeDataType>().name;
+void DefaultHorizontalNodeGeometry::invalidatePositions(NodeId const nodeId) const
+{
+    const auto it = _layouts.find(nodeId);
+    if (it != _layouts.end()) {
+        it->second.placed = false;
     }
-
-    return _fontMetrics.boundingRect(s);
 }
 
-unsigned int DefaultHorizontalNodeGeometry::maxVerticalPortsExtent(NodeId const nodeId) const
+void DefaultHorizontalNodeGeometry::invalidateAll() const
 {
-    PortCount nInPorts = _graphModel.nodeData<PortCount>(nodeId, NodeRole::InPortCount);
+    updateFontMetrics();
+    _layouts.clear();
+}
 
-    PortCount nOutPorts = _graphModel.nodeData<PortCount>(nodeId, NodeRole::OutPortCount);
+NodeLayout const &DefaultHorizontalNodeGeometry::layout(NodeId const nodeId) const
+{
+    NodeLayout &layout = _layouts[nodeId];
 
-    unsigned int maxNumOfEntries = std::max(nInPorts, nOutPorts);
-    unsigned int step = _portSize + _portSpasing;
+    if (layout.refresh(_graphModel, nodeId, _fontMetrics, _boldFontMetrics)) {
+        place(nodeId, layout);
+    }
 
-    return step * maxNumOfEntries;
+    return layout;
 }
 
-unsigned int DefaultHorizontalNodeGeometry::maxPortsTextAdvance(NodeId const nodeId,
-                                                                PortType const portType) const
+void DefaultHorizontalNodeGeometry::place(NodeId const nodeId, NodeLayout &layout) const
 {
-    unsigned int width = 0;
+    const QSize size = layout.size;
 
-    size_t const n = _graphModel
-                         .nodeData(nodeId,
-                                   (portType == PortType::Out) ? NodeRole::OutPortCount
-                                                               : NodeRole::InPortCount)
-                         .toUInt();
+    unsigned int const step = _portSize + _portSpasing;
 
-    for (PortIndex portIndex = 0ul; portIndex < n; ++portIndex) {
-        QString name;
+    for (PortType const portType : {PortType::In, PortType::Out}) {
+        NodeLayout::Side &side = layout.side(portType);
+
+        const std::size_t n = side.textRects.size();
+        side.positions.resize(n);
+        side.textPositions.resize(n);
+
+        const double firstHeight = layout.captionRect.height() + _portSpasing + step / 2.0;
+        const double x = (portType == PortType::In) ? 0.0 : size.width();
+        side.origin = QPointF(x, firstHeight);
+        side.textOrigin = QPointF((portType == PortType::In) ? _portSpasing
+                                                             : size.width() - _portSpasing,
+                                  firstHeight);
+        side.step = QPointF(0.0, step);
+
+        for (std::size_t portIndex = 0; portIndex < n; ++portIndex) {
+            double totalHeight = 0.0;
+
+            totalHeight += layout.captionRect.height();
+            totalHeight += _portSpasing;
+
+            totalHeight += step * portIndex;
+            totalHeight += step / 2.0;
+
+            QRectF const &textRect = side.textRects[portIndex];
+            const double textY = totalHeight + textRect.height() / 4.0;
+
+            if (portType == PortType::In) {
+                side.positions[portIndex] = QPointF(0.0, totalHeight);
+                side.textPositions[portIndex] = QPointF(_portSpasing, textY);
+            } else {
+                side.positions[portIndex] = QPointF(size.width(), totalHeight);
+                side.textPositions[portIndex] = QPointF(size.width() - _portSpasing
+                                                            - textRect.width(),
+                                                        textY);
+            }
+        }
+    }
 
-        if (_graphModel.portData<bool>(nodeId, portType, portIndex, PortRole::CaptionVisible)) {
-            name = _graphModel.portData<QString>(nodeId, portType, portIndex, PortRole::Caption);
-        } else {
-            NodeDataType portData = _graphModel.portData<NodeDataType>(nodeId,
-                                                                       portType,
-                                                                       portIndex,
-                                                                       PortRole::DataType);
+    layout.captionPosition = QPointF(0.5 * (size.width() - layout.captionRect.width()),
+                                     0.5 * _portSpasing + layout.captionRect.height());
 
-            name = portData.name;
-        }
+    layout.widgetPosition = QPointF();
 
-#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
-        width = std::max(unsigned(_fontMetrics.horizontalAdvance(name)), width);
-#else
-        width = std::max(unsigned(_fontMetrics.width(name)), width);
-#endif
+    unsigned int captionHeight = layout.captionRect.height();
+
+    if (auto w = _graphModel.nodeData<QWidget *>(nodeId, NodeRole::Widget)) {
+        // If the widget wants to use as much vertical space as possible,
+        // place it immediately after the caption.
+        if (w->sizePolicy().verticalPolicy() & QSizePolicy::ExpandFlag) {
+            layout.widgetPosition = QPointF(2.0 * _portSpasing + layout.in.textAdvance,
+                                            captionHeight);
+        } else {
+            layout.widgetPosition = QPointF(2.0 * _portSpasing + layout.in.textAdvance,
+                                            (captionHeight + size.height() - w->height())
+                                                / 2.0);
+        }
     }
+}
+
+unsigned int DefaultHorizontalNodeGeometry::maxVerticalPortsExtent(NodeId const nodeId) const
+{
+    PortCount nInPorts = _graphModel.nodeData<PortCount>(nodeId, NodeRole::InPortCount);
+
+    PortCount nOutPorts = _graphModel.nodeData<PortCount>(nodeId, NodeRole::OutPortCount);
 
-    return width;
+    unsigned int maxNumOfEntries = std::max(nInPorts, nOutPorts);
+    unsigned int step = _portSize + _portSpasing;
+
+    return step * maxNumOfEntries;
 }
 
 } // namespace QtNodes
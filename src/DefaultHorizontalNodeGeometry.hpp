@@ -1,9 +1,12 @@
 #pragma once
 
 #include "AbstractNodeGeometry.hpp"
+#include "NodeLayout.hpp"
 
 #include <QtGui/QFontMetrics>
 
+#include <unordered_map>
+
 namespace QtNodes {
 
 class AbstractGraphModel;
@@ -34,16 +37,25 @@ public:
 
     QRect resizeHandleRect(NodeId const nodeId) const override;
 
+    void invalidate(NodeId const nodeId) const override;
+
+    void invalidatePositions(NodeId const nodeId) const override;
+
+    /// Also picks up a changed application font.
+    void invalidateAll() const override;
+
 private:
-    QRectF portTextRect(NodeId const nodeId,
-                        PortType const portType,
-                        PortIndex const portIndex) const;
+    /// Cached layout of the node, brought up to date with its ports and size.
+    NodeLayout const &layout(NodeId const nodeId) const;
+
+    /// Computes the positions of `layout` for `layout.size`.
+    void place(NodeId const nodeId, NodeLayout &layout) const;
+
+    void updateFontMetrics() const;
 
     /// Finds max number of ports and multiplies by (a port height + interval)
     unsigned int maxVerticalPortsExtent(NodeId const nodeId) const;
 
-    unsigned int maxPortsTextAdvance(NodeId const nodeId, PortType const portType) const;
-
 private:
     // Some variables are mutable because we need to change drawing
     // metrics corresponding to fontMetrics but this doesn't change
@@ -53,6 +65,8 @@ private:
     unsigned int _portSpasing;
     mutable QFontMetrics _fontMetrics;
     mutable QFontMetrics _boldFontMetrics;
+
+    mutable std::unordered_map<NodeId, NodeLayout> _layouts;
 };
 
 } // namespace QtNodes
@@ -29,14 +29,25 @@ void DefaultNodePainter::paint(QPainter *painter, NodeGraphicsObject &ngo) const
     drawResizeRect(painter, ngo);
 }
 
+void DefaultNodePainter::paintLowDetail(QPainter *painter, NodeGraphicsObject &ngo) const
+{
+    const AbstractNodeGeometry &geometry = ngo.nodeScene()->nodeGeometry();
+    const QSize size = geometry.size(ngo.nodeId());
+    const NodeStyle &nodeStyle = ngo.nodeStyle();
+
+    painter->setPen(QPen(ngo.isSelected() ? nodeStyle.SelectedBoundaryColor
+                                          : nodeStyle.NormalBoundaryColor,
+                         nodeStyle.PenWidth));
+    painter->setBrush(nodeStyle.GradientColor1);
+    painter->drawRect(QRectF(0, 0, size.width(), size.height()));
+}
+
 void DefaultNodePainter::drawNodeRect(QPainter *painter, NodeGraphicsObject &ngo) const
 {
-    const AbstractGraphModel &model = ngo.graphModel();
     const NodeId nodeId = ngo.nodeId();
     const AbstractNodeGeometry &geometry = ngo.nodeScene()->nodeGeometry();
     const QSize size = geometry.size(nodeId);
-    const QJsonDocument json = QJsonDocument::fromVariant(model.nodeData(nodeId, NodeRole::Style));
-    const NodeStyle nodeStyle(json.object());
+    const NodeStyle &nodeStyle = ngo.nodeStyle();
     const auto color = ngo.isSelected() ? nodeStyle.SelectedBoundaryColor
                                         : nodeStyle.NormalBoundaryColor;
 
@@ -67,8 +78,7 @@ void DefaultNodePainter::drawConnectionPoints(QPainter *painter, NodeGraphicsObj
     const NodeId nodeId = ngo.nodeId();
     const AbstractNodeGeometry &geometry = ngo.nodeScene()->nodeGeometry();
 
-    const QJsonDocument json = QJsonDocument::fromVariant(model.nodeData(nodeId, NodeRole::Style));
-    const NodeStyle nodeStyle(json.object());
+    const NodeStyle &nodeStyle = ngo.nodeStyle();
 
     const auto &connectionStyle = StyleCollection::connectionStyle();
 
@@ -84,8 +94,6 @@ void DefaultNodePainter::drawConnectionPoints(QPainter *painter, NodeGraphicsObj
 
         for (PortIndex portIndex = 0; portIndex < n; ++portIndex) {
             const QPointF p = geometry.portPosition(nodeId, portType, portIndex);
-            const auto &dataType = model.portData(nodeId, portType, portIndex, PortRole::DataType)
-                                       .value<NodeDataType>();
 
             double r = 1.0;
             const NodeState &state = ngo.nodeState();
@@ -116,7 +124,8 @@ void DefaultNodePainter::drawConnectionPoints(QPainter *painter, NodeGraphicsObj
             }
 
             if (connectionStyle.useDataDefinedColors()) {
-                painter->setBrush(connectionStyle.normalColor(dataType.id));
+                painter->setBrush(
+                    connectionStyle.normalColor(model.portTypeHandle(nodeId, portType, portIndex)));
             } else {
                 painter->setBrush(nodeStyle.ConnectionPointColor);
             }
@@ -135,8 +144,7 @@ void DefaultNodePainter::drawFilledConnectionPoints(QPainter *painter, NodeGraph
     const AbstractGraphModel &model = ngo.graphModel();
     const NodeId nodeId = ngo.nodeId();
     const AbstractNodeGeometry &geometry = ngo.nodeScene()->nodeGeometry();
-    const QJsonDocument json = QJsonDocument::fromVariant(model.nodeData(nodeId, NodeRole::Style));
-    const NodeStyle nodeStyle(json.object());
+    const NodeStyle &nodeStyle = ngo.nodeStyle();
     const auto diameter = nodeStyle.ConnectionPointDiameter;
 
     for (PortType portType : {PortType::Out, PortType::In}) {
@@ -152,13 +160,10 @@ void DefaultNodePainter::drawFilledConnectionPoints(QPainter *painter, NodeGraph
             const auto &connected = model.connections(nodeId, portType, portIndex);
 
             if (!connected.empty()) {
-                const auto &dataType = model
-                                           .portData(nodeId, portType, portIndex, PortRole::DataType)
-                                           .value<NodeDataType>();
-
                 const auto &connectionStyle = StyleCollection::connectionStyle();
                 if (connectionStyle.useDataDefinedColors()) {
-                    const QColor c = connectionStyle.normalColor(dataType.id);
+                    const QColor c = connectionStyle.normalColor(
+                        model.portTypeHandle(nodeId, portType, portIndex));
                     painter->setPen(c);
                     painter->setBrush(c);
                 } else {
@@ -189,8 +194,7 @@ void DefaultNodePainter::drawNodeCaption(QPainter *painter, NodeGraphicsObject &
 
     const QPointF position = geometry.captionPosition(nodeId);
 
-    const QJsonDocument json = QJsonDocument::fromVariant(model.nodeData(nodeId, NodeRole::Style));
-    const NodeStyle nodeStyle(json.object());
+    const NodeStyle &nodeStyle = ngo.nodeStyle();
 
     painter->setFont(f);
     painter->setPen(nodeStyle.FontColor);
@@ -206,8 +210,7 @@ void DefaultNodePainter::drawEntryLabels(QPainter *painter, NodeGraphicsObject &
     const NodeId nodeId = ngo.nodeId();
     const AbstractNodeGeometry &geometry = ngo.nodeScene()->nodeGeometry();
 
-    const QJsonDocument json = QJsonDocument::fromVariant(model.nodeData(nodeId, NodeRole::Style));
-    const NodeStyle nodeStyle(json.object());
+    const NodeStyle &nodeStyle = ngo.nodeStyle();
 
     for (PortType portType : {PortType::Out, PortType::In}) {
         const unsigned int n = model.nodeData<unsigned int>(nodeId,
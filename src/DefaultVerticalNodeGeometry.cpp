@@ -16,6 +16,13 @@ DefaultVerticalNodeGeometry::DefaultVerticalNodeGeometry(AbstractGraphModel &gra
     , _fontMetrics(QFont())
     , _boldFontMetrics(QFont())
 {
+    updateFontMetrics();
+}
+
+void DefaultVerticalNodeGeometry::updateFontMetrics() const
+{
+    _fontMetrics = QFontMetrics(QFont());
+
     QFont f;
     f.setBold(true);
     _boldFontMetrics = QFontMetrics(f);
@@ -30,13 +37,16 @@ QSize DefaultVerticalNodeGeometry::size(NodeId const nodeId) const
 
 void DefaultVerticalNodeGeometry::recomputeSize(NodeId const nodeId) const
 {
+    NodeLayout &layout = _layouts[nodeId];
+    layout.measure(_graphModel, nodeId, _fontMetrics, _boldFontMetrics);
+
     unsigned int height = _portSpasing; // maxHorizontalPortsExtent(nodeId);
 
     if (auto w = _graphModel.nodeData<QWidget *>(nodeId, NodeRole::Widget)) {
         height = std::max(height, static_cast<unsigned int>(w->height()));
     }
 
-    const QRectF capRect = captionRect(nodeId);
+    const QRectF capRect = layout.captionRect;
 
     height += capRect.height();
 
@@ -48,11 +58,11 @@ void DefaultVerticalNodeGeometry::recomputeSize(NodeId const nodeId) const
 
     // Adding double step (top and bottom) to reserve space for port captions.
 
-    height += portCaptionsHeight(nodeId, PortType::In);
-    height += portCaptionsHeight(nodeId, PortType::Out);
+    height += portCaptionsHeight(layout, PortType::In);
+    height += portCaptionsHeight(layout, PortType::Out);
 
-    const unsigned int inPortWidth = maxPortsTextAdvance(nodeId, PortType::In);
-    const unsigned int outPortWidth = maxPortsTextAdvance(nodeId, PortType::Out);
+    const unsigned int inPortWidth = layout.in.textAdvance;
+    const unsigned int outPortWidth = layout.out.textAdvance;
 
     const unsigned int totalInPortsWidth = nInPorts > 0 ? inPortWidth * nInPorts
                                                               + _portSpasing * (nInPorts - 1)
@@ -82,95 +92,37 @@ QPointF DefaultVerticalNodeGeometry::portPosition(NodeId const nodeId,
                                                   PortType const portType,
                                                   PortIndex const portIndex) const
 {
-    QPointF result;
-    const QSize size = _graphModel.nodeData<QSize>(nodeId, NodeRole::Size);
-
-    switch (portType) {
-    case PortType::In: {
-        const unsigned int inPortWidth = maxPortsTextAdvance(nodeId, PortType::In) + _portSpasing;
-        const PortCount nInPorts = _graphModel.nodeData<PortCount>(nodeId, NodeRole::InPortCount);
-        const double x = (size.width() - (nInPorts - 1) * inPortWidth) / 2.0
-                         + portIndex * inPortWidth;
-        constexpr double y = 0.0;
-        result = QPointF(x, y);
-        break;
-    }
-
-    case PortType::Out: {
-        const unsigned int outPortWidth = maxPortsTextAdvance(nodeId, PortType::Out) + _portSpasing;
-        const PortCount nOutPorts = _graphModel.nodeData<PortCount>(nodeId, NodeRole::OutPortCount);
-        const double x = (size.width() - (nOutPorts - 1) * outPortWidth) / 2.0
-                         + portIndex * outPortWidth;
-        const double y = size.height();
-        result = QPointF(x, y);
-        break;
+    if (portType == PortType::None) {
+        return QPointF();
     }
 
-    default:
-        break;
-    }
-
-    return result;
+    return layout(nodeId).side(portType).position(portIndex);
 }
 
 QPointF DefaultVerticalNodeGeometry::portTextPosition(NodeId const nodeId,
                                                       PortType const portType,
                                                       PortIndex const portIndex) const
 {
-    QPointF p = portPosition(nodeId, portType, portIndex);
-    const QRectF rect = portTextRect(nodeId, portType, portIndex);
-    p.setX(p.x() - rect.width() / 2.0);
-    const QSize size = _graphModel.nodeData<QSize>(nodeId, NodeRole::Size);
-
-    switch (portType) {
-    case PortType::In:
-        p.setY(5.0 + rect.height());
-        break;
-
-    case PortType::Out:
-        p.setY(size.height() - 5.0);
-        break;
-
-    default:
-        break;
+    if (portType == PortType::None) {
+        return QPointF();
     }
 
-    return p;
+    return layout(nodeId).side(portType).textPosition(portIndex);
 }
 
 QRectF DefaultVerticalNodeGeometry::captionRect(NodeId const nodeId) const
 {
-    if (!_graphModel.nodeData<bool>(nodeId, NodeRole::CaptionVisible)) {
-        return QRect();
-    }
-    const QString name = _graphModel.nodeData<QString>(nodeId, NodeRole::Caption);
-    return _boldFontMetrics.boundingRect(name);
+    return layout(nodeId).captionRect;
 }
 
 QPointF DefaultVerticalNodeGeometry::captionPosition(NodeId const nodeId) const
 {
-    const QSize size = _graphModel.nodeData<QSize>(nodeId, NodeRole::Size);
-    unsigned int step = portCaptionsHeight(nodeId, PortType::In);
-    step += _portSpasing;
-    const auto rect = captionRect(nodeId);
-    return QPointF(0.5 * (size.width() - rect.width()), step + rect.height());
+    return layout(nodeId).captionPosition;
 }
 
 QPointF DefaultVerticalNodeGeometry::widgetPosition(NodeId const nodeId) const
 {
-    const QSize size = _graphModel.nodeData<QSize>(nodeId, NodeRole::Size);
-    const unsigned int captionHeight = captionRect(nodeId).height();
-    if (auto w = _graphModel.nodeData<QWidget *>(nodeId, NodeRole::Widget)) {
-        // If the widget wants to use as much vertical space as possible,
-        // place it immediately after the caption.
-        if (w->sizePolicy().verticalPolicy() & QSizePolicy::ExpandFlag) {
-            return QPointF(_portSpasing + maxPortsTextAdvance(nodeId, PortType::In), captionHeight);
-        } else {
-            return QPointF(_portSpasing + maxPortsTextAdvance(nodeId, PortType::In),
-                           (captionHeight + size.height() - w->height()) / 2.0);
-        }
-    }
-    return QPointF();
+    return layout(nodeId).widgetPosition;
 }
 
 QRect DefaultVerticalNodeGeometry::resizeHandleRect(NodeId const nodeId) const
@@ -180,97 +132,106 @@ QRect DefaultVerticalNodeGeometry::resizeHandleRect(NodeId const nodeId) const
     return QRect(size.width() - rectSize, size.height() - rectSize, rectSize, rectSize);
 }
 
-QRectF DefaultVerticalNodeGeometry::portTextRect(NodeId const nodeId,
-                                                 PortType const portType,
-                                                 PortIndex const portIndex) const
+void DefaultVerticalNodeGeometry::invalidate(NodeId const nodeId) const
 {
-    QString s;
-    if (_graphModel.portData<bool>(nodeId, portType, portIndex, PortRole::CaptionVisible)) {
-        s = _graphModel.portData<QString>(nodeId, portType, portIndex, PortRole::Caption);
-    } else {
-        const auto portData = _graphModel.portData(nodeId, portType, portIndex, PortRole::DataType);
-        s = portData.value<NodeDataType>().name;
+    _layouts.erase(nodeId);
+}
+
+void DefaultVerticalNodeGeometry::invalidatePositions(NodeId const nodeId) const
+{
+    const auto it = _layouts.find(nodeId);
+    if (it != _layouts.end()) {
+        it->second.placed = false;
     }
+}
 
-    return _fontMetrics.boundingRect(s);
+void DefaultVerticalNodeGeometry::invalidateAll() const
+{
+    updateFontMetrics();
+    _layouts.clear();
 }
 
-unsigned int DefaultVerticalNodeGeometry::maxHorizontalPortsExtent(NodeId const nodeId) const
+NodeLayout const &DefaultVerticalNodeGeometry::layout(NodeId const nodeId) const
 {
-    const PortCount nInPorts = _graphModel.nodeData<PortCount>(nodeId, NodeRole::InPortCount);
-    const PortCount nOutPorts = _graphModel.nodeData<PortCount>(nodeId, NodeRole::OutPortCount);
-    const unsigned int maxNumOfEntries = std::max(nInPorts, nOutPorts);
-    const unsigned int step = _portSize + _portSpasing;
-    return step * maxNumOfEntries;
+    NodeLayout &layout = _layouts[nodeId];
+
+    if (layout.refresh(_graphModel, nodeId, _fontMetrics, _boldFontMetrics)) {
+        place(nodeId, layout);
+    }
+
+    return layout;
 }
 
-unsigned int DefaultVerticalNodeGeometry::maxPortsTextAdvance(NodeId const nodeId,
-                                                              PortType const portType) const
+void DefaultVerticalNodeGeometry::place(NodeId const nodeId, NodeLayout &layout) const
 {
-    unsigned int width = 0;
+    const QSize size = layout.size;
 
-    const size_t n = _graphModel
-                         .nodeData(nodeId,
-                                   (portType == PortType::Out) ? NodeRole::OutPortCount
-                                                               : NodeRole::InPortCount)
-                         .toUInt();
+    for (PortType const portType : {PortType::In, PortType::Out}) {
+        NodeLayout::Side &side = layout.side(portType);
 
-    for (PortIndex portIndex = 0UL; portIndex < n; ++portIndex) {
-        QString name;
+        const PortCount nPorts = static_cast<PortCount>(side.textRects.size());
+        const unsigned int portWidth = side.textAdvance + _portSpasing;
 
-        if (_graphModel.portData<bool>(nodeId, portType, portIndex, PortRole::CaptionVisible)) {
-            name = _graphModel.portData<QString>(nodeId, portType, portIndex, PortRole::Caption);
-        } else {
-            const NodeDataType portData = _graphModel.portData<NodeDataType>(nodeId,
-                                                                             portType,
-                                                                             portIndex,
-                                                                             PortRole::DataType);
-            name = portData.name;
-        }
+        side.positions.resize(side.textRects.size());
+        side.textPositions.resize(side.textRects.size());
 
-#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
-        width = std::max(unsigned(_fontMetrics.horizontalAdvance(name)), width);
-#else
-        width = std::max(unsigned(_fontMetrics.width(name)), width);
-#endif
-    }
+        const double firstX = (size.width() - (nPorts - 1) * portWidth) / 2.0;
+        side.origin = QPointF(firstX, (portType == PortType::In) ? 0.0 : size.height());
+        side.textOrigin = QPointF(firstX,
+                                  (portType == PortType::In) ? 5.0 : size.height() - 5.0);
+        side.step = QPointF(portWidth, 0.0);
 
-    return width;
-}
+        for (PortIndex portIndex = 0; portIndex < nPorts; ++portIndex) {
+            const double x = (size.width() - (nPorts - 1) * portWidth) / 2.0
+                             + portIndex * portWidth;
+            const double y = (portType == PortType::In) ? 0.0 : size.height();
 
-unsigned int DefaultVerticalNodeGeometry::portCaptionsHeight(NodeId const nodeId,
-                                                             PortType const portType) const
-{
-    unsigned int h = 0;
-
-    switch (portType) {
-    case PortType::In: {
-        const PortCount nInPorts = _graphModel.nodeData<PortCount>(nodeId, NodeRole::InPortCount);
-        for (PortIndex i = 0; i < nInPorts; ++i) {
-            if (_graphModel.portData<bool>(nodeId, PortType::In, i, PortRole::CaptionVisible)) {
-                h += _portSpasing;
-                break;
-            }
+            QRectF const &textRect = side.textRects[portIndex];
+            const double textY = (portType == PortType::In) ? 5.0 + textRect.height()
+                                                            : size.height() - 5.0;
+
+            side.positions[portIndex] = QPointF(x, y);
+            side.textPositions[portIndex] = QPointF(x - textRect.width() / 2.0, textY);
         }
-        break;
     }
 
-    case PortType::Out: {
-        const PortCount nOutPorts = _graphModel.nodeData<PortCount>(nodeId, NodeRole::OutPortCount);
-        for (PortIndex i = 0; i < nOutPorts; ++i) {
-            if (_graphModel.portData<bool>(nodeId, PortType::Out, i, PortRole::CaptionVisible)) {
-                h += _portSpasing;
-                break;
-            }
+    unsigned int step = portCaptionsHeight(layout, PortType::In);
+    step += _portSpasing;
+    layout.captionPosition = QPointF(0.5 * (size.width() - layout.captionRect.width()),
+                                     step + layout.captionRect.height());
+
+    layout.widgetPosition = QPointF();
+
+    const unsigned int captionHeight = layout.captionRect.height();
+    if (auto w = _graphModel.nodeData<QWidget *>(nodeId, NodeRole::Widget)) {
+        // If the widget wants to use as much vertical space as possible,
+        // place it immediately after the caption.
+        if (w->sizePolicy().verticalPolicy() & QSizePolicy::ExpandFlag) {
+            layout.widgetPosition = QPointF(_portSpasing + layout.in.textAdvance, captionHeight);
+        } else {
+            layout.widgetPosition = QPointF(_portSpasing + layout.in.textAdvance,
+                                            (captionHeight + size.height() - w->height()) / 2.0);
         }
-        break;
     }
+}
+
+unsigned int DefaultVerticalNodeGeometry::maxHorizontalPortsExtent(NodeId const nodeId) const
+{
+    const PortCount nInPorts = _graphModel.nodeData<PortCount>(nodeId, NodeRole::InPortCount);
+    const PortCount nOutPorts = _graphModel.nodeData<PortCount>(nodeId, NodeRole::OutPortCount);
+    const unsigned int maxNumOfEntries = std::max(nInPorts, nOutPorts);
+    const unsigned int step = _portSize + _portSpasing;
+    return step * maxNumOfEntries;
+}
 
-    default:
-        break;
+unsigned int DefaultVerticalNodeGeometry::portCaptionsHeight(NodeLayout const &layout,
+                                                             PortType const portType) const
+{
+    if (portType == PortType::None) {
+        return 0;
     }
 
-    return h;
+    return layout.side(portType).captionVisible ? _portSpasing : 0;
 }
 
 } // namespace QtNodes
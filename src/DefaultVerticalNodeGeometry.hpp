@@ -1,9 +1,12 @@
 #pragma once
 
 #include "AbstractNodeGeometry.hpp"
+#include "NodeLayout.hpp"
 
 #include <QtGui/QFontMetrics>
 
+#include <unordered_map>
+
 namespace QtNodes {
 
 class AbstractGraphModel;
@@ -35,16 +38,26 @@ public:
 
     QRect resizeHandleRect(NodeId const nodeId) const override;
 
+    void invalidate(NodeId const nodeId) const override;
+
+    void invalidatePositions(NodeId const nodeId) const override;
+
+    /// Also picks up a changed application font.
+    void invalidateAll() const override;
+
 private:
-    QRectF portTextRect(NodeId const nodeId,
-                        PortType const portType,
-                        PortIndex const portIndex) const;
+    /// Cached layout of the node, brought up to date with its ports and size.
+    NodeLayout const &layout(NodeId const nodeId) const;
+
+    /// Computes the positions of `layout` for `layout.size`.
+    void place(NodeId const nodeId, NodeLayout &layout) const;
+
+    void updateFontMetrics() const;
+
     /// Finds
     unsigned int maxHorizontalPortsExtent(NodeId const nodeId) const;
 
-    unsigned int maxPortsTextAdvance(NodeId const nodeId, PortType const portType) const;
-
-    unsigned int portCaptionsHeight(NodeId const nodeId, PortType const portType) const;
+    unsigned int portCaptionsHeight(NodeLayout const &layout, PortType const portType) const;
 
 private:
     // Some variables are mutable because we need to change drawing
@@ -55,6 +68,8 @@ private:
     unsigned int _portSpasing;
     mutable QFontMetrics _fontMetrics;
     mutable QFontMetrics _boldFontMetrics;
+
+    mutable std::unordered_map<NodeId, NodeLayout> _layouts;
 };
 
 } // namespace QtNodes
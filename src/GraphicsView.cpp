@@ -22,9 +22,30 @@
 
 #include <cmath>
 #include <iostream>
+#include <vector>
 
 using QtNodes::BasicGraphicsScene;
 using QtNodes::GraphicsView;
+using QtNodes::GraphicsViewStyle;
+
+namespace {
+
+/// Appends the lines of a grid with `step` which cross `rect`.
+void appendGridLines(QRectF const &rect, double step, std::vector<QLineF> &lines)
+{
+    const double left = std::floor(rect.left() / step) * step;
+    const double top = std::floor(rect.top() / step) * step;
+
+    for (double x = left; x <= rect.right(); x += step) {
+        lines.emplace_back(x, rect.top(), x, rect.bottom());
+    }
+
+    for (double y = top; y <= rect.bottom(); y += step) {
+        lines.emplace_back(rect.left(), y, rect.right(), y);
+    }
+}
+
+} // namespace
 
 GraphicsView::GraphicsView(QWidget *parent)
         : QGraphicsView(parent), _clearSelectionAction(Q_NULLPTR), _deleteSelectionAction(Q_NULLPTR),
@@ -38,8 +59,12 @@ GraphicsView::GraphicsView(QWidget *parent)
     setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
 
     setCacheMode(QGraphicsView::CacheBackground);
+    setBackgroundBrush(palette().color(QPalette::Disabled, QPalette::Base));
     setViewportUpdateMode(QGraphicsView::BoundingRectViewportUpdate);
 
+    connect(this, &GraphicsView::scaleChanged, this, &GraphicsView::updateLevelOfDetail);
+    connect(this, &GraphicsView::scaleChanged, this, &GraphicsView::updateMaterializedItems);
+
     setScaleRange(0.3, 2);
 
     // Sets the scene rect to its maximum possible ranges to avoid autu scene range
@@ -129,6 +154,9 @@ void GraphicsView::setScene(BasicGraphicsScene *scene) {
     auto redoAction = scene->undoStack().createRedoAction(this, tr("&Redo"));
     redoAction->setShortcuts(QKeySequence::Redo);
     addAction(redoAction);
+
+    updateLevelOfDetail();
+    updateMaterializedItems();
 }
 
 void GraphicsView::centerScene() {
@@ -186,6 +214,27 @@ void GraphicsView::setScaleRange(ScaleRange range) {
     setScaleRange(range.minimum, range.maximum);
 }
 
+void GraphicsView::setLowDetailScale(double scale) {
+    _lowDetailScale = std::max(0.0, scale);
+    updateLevelOfDetail();
+}
+
+double GraphicsView::lowDetailScale() const {
+    return _lowDetailScale;
+}
+
+void GraphicsView::updateLevelOfDetail() {
+    if (auto scene = nodeScene()) {
+        scene->setLowDetailMode(getScale() < _lowDetailScale);
+    }
+}
+
+void GraphicsView::updateMaterializedItems() {
+    if (auto scene = nodeScene()) {
+        scene->updateMaterializedItems();
+    }
+}
+
 void GraphicsView::scaleUp() {
     constexpr double step = 1.2;
     const double factor = std::pow(step, 1.0);
@@ -299,42 +348,38 @@ void GraphicsView::mouseMoveEvent(QMouseEvent *event) {
 }
 
 void GraphicsView::drawBackground(QPainter *painter, const QRectF &r) {
-    setBackgroundBrush(palette().color(QPalette::Disabled, QPalette::Base));
     QGraphicsView::drawBackground(painter, r);
 
-    auto drawGrid = [&](double gridStep) {
-        const QRect windowRect = rect();
-        const QPointF tl = mapToScene(windowRect.topLeft());
-        const QPointF br = mapToScene(windowRect.bottomRight());
-
-        const double left = std::floor(tl.x() / gridStep - 0.5);
-        const double right = std::floor(br.x() / gridStep + 1.0);
-        const double bottom = std::floor(tl.y() / gridStep - 0.5);
-        const double top = std::floor(br.y() / gridStep + 1.0);
+    GraphicsViewStyle const &style = QtNodes::StyleCollection::flowViewStyle();
+    const double scale = transform().m11();
 
-        // vertical lines
-        for (int xi = int(left); xi <= int(right); ++xi) {
-            const QLineF line(xi * gridStep, bottom * gridStep, xi * gridStep, top * gridStep);
+    // Only the exposed part is drawn, with one call per grid.
+    std::vector<QLineF> lines;
 
-            painter->drawLine(line);
+    auto drawGrid = [&](double gridStep, QColor const &color) {
+        // Denser lines would only blur into a flat color.
+        if (gridStep <= 0.0 || gridStep * scale < style.MinimumGridSpacing) {
+            return;
         }
 
-        // horizontal lines
-        for (int yi = int(bottom); yi <= int(top); ++yi) {
-            const QLineF line(left * gridStep, yi * gridStep, right * gridStep, yi * gridStep);
-            painter->drawLine(line);
-        }
-    };
+        lines.clear();
+        appendGridLines(r, gridStep, lines);
 
-    const QPen pfine(palette().color(QPalette::Disabled, QPalette::AlternateBase), 1.0);
+        painter->setPen(QPen(color, 1.0));
+        painter->drawLines(lines.data(), static_cast<int>(lines.size()));
+    };
 
-    painter->setPen(pfine);
-    drawGrid(15);
+    drawGrid(style.FineGridStep, palette().color(QPalette::Disabled, QPalette::AlternateBase));
+    drawGrid(style.CoarseGridStep, palette().color(QPalette::Disabled, QPalette::Window));
+}
 
-    const QPen p(palette().color(QPalette::Disabled, QPalette::Window), 1.0);
+void GraphicsView::changeEvent(QEvent *event) {
+    QGraphicsView::changeEvent(event);
 
-    painter->setPen(p);
-    drawGrid(150);
+    // Set here rather than while painting, where it would invalidate the view again.
+    if (event->type() == QEvent::PaletteChange) {
+        setBackgroundBrush(palette().color(QPalette::Disabled, QPalette::Base));
+    }
 }
 
 void GraphicsView::showEvent(QShowEvent *event) {
@@ -342,6 +387,17 @@ void GraphicsView::showEvent(QShowEvent *event) {
     centerScene();
 }
 
+void GraphicsView::resizeEvent(QResizeEvent *event) {
+    QGraphicsView::resizeEvent(event);
+    updateMaterializedItems();
+}
+
+void GraphicsView::scrollContentsBy(int dx, int dy) {
+    QGraphicsView::scrollContentsBy(dx, dy);
+    // Panning moves the scene rect, which ends up here as well.
+    updateMaterializedItems();
+}
+
 BasicGraphicsScene *GraphicsView::nodeScene() {
     return dynamic_cast<BasicGraphicsScene *>(scene());
 }
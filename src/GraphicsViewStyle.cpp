@@ -68,6 +68,19 @@ void GraphicsViewStyle::setStyle(QString jsonText)
         values[#variable] = variable.name(); \
     }
 
+// Missing values keep their defaults, styles written before they existed stay valid.
+#define FLOW_VIEW_STYLE_READ_FLOAT(values, variable) \
+    { \
+        auto valueRef = values[#variable]; \
+        if (valueRef.type() != QJsonValue::Undefined && valueRef.type() != QJsonValue::Null) \
+            variable = valueRef.toDouble(); \
+    }
+
+#define FLOW_VIEW_STYLE_WRITE_FLOAT(values, variable) \
+    { \
+        values[#variable] = variable; \
+    }
+
 void GraphicsViewStyle::loadJson(QJsonObject const &json)
 {
     QJsonValue nodeStyleValues = json["GraphicsViewStyle"];
@@ -77,6 +90,10 @@ void GraphicsViewStyle::loadJson(QJsonObject const &json)
     FLOW_VIEW_STYLE_READ_COLOR(obj, BackgroundColor);
     FLOW_VIEW_STYLE_READ_COLOR(obj, FineGridColor);
     FLOW_VIEW_STYLE_READ_COLOR(obj, CoarseGridColor);
+
+    FLOW_VIEW_STYLE_READ_FLOAT(obj, FineGridStep);
+    FLOW_VIEW_STYLE_READ_FLOAT(obj, CoarseGridStep);
+    FLOW_VIEW_STYLE_READ_FLOAT(obj, MinimumGridSpacing);
 }
 
 QJsonObject GraphicsViewStyle::toJson() const
@@ -87,6 +104,10 @@ QJsonObject GraphicsViewStyle::toJson() const
     FLOW_VIEW_STYLE_WRITE_COLOR(obj, FineGridColor);
     FLOW_VIEW_STYLE_WRITE_COLOR(obj, CoarseGridColor);
 
+    FLOW_VIEW_STYLE_WRITE_FLOAT(obj, FineGridStep);
+    FLOW_VIEW_STYLE_WRITE_FLOAT(obj, CoarseGridStep);
+    FLOW_VIEW_STYLE_WRITE_FLOAT(obj, MinimumGridSpacing);
+
     QJsonObject root;
     root["GraphicsViewStyle"] = obj;
 
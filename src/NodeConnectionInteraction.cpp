@@ -21,45 +21,6 @@ NodeConnectionInteraction::NodeConnectionInteraction(NodeGraphicsObject &ngo,
     , _scene(scene)
 {}
 
-
-bool dfs(AbstractGraphModel &model, NodeId currentNode, NodeId targetNode, std::unordered_map<NodeId, bool>& visited) {
-
-    if (currentNode == targetNode) {
-        // Target node reached, cycle found
-        return true;
-    }
-    if(visited[currentNode]) {
-        return false;
-    }
-    visited[currentNode] = true;
-
-    const PortCount nOutPorts = model.nodeData<PortCount>(currentNode, NodeRole::OutPortCount);
-    for (PortIndex index = 0; index < nOutPorts; ++index) {
-        const auto &outConnectionIds = model.connections(currentNode, PortType::Out, index);
-        for (const auto &connection : outConnectionIds) {
-            const NodeId neighbour = connection.inNodeId;
-            if (!visited[neighbour]) {
-                if (dfs(model, neighbour, targetNode, visited)) {
-                    return true;
-                }
-            }
-        }
-    }
-    return false;
-}
-
-bool NodeConnectionInteraction::introducesCycle(AbstractGraphModel &model, NodeId sourceNode, NodeId targetNode) const {
-    // Mark all nodes as not visited
-    std::unordered_map<NodeId, bool> visited;
-    for (auto& id : model.allNodeIds()) {
-        visited[id] = false;
-    }
-
-    // Perform DFS from the target node
-    return dfs(model, sourceNode, targetNode, visited);
-}
-
-
 bool NodeConnectionInteraction::canConnect(PortIndex *portIndex) const
 {
     // 1. Connection requires a port.
@@ -81,12 +42,12 @@ bool NodeConnectionInteraction::canConnect(PortIndex *portIndex) const
     AbstractGraphModel &model = _ngo.nodeScene()->graphModel();
 
     // 3. Forbid connections that introduce cycles
-    auto srcId = _ngo.nodeId();
-    auto targetId = connectedNodeId;
-    if(_cgo.connectionId().outNodeId == InvalidNodeId) {
-        std::swap(srcId, targetId);
-    }
-    if(introducesCycle(model, srcId, targetId)) {
+
+    const bool draftFromInPort = _cgo.connectionId().outNodeId == InvalidNodeId;
+    const NodeId outNodeId = draftFromInPort ? _ngo.nodeId() : connectedNodeId;
+    const NodeId inNodeId = draftFromInPort ? connectedNodeId : _ngo.nodeId();
+
+    if (model.wouldCreateCycle(outNodeId, inNodeId)) {
         return false;
     }
 
@@ -170,11 +131,16 @@ bool NodeConnectionInteraction::disconnect(PortType portToDisconnect) const
     draftConnection->setEndPoint(portToDisconnect, looseEndPos);
 
     // Repaint connection points.
+    // The far node may be released in a virtualized scene.
     const NodeId connectedNodeId = getNodeId(oppositePort(portToDisconnect), connectionId);
-    _scene.nodeGraphicsObject(connectedNodeId)->update();
+    if (auto ngo = _scene.nodeGraphicsObject(connectedNodeId)) {
+        ngo->update();
+    }
 
     const NodeId disconnectedNodeId = getNodeId(portToDisconnect, connectionId);
-    _scene.nodeGraphicsObject(disconnectedNodeId)->update();
+    if (auto ngo = _scene.nodeGraphicsObject(disconnectedNodeId)) {
+        ngo->update();
+    }
 
     return true;
 }
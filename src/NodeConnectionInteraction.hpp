@@ -64,8 +64,6 @@ private:
     ConnectionGraphicsObject &_cgo;
 
     BasicGraphicsScene &_scene;
-
-    bool introducesCycle(QtNodes::AbstractGraphModel &model, NodeId sourceNode, NodeId targetNode) const;
 };
 
 } // namespace QtNodes
@@ -2,6 +2,7 @@
 
 #include <cstdlib>
 #include <iostream>
+#include <utility>
 
 #include <QtWidgets/QGraphicsEffect>
 #include <QtWidgets/QtWidgets>
@@ -13,11 +14,17 @@
 #include "ConnectionGraphicsObject.hpp"
 #include "ConnectionIdUtils.hpp"
 #include "NodeConnectionInteraction.hpp"
+#include "NodeShadow.hpp"
 #include "StyleCollection.hpp"
+#include "TraceScope.hpp"
 #include "UndoCommands.hpp"
 
 namespace QtNodes {
 
+    namespace {
+        char const *const detachedWidgetProperty = "_qtnodes_detached";
+    }
+
     NodeGraphicsObject::NodeGraphicsObject(BasicGraphicsScene &scene, NodeId nodeId)
             : _nodeId(nodeId), _graphModel(scene.graphModel()), _nodeState(*this), _proxyWidget(nullptr) {
         scene.addItem(this);
@@ -27,32 +34,38 @@ namespace QtNodes {
         setLockedState();
         setCacheMode(QGraphicsItem::DeviceCoordinateCache);
 
-        const QJsonObject nodeStyleJson = _graphModel.nodeData(_nodeId, NodeRole::Style)
-                                              .toJsonObject();
+        const NodeStyle &style = nodeStyle();
 
-        const NodeStyle nodeStyle(nodeStyleJson);
+        updateShadow();
 
-        {
-            auto effect = new QGraphicsDropShadowEffect;
-            effect->setOffset(4, 4);
-            effect->setBlurRadius(20);
-            effect->setColor(nodeStyle.ShadowColor);
-            setGraphicsEffect(effect);
-        }
-
-        setOpacity(nodeStyle.Opacity);
+        setOpacity(style.Opacity);
         setAcceptHoverEvents(true);
         setZValue(0);
-        embedQWidget();
-        nodeScene()->nodeGeometry().recomputeSize(_nodeId);
+        refreshCaption();
+        // Deferred widgets are painted from a snapshot until the node is hovered.
+        if (!scene.deferredWidgetsEnabled()) {
+            embedQWidget();
+        }
+        // Embedding a widget already computed the size.
+        if (!_proxyWidget) {
+            nodeScene()->nodeGeometry().recomputeSize(_nodeId);
+        }
         const QPointF pos = _graphModel.nodeData<QPointF>(_nodeId, NodeRole::Position);
         setPos(pos);
 
-        connect(&_graphModel, &AbstractGraphModel::nodeFlagsUpdated, [this](const NodeId nodeId) {
-            if (_nodeId == nodeId) {
-                setLockedState();
-            }
-        });
+        if (scene.lowDetailMode()) {
+            setLowDetail(true);
+        }
+        scene.updateSpatialIndex(*this);
+
+        connect(&_graphModel,
+                &AbstractGraphModel::nodeFlagsUpdated,
+                this,
+                [this](const NodeId nodeId) {
+                    if (_nodeId == nodeId) {
+                        setLockedState();
+                    }
+                });
     }
 
     AbstractGraphModel &NodeGraphicsObject::graphModel() const {
@@ -65,11 +78,17 @@ namespace QtNodes {
 
     void NodeGraphicsObject::embedQWidget() {
         const AbstractNodeGeometry &geometry = nodeScene()->nodeGeometry();
-        geometry.recomputeSize(_nodeId);
 
         if (auto w = _graphModel.nodeData(_nodeId, NodeRole::Widget).value<QWidget *>()) {
             _proxyWidget = new QGraphicsProxyWidget(this);
             _proxyWidget->setWidget(w);
+
+            // The widget was hidden when a previous object of the node was released.
+            if (w->property(detachedWidgetProperty).toBool()) {
+                w->setProperty(detachedWidgetProperty, QVariant());
+                _proxyWidget->show();
+            }
+
             _proxyWidget->setPreferredWidth(5);
             geometry.recomputeSize(_nodeId);
 
@@ -101,6 +120,13 @@ namespace QtNodes {
 
     QRectF NodeGraphicsObject::boundingRect() const {
         const AbstractNodeGeometry &geometry = nodeScene()->nodeGeometry();
+
+        // A graphics effect grows the painted area by itself, a cached shadow does not.
+        if (nodeScene()->nodeShadowMode() == BasicGraphicsScene::ShadowMode::Cached) {
+            const QRectF nodeRect(QPointF(0, 0), geometry.size(_nodeId));
+            return geometry.boundingRect(_nodeId) | NodeShadow::shadowRect(nodeRect);
+        }
+
         return geometry.boundingRect(_nodeId);
         //return NodeGeometry(_nodeId, _graphModel, nodeScene()).boundingRect();
     }
@@ -109,6 +135,61 @@ namespace QtNodes {
         prepareGeometryChange();
     }
 
+    NodeStyle const &NodeGraphicsObject::nodeStyle() const {
+        const std::uint64_t version = _graphModel.nodeStyleVersion(_nodeId);
+        if (!_nodeStyle || _nodeStyleVersion != version) {
+            _nodeStyle = _graphModel.nodeStyle(_nodeId);
+            _nodeStyleVersion = version;
+        }
+        return *_nodeStyle;
+    }
+
+    void NodeGraphicsObject::invalidateNodeStyle() {
+        _nodeStyle.reset();
+    }
+
+    bool NodeGraphicsObject::refreshCaption() {
+        QString caption = _graphModel.nodeData<QString>(_nodeId, NodeRole::Caption);
+        if (caption == _caption) {
+            return false;
+        }
+
+        _caption = std::move(caption);
+        return true;
+    }
+
+    void NodeGraphicsObject::updateShadow() {
+        const BasicGraphicsScene *scene = nodeScene();
+
+        prepareGeometryChange();
+
+        if (scene->nodeShadowMode() != BasicGraphicsScene::ShadowMode::Effect) {
+            // Deletes the current effect.
+            setGraphicsEffect(nullptr);
+            update();
+            return;
+        }
+
+        if (!graphicsEffect()) {
+            auto effect = new QGraphicsDropShadowEffect;
+            effect->setOffset(4, 4);
+            effect->setBlurRadius(20);
+            effect->setColor(nodeStyle().ShadowColor);
+            effect->setEnabled(!scene->lowDetailMode());
+            setGraphicsEffect(effect);
+        }
+    }
+
+    void NodeGraphicsObject::setLowDetail(bool lowDetail) {
+        if (auto effect = graphicsEffect()) {
+            effect->setEnabled(!lowDetail);
+        }
+        if (_proxyWidget) {
+            _proxyWidget->setVisible(!lowDetail);
+        }
+        update();
+    }
+
     void NodeGraphicsObject::moveConnections() const {
         const auto &connected = _graphModel.allConnectionIds(_nodeId);
 
@@ -118,6 +199,8 @@ namespace QtNodes {
                 cgo->move();
             }
         }
+
+        nodeScene()->moveReleasedConnections(_nodeId);
     }
 
     void NodeGraphicsObject::reactToConnection(ConnectionGraphicsObject const *cgo) {
@@ -125,9 +208,124 @@ namespace QtNodes {
         update();
     }
 
+    void NodeGraphicsObject::detachEmbeddedWidget() {
+        if (!_proxyWidget) {
+            return;
+        }
+
+        if (QWidget *w = _proxyWidget->widget()) {
+            // Hidden first, otherwise it would turn into a visible top-level window.
+            w->hide();
+            _proxyWidget->setWidget(nullptr);
+            w->setProperty(detachedWidgetProperty, true);
+        }
+    }
+
+    void NodeGraphicsObject::activateEmbeddedWidget() {
+        if (!_proxyWidget) {
+            prepareGeometryChange();
+            embedQWidget();
+
+            if (_proxyWidget && nodeScene()->lowDetailMode()) {
+                _proxyWidget->setVisible(false);
+            }
+            nodeScene()->updateSpatialIndex(*this);
+            update();
+        }
+
+        if (_proxyWidget && nodeScene()->deferredWidgetsEnabled()) {
+            scheduleWidgetRelease();
+        }
+    }
+
+    void NodeGraphicsObject::releaseEmbeddedWidget() {
+        if (!_proxyWidget) {
+            return;
+        }
+
+        if (QWidget *w = _proxyWidget->widget()) {
+            _widgetSnapshot = w->grab();
+        }
+
+        detachEmbeddedWidget();
+
+        delete _proxyWidget;
+        _proxyWidget = nullptr;
+
+        if (_widgetReleaseTimer) {
+            _widgetReleaseTimer->stop();
+        }
+
+        update();
+    }
+
+    void NodeGraphicsObject::invalidateWidgetSnapshot() {
+        _widgetSnapshot = QPixmap();
+    }
+
+    void NodeGraphicsObject::scheduleWidgetRelease() {
+        if (!_widgetReleaseTimer) {
+            _widgetReleaseTimer = new QTimer(this);
+            _widgetReleaseTimer->setSingleShot(true);
+            connect(_widgetReleaseTimer, &QTimer::timeout, this, [this]() {
+                if (!nodeScene() || !nodeScene()->deferredWidgetsEnabled()) {
+                    return;
+                }
+
+                if (embeddedWidgetInUse()) {
+                    scheduleWidgetRelease();
+                } else {
+                    releaseEmbeddedWidget();
+                }
+            });
+        }
+
+        _widgetReleaseTimer->start(nodeScene()->widgetReleaseDelay());
+    }
+
+    bool NodeGraphicsObject::embeddedWidgetInUse() const {
+        if (_nodeState.hovered() || !_proxyWidget) {
+            return true;
+        }
+
+        QGraphicsItem const *grabber = scene()->mouseGrabberItem();
+        return _proxyWidget->hasFocus() || grabber == _proxyWidget || grabber == this;
+    }
+
+    void NodeGraphicsObject::paintWidgetSnapshot(QPainter *painter) {
+        QWidget *w = _graphModel.nodeData<QWidget *>(_nodeId, NodeRole::Widget);
+        if (!w) {
+            return;
+        }
+
+        // Rendering works on hidden widgets, so the first snapshot needs no proxy.
+        if (_widgetSnapshot.isNull()) {
+            _widgetSnapshot = w->grab();
+        }
+
+        const AbstractNodeGeometry &geometry = nodeScene()->nodeGeometry();
+        painter->drawPixmap(geometry.widgetPosition(_nodeId), _widgetSnapshot);
+    }
+
     void NodeGraphicsObject::paint(QPainter *painter, QStyleOptionGraphicsItem const *option, QWidget *) {
+        NODE_EDITOR_TRACE_NODE_SCOPE("NodeGraphicsObject::paint", _nodeId);
+
         painter->setClipRect(option->exposedRect);
-        nodeScene()->nodePainter().paint(painter, *this);
+        if (nodeScene()->lowDetailMode()) {
+            nodeScene()->nodePainter().paintLowDetail(painter, *this);
+        } else {
+            if (nodeScene()->nodeShadowMode() == BasicGraphicsScene::ShadowMode::Cached) {
+                const AbstractNodeGeometry &geometry = nodeScene()->nodeGeometry();
+                const QRectF nodeRect(QPointF(0, 0), geometry.size(_nodeId));
+                NodeShadow::paint(painter, nodeRect, nodeStyle().ShadowColor);
+            }
+
+            nodeScene()->nodePainter().paint(painter, *this);
+
+            if (!_proxyWidget) {
+                paintWidgetSnapshot(painter);
+            }
+        }
     }
 
     QVariant NodeGraphicsObject::itemChange(GraphicsItemChange change, const QVariant &value) {
@@ -158,7 +356,7 @@ namespace QtNodes {
                 // Need ConnectionGraphicsObject
 
                 const NodeConnectionInteraction interaction(*this,
-                                                            *nodeScene()->connectionGraphicsObject(
+                                                            *nodeScene()->materializeConnection(
                                                                 cnId),
                                                             *nodeScene());
 
@@ -201,6 +399,11 @@ namespace QtNodes {
         if (isSelected()) {
             Q_EMIT nodeScene()->nodeSelected(_nodeId);
         }
+
+        if (nodeScene()->dragSessionsEnabled() && event->button() == Qt::LeftButton
+            && !_nodeState.resizing()) {
+            nodeScene()->beginDragSession();
+        }
     }
 
     void NodeGraphicsObject::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
@@ -213,6 +416,11 @@ namespace QtNodes {
                 scene()->clearSelection();
             }
             setSelected(true);
+
+            // The session has to move the new selection.
+            if (nodeScene()->dragSessionActive()) {
+                nodeScene()->beginDragSession();
+            }
         }
 
         if (_nodeState.resizing()) {
@@ -225,10 +433,16 @@ namespace QtNodes {
                 const AbstractNodeGeometry &geometry = nodeScene()->nodeGeometry();
                 // Passes the new size to the model.
                 geometry.recomputeSize(_nodeId);
+                nodeScene()->updateSpatialIndex(*this);
                 update();
                 moveConnections();
                 event->accept();
             }
+        } else if (nodeScene()->dragSessionActive()) {
+            // The scene moves the nodes and grows the scene rect once per frame.
+            nodeScene()->updateDragSession(event->scenePos() - event->lastScenePos());
+            event->accept();
+            return;
         } else {
             const auto diff = event->pos() - event->lastPos();
             nodeScene()->undoStack().push(new MoveNodeCommand(nodeScene(), diff));
@@ -241,6 +455,7 @@ namespace QtNodes {
 
     void NodeGraphicsObject::mouseReleaseEvent(QGraphicsSceneMouseEvent *event) {
         _nodeState.setResizing(false);
+        nodeScene()->endDragSession();
         QGraphicsObject::mouseReleaseEvent(event);
         // position connections precisely after fast node move
         moveConnections();
@@ -251,6 +466,9 @@ namespace QtNodes {
     {
         _nodeState.setHovered(true);
         setCursor(Qt::ArrowCursor);
+        if (nodeScene()->deferredWidgetsEnabled()) {
+            activateEmbeddedWidget();
+        }
         update();
         Q_EMIT nodeScene()->nodeHovered(_nodeId, event->screenPos());
         event->accept();
@@ -258,6 +476,9 @@ namespace QtNodes {
 
     void NodeGraphicsObject::hoverLeaveEvent(QGraphicsSceneHoverEvent *event) {
         _nodeState.setHovered(false);
+        if (_proxyWidget && nodeScene()->deferredWidgetsEnabled()) {
+            scheduleWidgetRelease();
+        }
         setZValue(0.0);
         update();
         Q_EMIT nodeScene()->nodeHoverLeft(_nodeId);
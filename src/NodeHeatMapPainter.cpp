@@ -0,0 +1,79 @@
+#include "NodeHeatMapPainter.hpp"
+
+#include "AbstractNodeGeometry.hpp"
+#include "BasicGraphicsScene.hpp"
+#include "DataFlowGraphModel.hpp"
+#include "NodeGraphicsObject.hpp"
+
+#include <algorithm>
+
+namespace QtNodes {
+
+NodeHeatMapPainter::NodeHeatMapPainter(std::unique_ptr<AbstractNodePainter> painter,
+                                       DataFlowGraphModel const &graphModel,
+                                       Metric metric)
+    : _painter(std::move(painter))
+    , _graphModel(graphModel)
+    , _metric(metric)
+{}
+
+void NodeHeatMapPainter::paint(QPainter *painter, NodeGraphicsObject &ngo) const
+{
+    _painter->paint(painter, ngo);
+    drawHeat(painter, ngo);
+}
+
+void NodeHeatMapPainter::paintLowDetail(QPainter *painter, NodeGraphicsObject &ngo) const
+{
+    _painter->paintLowDetail(painter, ngo);
+    drawHeat(painter, ngo);
+}
+
+double NodeHeatMapPainter::heat(NodeId const nodeId) const
+{
+    const NodeProfiler *profiler = _graphModel.profiler();
+    if (!profiler) {
+        return -1.0;
+    }
+
+    const NodeProfile *profile = profiler->profile(nodeId);
+    if (!profile || profile->computeCount == 0) {
+        return -1.0;
+    }
+
+    // Both maxima only grow, so the scale stays stable while the graph runs.
+    const bool cumulative = _metric == Metric::CumulativeComputeTime;
+
+    const auto value = cumulative ? profile->computeTime : profile->lastComputeTime();
+    const auto max = cumulative ? profiler->maxComputeTime() : profiler->maxSingleComputeTime();
+
+    if (max.count() == 0) {
+        return 0.0;
+    }
+
+    return std::min(1.0, static_cast<double>(value.count()) / static_cast<double>(max.count()));
+}
+
+void NodeHeatMapPainter::drawHeat(QPainter *painter, NodeGraphicsObject &ngo) const
+{
+    const double h = heat(ngo.nodeId());
+    if (h < 0.0) {
+        return;
+    }
+
+    const QSize size = ngo.nodeScene()->nodeGeometry().size(ngo.nodeId());
+
+    // Green (hue 120) for cold nodes, red (hue 0) for the hottest one.
+    const QColor color = QColor::fromHsvF((1.0 - h) / 3.0, 0.9, 0.9, 0.35);
+
+    painter->save();
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(color);
+
+    constexpr double radius = 3.0;
+    painter->drawRoundedRect(QRectF(0, 0, size.width(), size.height()), radius, radius);
+
+    painter->restore();
+}
+
+} // namespace QtNodes
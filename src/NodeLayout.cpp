@@ -0,0 +1,91 @@
+#include "NodeLayout.hpp"
+
+#include "AbstractGraphModel.hpp"
+#include "NodeData.hpp"
+
+#include <algorithm>
+
+namespace QtNodes {
+
+namespace {
+
+void measureSide(AbstractGraphModel const &graphModel,
+                 NodeId const nodeId,
+                 PortType const portType,
+                 QFontMetrics const &fontMetrics,
+                 NodeLayout::Side &side)
+{
+    const PortCount n = graphModel.nodeData<PortCount>(nodeId,
+                                                       (portType == PortType::Out)
+                                                           ? NodeRole::OutPortCount
+                                                           : NodeRole::InPortCount);
+
+    side.textRects.clear();
+    side.textRects.reserve(n);
+    side.textAdvance = 0;
+    side.captionVisible = false;
+
+    for (PortIndex portIndex = 0; portIndex < n; ++portIndex) {
+        QString name;
+
+        if (graphModel.portData<bool>(nodeId, portType, portIndex, PortRole::CaptionVisible)) {
+            name = graphModel.portData<QString>(nodeId, portType, portIndex, PortRole::Caption);
+            side.captionVisible = true;
+        } else {
+            name = graphModel
+                       .portData<NodeDataType>(nodeId, portType, portIndex, PortRole::DataType)
+                       .name;
+        }
+
+        side.textRects.push_back(fontMetrics.boundingRect(name));
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+        side.textAdvance = std::max(unsigned(fontMetrics.horizontalAdvance(name)),
+                                    side.textAdvance);
+#else
+        side.textAdvance = std::max(unsigned(fontMetrics.width(name)), side.textAdvance);
+#endif
+    }
+}
+
+} // namespace
+
+void NodeLayout::measure(AbstractGraphModel const &graphModel,
+                         NodeId const nodeId,
+                         QFontMetrics const &fontMetrics,
+                         QFontMetrics const &boldFontMetrics)
+{
+    measureSide(graphModel, nodeId, PortType::In, fontMetrics, in);
+    measureSide(graphModel, nodeId, PortType::Out, fontMetrics, out);
+
+    if (graphModel.nodeData<bool>(nodeId, NodeRole::CaptionVisible)) {
+        captionRect = boldFontMetrics.boundingRect(
+            graphModel.nodeData<QString>(nodeId, NodeRole::Caption));
+    } else {
+        captionRect = QRectF();
+    }
+
+    measured = true;
+    placed = false;
+}
+
+bool NodeLayout::refresh(AbstractGraphModel const &graphModel,
+                         NodeId const nodeId,
+                         QFontMetrics const &fontMetrics,
+                         QFontMetrics const &boldFontMetrics)
+{
+    if (!measured) {
+        measure(graphModel, nodeId, fontMetrics, boldFontMetrics);
+    }
+
+    if (placed) {
+        return false;
+    }
+
+    size = graphModel.nodeData<QSize>(nodeId, NodeRole::Size);
+    placed = true;
+
+    return true;
+}
+
+} // namespace QtNodes
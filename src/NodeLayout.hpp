@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Definitions.hpp"
+
+#include <QtCore/QPointF>
+#include <QtCore/QRectF>
+#include <QtCore/QSize>
+#include <QtGui/QFontMetrics>
+
+#include <cstddef>
+#include <vector>
+
+namespace QtNodes {
+
+class AbstractGraphModel;
+
+/**
+ * Cached placement of a node's caption, ports and widget.
+ *
+ * Text measurements only change with the captions, the ports and the fonts,
+ * they are taken in `measure()`. Positions are derived from them and the
+ * node size, and are recomputed by the geometry when `refresh()` says so.
+ *
+ * The layout does not read the model on lookups. It is dropped by
+ * `AbstractNodeGeometry::invalidate()`, which is called on `nodePortsUpdated`
+ * and by the scene on `nodeUpdated`, and it is re-measured by
+ * `recomputeSize()`. The positions are recomputed after `nodeSizeUpdated`.
+ */
+struct NodeLayout
+{
+    struct Side
+    {
+        std::vector<QRectF> textRects;
+
+        std::vector<QPointF> positions;
+
+        std::vector<QPointF> textPositions;
+
+        /// Horizontal advance of the widest port label.
+        unsigned int textAdvance = 0;
+
+        /// Set if at least one port label is a caption.
+        bool captionVisible = false;
+
+        /// Positions of a port 0 with an empty label.
+        QPointF origin;
+
+        QPointF textOrigin;
+
+        /// Offset between neighbouring ports.
+        QPointF step;
+
+        /// Ports the node does not have, e.g. while a port is being deleted,
+        /// are placed where the next ones would be.
+        QPointF position(PortIndex const portIndex) const
+        {
+            return at(positions, origin, portIndex);
+        }
+
+        QPointF textPosition(PortIndex const portIndex) const
+        {
+            return at(textPositions, textOrigin, portIndex);
+        }
+
+    private:
+        QPointF at(std::vector<QPointF> const &points,
+                   QPointF const &first,
+                   PortIndex const portIndex) const
+        {
+            if (portIndex < 0 || static_cast<std::size_t>(portIndex) >= points.size()) {
+                return first + step * static_cast<double>(portIndex);
+            }
+            return points[static_cast<std::size_t>(portIndex)];
+        }
+    };
+
+    Side in;
+
+    Side out;
+
+    QRectF captionRect;
+
+    QPointF captionPosition;
+
+    QPointF widgetPosition;
+
+    /// Node size the positions were computed for.
+    QSize size;
+
+    bool measured = false;
+
+    bool placed = false;
+
+    Side &side(PortType const portType) { return portType == PortType::Out ? out : in; }
+
+    Side const &side(PortType const portType) const
+    {
+        return portType == PortType::Out ? out : in;
+    }
+
+    void measure(AbstractGraphModel const &graphModel,
+                 NodeId const nodeId,
+                 QFontMetrics const &fontMetrics,
+                 QFontMetrics const &boldFontMetrics);
+
+    /**
+   * Measures the node if it was not measured yet. Returns `true` if the
+   * positions have to be recomputed for the current node size, which is
+   * then stored in `size`.
+   */
+    bool refresh(AbstractGraphModel const &graphModel,
+                 NodeId const nodeId,
+                 QFontMetrics const &fontMetrics,
+                 QFontMetrics const &boldFontMetrics);
+};
+
+} // namespace QtNodes
@@ -0,0 +1,126 @@
+#include "NodeProfiler.hpp"
+
+#include <algorithm>
+
+namespace QtNodes {
+
+NodeProfile::Duration NodeProfile::lastComputeTime() const
+{
+    if (computeCount == 0) {
+        return Duration{};
+    }
+
+    return history[(historyNext + HistorySize - 1) % HistorySize];
+}
+
+NodeProfile::Duration NodeProfile::averageComputeTime() const
+{
+    if (computeCount == 0) {
+        return Duration{};
+    }
+
+    return computeTime / static_cast<Duration::rep>(computeCount);
+}
+
+std::vector<NodeProfile::Duration> NodeProfile::recentComputeTimes() const
+{
+    const std::size_t count = static_cast<std::size_t>(
+        std::min<std::uint64_t>(computeCount, HistorySize));
+    const std::size_t first = (historyNext + HistorySize - count) % HistorySize;
+
+    std::vector<Duration> result;
+    result.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        result.push_back(history[(first + i) % HistorySize]);
+    }
+
+    return result;
+}
+
+NodeProfile const *NodeProfiler::profile(NodeId const nodeId) const
+{
+    const auto it = _profiles.find(nodeId);
+    return it != _profiles.end() ? &it->second : nullptr;
+}
+
+std::vector<NodeId> NodeProfiler::profiledNodes() const
+{
+    std::vector<NodeId> result;
+    result.reserve(_profiles.size());
+
+    for (auto const &p : _profiles) {
+        result.push_back(p.first);
+    }
+
+    std::sort(result.begin(), result.end());
+
+    return result;
+}
+
+void NodeProfiler::reset()
+{
+    _profiles.clear();
+    _inputArrivals.clear();
+    _maxComputeTime = Duration{};
+    _maxSingleComputeTime = Duration{};
+}
+
+void NodeProfiler::recordSetInData(NodeId const nodeId, Duration const duration)
+{
+    NodeProfile &profile = _profiles[nodeId];
+
+    ++profile.setInDataCount;
+    profile.setInDataTime += duration;
+}
+
+void NodeProfiler::recordCompute(NodeId const nodeId, Duration const duration)
+{
+    NodeProfile &profile = _profiles[nodeId];
+
+    ++profile.computeCount;
+    profile.computeTime += duration;
+
+    profile.history[profile.historyNext] = duration;
+    profile.historyNext = (profile.historyNext + 1) % NodeProfile::HistorySize;
+
+    _maxComputeTime = std::max(_maxComputeTime, profile.computeTime);
+    _maxSingleComputeTime = std::max(_maxSingleComputeTime, duration);
+}
+
+void NodeProfiler::recordFanOut(NodeId const nodeId, Duration const duration)
+{
+    NodeProfile &profile = _profiles[nodeId];
+
+    ++profile.fanOutCount;
+    profile.fanOutTime += duration;
+}
+
+void NodeProfiler::recordInputArrival(NodeId const nodeId, Clock::time_point const time)
+{
+    _inputArrivals.emplace(nodeId, time);
+}
+
+void NodeProfiler::recordDataUpdated(NodeId const nodeId, Clock::time_point const time)
+{
+    const auto it = _inputArrivals.find(nodeId);
+    if (it == _inputArrivals.end()) {
+        return;
+    }
+
+    NodeProfile &profile = _profiles[nodeId];
+
+    profile.lastLatency = time - it->second;
+    ++profile.latencyCount;
+    profile.latencyTime += profile.lastLatency;
+
+    _inputArrivals.erase(it);
+}
+
+void NodeProfiler::removeNode(NodeId const nodeId)
+{
+    _profiles.erase(nodeId);
+    _inputArrivals.erase(nodeId);
+}
+
+} // namespace QtNodes
@@ -0,0 +1,150 @@
+#include "NodeShadow.hpp"
+
+#include <QtGui/QImage>
+#include <QtGui/QPainter>
+#include <QtGui/QPixmap>
+#include <QtGui/QPixmapCache>
+#include <QtWidgets/qdrawutil.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace QtNodes {
+
+namespace {
+
+/// Matches the offset of the former QGraphicsDropShadowEffect.
+constexpr double shadowOffset = 4.0;
+
+/// Extent of the blur around the node rect.
+constexpr double blurRadius = 10.0;
+
+/// Corner radius of the rect drawn by DefaultNodePainter.
+constexpr double cornerRadius = 3.0;
+
+/// Logical size of the corner patches.
+constexpr double patchMargin = blurRadius + blurRadius;
+
+/// One horizontal and one vertical box blur pass over a premultiplied image.
+void boxBlur(QImage &image, int radius)
+{
+    const int width = image.width();
+    const int height = image.height();
+    const int window = 2 * radius + 1;
+
+    std::vector<QRgb> line(std::max(width, height));
+
+    auto blurLine = [&](QRgb *first, int count, int stride) {
+        for (int i = 0; i < count; ++i) {
+            line[i] = first[i * stride];
+        }
+
+        int sums[4] = {0, 0, 0, 0};
+        auto add = [&](int index, int sign) {
+            if (index < 0 || index >= count) {
+                return;
+            }
+            const QRgb p = line[index];
+            sums[0] += sign * qAlpha(p);
+            sums[1] += sign * qRed(p);
+            sums[2] += sign * qGreen(p);
+            sums[3] += sign * qBlue(p);
+        };
+
+        for (int i = -radius; i < radius; ++i) {
+            add(i, 1);
+        }
+
+        for (int i = 0; i < count; ++i) {
+            add(i + radius, 1);
+            first[i * stride] = qRgba(sums[1] / window,
+                                      sums[2] / window,
+                                      sums[3] / window,
+                                      sums[0] / window);
+            add(i - radius, -1);
+        }
+    };
+
+    for (int y = 0; y < height; ++y) {
+        blurLine(reinterpret_cast<QRgb *>(image.scanLine(y)), width, 1);
+    }
+
+    const int stride = image.bytesPerLine() / static_cast<int>(sizeof(QRgb));
+    for (int x = 0; x < width; ++x) {
+        blurLine(reinterpret_cast<QRgb *>(image.bits()) + x, height, stride);
+    }
+}
+
+QPixmap ninePatch(QColor const &color, double scale)
+{
+    const QString key = QStringLiteral("qtnodes_shadow_%1_%2")
+                            .arg(color.rgba(), 0, 16)
+                            .arg(scale);
+
+    QPixmap pixmap;
+    if (QPixmapCache::find(key, &pixmap)) {
+        return pixmap;
+    }
+
+    // Corners of `patchMargin` around a single stretchable pixel.
+    const int size = static_cast<int>(std::ceil((2.0 * patchMargin + 1.0) * scale));
+
+    QImage image(size, size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    {
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(color);
+        painter.scale(scale, scale);
+
+        const QRectF body(blurRadius,
+                          blurRadius,
+                          2.0 * (patchMargin - blurRadius) + 1.0,
+                          2.0 * (patchMargin - blurRadius) + 1.0);
+        painter.drawRoundedRect(body, cornerRadius, cornerRadius);
+    }
+
+    // Three box passes come close to a gaussian.
+    const int passRadius = std::max(1, static_cast<int>(std::lround(blurRadius * scale / 3.0)));
+    for (int pass = 0; pass < 3; ++pass) {
+        boxBlur(image, passRadius);
+    }
+
+    pixmap = QPixmap::fromImage(image);
+    pixmap.setDevicePixelRatio(scale);
+
+    QPixmapCache::insert(key, pixmap);
+
+    return pixmap;
+}
+
+} // namespace
+
+QRectF NodeShadow::shadowRect(QRectF const &nodeRect)
+{
+    return nodeRect.translated(shadowOffset, shadowOffset)
+        .adjusted(-blurRadius, -blurRadius, blurRadius, blurRadius);
+}
+
+void NodeShadow::paint(QPainter *painter, QRectF const &nodeRect, QColor const &color)
+{
+    // Includes the view zoom while DeviceCoordinateCache renders the node.
+    const QTransform &transform = painter->worldTransform();
+    const double zoom = std::sqrt(std::abs(transform.determinant()));
+    const double scale = std::min(4.0, std::max(0.25, std::round(zoom * 4.0) / 4.0));
+
+    const QPixmap pixmap = ninePatch(color, scale);
+
+    const QRect target = shadowRect(nodeRect).toAlignedRect();
+
+    // Small nodes would make the corner patches overlap.
+    const int margin = std::min(static_cast<int>(patchMargin),
+                                std::min(target.width(), target.height()) / 2);
+
+    qDrawBorderPixmap(painter, target, QMargins(margin, margin, margin, margin), pixmap);
+}
+
+} // namespace QtNodes
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <QtCore/QRectF>
+#include <QtGui/QColor>
+
+class QPainter;
+
+namespace QtNodes {
+
+/**
+ * Node drop shadow painted from a cached nine-patch pixmap.
+ *
+ * The pixmap holds one blurred rounded rect and is stretched over the node
+ * rect by its borders, so a single pixmap serves nodes of every size. Pixmaps
+ * live in `QPixmapCache`, keyed by the shadow color and the zoom rounded to a
+ * quarter, which keeps the blur sharp on screen without one pixmap per zoom
+ * step.
+ */
+class NodeShadow
+{
+public:
+    /// Area covered by the shadow of a node occupying `nodeRect`.
+    static QRectF shadowRect(QRectF const &nodeRect);
+
+    static void paint(QPainter *painter, QRectF const &nodeRect, QColor const &color);
+};
+
+} // namespace QtNodes
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <QtCore/QPointF>
+#include <QtCore/QRectF>
+#include <QtCore/QtGlobal>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace QtNodes {
+
+/**
+ * Uniform grid over scene coordinates mapping keys to their bounding rects.
+ *
+ * Every key is registered in all the cells its rect overlaps. Moving a key
+ * within the same cell range only rewrites the stored rect, so dragging a
+ * node around costs O(1) most of the time. Queries visit the cells covering
+ * the query rect and report each key once.
+ */
+template<typename Key>
+class SpatialGridIndex
+{
+public:
+    explicit SpatialGridIndex(double cellSize = 256.0)
+        : _cellSize(cellSize)
+    {}
+
+    /// Inserts `key` or moves it to `rect`.
+    void insert(Key const &key, QRectF const &rect)
+    {
+        const CellRange range = cellRange(rect);
+
+        auto it = _entries.find(key);
+        if (it != _entries.end()) {
+            if (it->second.range == range) {
+                it->second.rect = rect;
+                return;
+            }
+
+            unlink(key, it->second.range);
+            it->second = Entry{rect, range};
+        } else {
+            _entries.emplace(key, Entry{rect, range});
+        }
+
+        for (int x = range.left; x <= range.right; ++x) {
+            for (int y = range.top; y <= range.bottom; ++y) {
+                _cells[cellKey(x, y)].push_back(key);
+            }
+        }
+    }
+
+    void remove(Key const &key)
+    {
+        const auto it = _entries.find(key);
+        if (it == _entries.end()) {
+            return;
+        }
+
+        unlink(key, it->second.range);
+        _entries.erase(it);
+    }
+
+    void clear()
+    {
+        _entries.clear();
+        _cells.clear();
+    }
+
+    bool contains(Key const &key) const { return _entries.find(key) != _entries.end(); }
+
+    std::size_t size() const { return _entries.size(); }
+
+    /// @returns keys whose rects intersect `rect`.
+    std::vector<Key> query(QRectF const &rect) const
+    {
+        std::vector<Key> result;
+
+        const CellRange range = cellRange(rect);
+
+        for (int x = range.left; x <= range.right; ++x) {
+            for (int y = range.top; y <= range.bottom; ++y) {
+                const auto cell = _cells.find(cellKey(x, y));
+                if (cell == _cells.end()) {
+                    continue;
+                }
+
+                for (Key const &key : cell->second) {
+                    Entry const &entry = _entries.at(key);
+
+                    // A key spanning several visited cells is reported only from
+                    // the first one of them.
+                    if (x != std::max(range.left, entry.range.left)
+                        || y != std::max(range.top, entry.range.top)) {
+                        continue;
+                    }
+
+                    if (entry.rect.intersects(rect) || rect.contains(entry.rect)) {
+                        result.push_back(key);
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+    /// @returns keys whose rects contain `point`.
+    std::vector<Key> query(QPointF const &point) const
+    {
+        std::vector<Key> result;
+
+        const auto cell = _cells.find(cellKey(cellCoordinate(point.x()), cellCoordinate(point.y())));
+        if (cell == _cells.end()) {
+            return result;
+        }
+
+        for (Key const &key : cell->second) {
+            if (_entries.at(key).rect.contains(point)) {
+                result.push_back(key);
+            }
+        }
+
+        return result;
+    }
+
+private:
+    struct CellRange
+    {
+        int left;
+        int top;
+        int right;
+        int bottom;
+
+        bool operator==(CellRange const &other) const
+        {
+            return left == other.left && top == other.top && right == other.right
+                   && bottom == other.bottom;
+        }
+    };
+
+    struct Entry
+    {
+        QRectF rect;
+        CellRange range;
+    };
+
+    int cellCoordinate(double value) const
+    {
+        constexpr double limit = std::numeric_limits<int>::max() / 2;
+        return static_cast<int>(std::floor(qBound(-limit, value / _cellSize, limit)));
+    }
+
+    CellRange cellRange(QRectF const &rect) const
+    {
+        const QRectF r = rect.normalized();
+        return CellRange{cellCoordinate(r.left()),
+                         cellCoordinate(r.top()),
+                         cellCoordinate(r.right()),
+                         cellCoordinate(r.bottom())};
+    }
+
+    static quint64 cellKey(int x, int y)
+    {
+        return (static_cast<quint64>(static_cast<quint32>(x)) << 32) | static_cast<quint32>(y);
+    }
+
+    void unlink(Key const &key, CellRange const &range)
+    {
+        for (int x = range.left; x <= range.right; ++x) {
+            for (int y = range.top; y <= range.bottom; ++y) {
+                const auto cell = _cells.find(cellKey(x, y));
+                if (cell == _cells.end()) {
+                    continue;
+                }
+
+                auto &keys = cell->second;
+                const auto it = std::find(keys.begin(), keys.end(), key);
+                if (it != keys.end()) {
+                    *it = keys.back();
+                    keys.pop_back();
+                }
+
+                if (keys.empty()) {
+                    _cells.erase(cell);
+                }
+            }
+        }
+    }
+
+private:
+    double _cellSize;
+
+    std::unordered_map<Key, Entry> _entries;
+
+    std::unordered_map<quint64, std::vector<Key>> _cells;
+};
+
+} // namespace QtNodes
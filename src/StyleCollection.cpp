@@ -10,6 +10,20 @@ NodeStyle const &StyleCollection::nodeStyle()
     return instance()._nodeStyle;
 }
 
+std::shared_ptr<NodeStyle const> StyleCollection::nodeStyleHandle()
+{
+    auto &collection = instance();
+    if (!collection._nodeStyleHandle) {
+        collection._nodeStyleHandle = std::make_shared<NodeStyle const>(collection._nodeStyle);
+    }
+    return collection._nodeStyleHandle;
+}
+
+std::uint64_t StyleCollection::nodeStyleVersion()
+{
+    return instance()._nodeStyleVersion;
+}
+
 ConnectionStyle const &StyleCollection::connectionStyle()
 {
     return instance()._connectionStyle;
@@ -22,7 +36,10 @@ GraphicsViewStyle const &StyleCollection::flowViewStyle()
 
 void StyleCollection::setNodeStyle(NodeStyle nodeStyle)
 {
-    instance()._nodeStyle = nodeStyle;
+    auto &collection = instance();
+    collection._nodeStyle = nodeStyle;
+    collection._nodeStyleHandle.reset();
+    ++collection._nodeStyleVersion;
 }
 
 void StyleCollection::setConnectionStyle(ConnectionStyle connectionStyle)
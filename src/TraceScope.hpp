@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Tracing.hpp"
+
+#include <cstdint>
+
+namespace QtNodes {
+
+/// Appends a begin ('B') or end ('E') event, `nodeId` is negative for none.
+void recordTraceEvent(char const *name, char phase, std::int64_t nodeId);
+
+/// Emits the begin event when created and the end event when destroyed.
+class TraceScope
+{
+public:
+    explicit TraceScope(char const *name, std::int64_t nodeId = -1)
+        : _name(name)
+        , _nodeId(nodeId)
+        , _active(Tracing::isActive())
+    {
+        if (_active) {
+            recordTraceEvent(_name, 'B', _nodeId);
+        }
+    }
+
+    ~TraceScope()
+    {
+        if (_active) {
+            recordTraceEvent(_name, 'E', _nodeId);
+        }
+    }
+
+    TraceScope(TraceScope const &) = delete;
+
+    TraceScope &operator=(TraceScope const &) = delete;
+
+private:
+    char const *_name;
+    std::int64_t _nodeId;
+    bool _active;
+};
+
+} // namespace QtNodes
+
+#define NODE_EDITOR_TRACE_CONCAT_IMPL(a, b) a##b
+#define NODE_EDITOR_TRACE_CONCAT(a, b) NODE_EDITOR_TRACE_CONCAT_IMPL(a, b)
+
+#ifdef NODE_EDITOR_TRACING
+#define NODE_EDITOR_TRACE_SCOPE(name) \
+    QtNodes::TraceScope NODE_EDITOR_TRACE_CONCAT(traceScope, __LINE__)(name)
+#define NODE_EDITOR_TRACE_NODE_SCOPE(name, nodeId) \
+    QtNodes::TraceScope NODE_EDITOR_TRACE_CONCAT(traceScope, __LINE__)( \
+        name, static_cast<std::int64_t>(nodeId))
+#else
+#define NODE_EDITOR_TRACE_SCOPE(name) static_cast<void>(0)
+#define NODE_EDITOR_TRACE_NODE_SCOPE(name, nodeId) static_cast<void>(0)
+#endif
@@ -0,0 +1,208 @@
+#include "Tracing.hpp"
+
+#include "TraceScope.hpp"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QThread>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace QtNodes {
+
+namespace {
+
+struct TraceEvent
+{
+    char const *name;
+    char phase;
+    int threadId;
+    std::int64_t nodeId;
+    std::chrono::steady_clock::time_point time;
+};
+
+struct TraceRecorder
+{
+    std::atomic<bool> active{false};
+
+    std::atomic<int> nextThreadId{1};
+
+    std::mutex mutex;
+
+    QString fileName;
+
+    std::chrono::steady_clock::time_point startTime;
+
+    std::vector<TraceEvent> events;
+
+    std::map<int, QString> threadNames;
+};
+
+TraceRecorder &recorder()
+{
+    static TraceRecorder instance;
+    return instance;
+}
+
+/// Small stable id of the calling thread, named in the trace on first use.
+int currentThreadId()
+{
+    thread_local int threadId = 0;
+
+    if (threadId == 0) {
+        TraceRecorder &r = recorder();
+        threadId = r.nextThreadId++;
+
+        QThread *thread = QThread::currentThread();
+
+        QString name = thread->objectName();
+        if (name.isEmpty()) {
+            const bool mainThread = QCoreApplication::instance()
+                                    && thread == QCoreApplication::instance()->thread();
+            name = mainThread ? QStringLiteral("main") : QStringLiteral("thread %1").arg(threadId);
+        }
+
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.threadNames[threadId] = name;
+    }
+
+    return threadId;
+}
+
+QByteArray quoted(QString const &text)
+{
+    // Escaping is left to Qt, the object is `{"":"<text>"}`.
+    const QByteArray json = QJsonDocument(QJsonObject{{QString(), text}})
+                                .toJson(QJsonDocument::Compact);
+    return json.mid(4, json.size() - 5);
+}
+
+} // namespace
+
+void recordTraceEvent(char const *name, char phase, std::int64_t nodeId)
+{
+    const auto time = std::chrono::steady_clock::now();
+    const int threadId = currentThreadId();
+
+    TraceRecorder &r = recorder();
+
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    // `stop()` may have run since the caller checked `isActive()`.
+    if (r.active) {
+        r.events.push_back(TraceEvent{name, phase, threadId, nodeId, time});
+    }
+}
+
+bool Tracing::compiledIn()
+{
+#ifdef NODE_EDITOR_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Tracing::start(QString const &fileName)
+{
+    if (!compiledIn()) {
+        return false;
+    }
+
+    TraceRecorder &r = recorder();
+
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    r.fileName = fileName;
+    r.startTime = std::chrono::steady_clock::now();
+    r.events.clear();
+    r.active = true;
+
+    return true;
+}
+
+bool Tracing::stop()
+{
+    TraceRecorder &r = recorder();
+
+    std::vector<TraceEvent> events;
+    std::map<int, QString> threadNames;
+    QString fileName;
+    std::chrono::steady_clock::time_point startTime;
+
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+
+        if (!r.active) {
+            return false;
+        }
+
+        r.active = false;
+
+        events.swap(r.events);
+        threadNames = r.threadNames;
+        fileName = r.fileName;
+        startTime = r.startTime;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+
+    // Written by hand, a QJsonArray of millions of events would not fit.
+    file.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    bool first = true;
+    auto separate = [&]() {
+        if (!first) {
+            file.write(",\n");
+        }
+        first = false;
+    };
+
+    for (auto const &threadName : threadNames) {
+        separate();
+        file.write("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid
+                   + ",\"tid\":" + QByteArray::number(threadName.first)
+                   + ",\"args\":{\"name\":" + quoted(threadName.second) + "}}");
+    }
+
+    for (TraceEvent const &event : events) {
+        const auto sinceStart = event.time - startTime;
+        const double timestamp = std::chrono::duration<double, std::micro>(sinceStart).count();
+
+        QByteArray line = "{\"name\":\"" + QByteArray(event.name) + "\",\"cat\":\"qtnodes\""
+                          + ",\"ph\":\"" + QByteArray(1, event.phase) + "\""
+                          + ",\"ts\":" + QByteArray::number(timestamp, 'f', 3)
+                          + ",\"pid\":" + pid + ",\"tid\":" + QByteArray::number(event.threadId);
+
+        if (event.nodeId >= 0) {
+            line += ",\"args\":{\"node\":" + QByteArray::number(event.nodeId) + "}";
+        }
+
+        line += "}";
+
+        separate();
+        file.write(line);
+    }
+
+    file.write("\n]}\n");
+
+    return true;
+}
+
+bool Tracing::isActive()
+{
+    return recorder().active.load(std::memory_order_relaxed);
+}
+
+} // namespace QtNodes
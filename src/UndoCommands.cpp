@@ -6,6 +6,7 @@
 #include "Definitions.hpp"
 #include "NodeGraphicsObject.hpp"
 
+#include <QtCore/QHash>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QMimeData>
@@ -13,7 +14,12 @@
 #include <QtWidgets/QApplication>
 #include <QtWidgets/QGraphicsObject>
 
+#include <algorithm>
+#include <iterator>
 #include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 
 namespace QtNodes {
 
@@ -51,64 +57,235 @@ static QJsonObject serializeSelectedItems(BasicGraphicsScene *scene)
     return serializedScene;
 }
 
-static void insertSerializedItems(QJsonObject const &json, BasicGraphicsScene *scene)
+std::shared_ptr<QByteArray const> NodeStatePool::intern(QByteArray const &bytes)
+{
+    if (_buckets.size() >= _pruneThreshold) {
+        prune();
+    }
+
+    auto &bucket = _buckets[qHash(bytes)];
+
+    std::shared_ptr<QByteArray const> result;
+
+    auto it = bucket.begin();
+    while (it != bucket.end()) {
+        auto blob = it->lock();
+        if (!blob) {
+            it = bucket.erase(it);
+            continue;
+        }
+        if (!result && *blob == bytes) {
+            result = std::move(blob);
+        }
+        ++it;
+    }
+
+    if (!result) {
+        result = std::make_shared<QByteArray const>(bytes);
+        bucket.push_back(result);
+    }
+
+    return result;
+}
+
+void NodeStatePool::prune()
+{
+    auto it = _buckets.begin();
+    while (it != _buckets.end()) {
+        auto &bucket = it->second;
+        bucket.erase(std::remove_if(bucket.begin(),
+                                    bucket.end(),
+                                    [](std::weak_ptr<QByteArray const> const &blob) {
+                                        return blob.expired();
+                                    }),
+                     bucket.end());
+
+        it = bucket.empty() ? _buckets.erase(it) : std::next(it);
+    }
+
+    // Amortizes the sweeps over the interns.
+    _pruneThreshold = std::max<std::size_t>(64, 2 * _buckets.size());
+}
+
+namespace {
+
+NodeSnapshot makeSnapshot(QJsonObject const &nodeJson, NodeStatePool &pool)
+{
+    const QJsonObject positionJson = nodeJson["position"].toObject();
+    const QJsonObject internalData = nodeJson["internal-data"].toObject();
+
+    return NodeSnapshot{static_cast<NodeId>(nodeJson["id"].toInt()),
+                        QPointF(positionJson["x"].toDouble(), positionJson["y"].toDouble()),
+                        pool.intern(QJsonDocument(internalData).toJson(QJsonDocument::Compact))};
+}
+
+QJsonObject toJson(NodeSnapshot const &snapshot)
+{
+    QJsonObject positionJson;
+    positionJson["x"] = snapshot.position.x();
+    positionJson["y"] = snapshot.position.y();
+
+    QJsonObject nodeJson;
+    nodeJson["id"] = static_cast<qint64>(snapshot.nodeId);
+    nodeJson["position"] = positionJson;
+    nodeJson["internal-data"] = QJsonDocument::fromJson(*snapshot.state).object();
+
+    return nodeJson;
+}
+
+} // namespace
+
+GraphFragment GraphFragment::capture(AbstractGraphModel const &graphModel,
+                                     NodeStatePool &pool,
+                                     std::vector<NodeId> const &nodeIds,
+                                     std::vector<ConnectionId> connectionIds)
+{
+    GraphFragment fragment;
+
+    fragment._nodes.reserve(nodeIds.size());
+    for (NodeId const nodeId : nodeIds) {
+        fragment._nodes.push_back(makeSnapshot(graphModel.saveNode(nodeId), pool));
+    }
+
+    fragment._connections = std::move(connectionIds);
+    fragment._connections.shrink_to_fit();
+
+    return fragment;
+}
+
+GraphFragment GraphFragment::fromJson(QJsonObject const &sceneJson, NodeStatePool &pool)
+{
+    GraphFragment fragment;
+
+    const QJsonArray nodesJsonArray = sceneJson["nodes"].toArray();
+    fragment._nodes.reserve(nodesJsonArray.size());
+    for (QJsonValue const &node : nodesJsonArray) {
+        fragment._nodes.push_back(makeSnapshot(node.toObject(), pool));
+    }
+
+    const QJsonArray connJsonArray = sceneJson["connections"].toArray();
+    fragment._connections.reserve(connJsonArray.size());
+    for (QJsonValue const &connection : connJsonArray) {
+        fragment._connections.push_back(QtNodes::fromJson(connection.toObject()));
+    }
+
+    return fragment;
+}
+
+void GraphFragment::insert(BasicGraphicsScene *scene) const
 {
     AbstractGraphModel &graphModel = scene->graphModel();
-    QJsonArray const &nodesJsonArray = json["nodes"].toArray();
 
-    for (QJsonValue node : nodesJsonArray) {
-        QJsonObject obj = node.toObject();
-        graphModel.loadNode(obj);
-        const auto id = obj["id"].toInt();
-        scene->nodeGraphicsObject(id)->setZValue(1.0);
-        scene->nodeGraphicsObject(id)->setSelected(true);
+    for (NodeSnapshot const &snapshot : _nodes) {
+        graphModel.loadNode(toJson(snapshot));
+
+        // Selected items stay materialized in a virtualized scene.
+        if (auto ngo = scene->materializeNode(snapshot.nodeId)) {
+            ngo->setZValue(1.0);
+            ngo->setSelected(true);
+        }
+    }
+
+    graphModel.addConnections(_connections);
+
+    for (ConnectionId const &connId : _connections) {
+        if (auto cgo = scene->materializeConnection(connId)) {
+            cgo->setSelected(true);
+        }
     }
+}
 
-    QJsonArray const &connJsonArray = json["connections"].toArray();
+void GraphFragment::remove(AbstractGraphModel &graphModel) const
+{
+    std::unordered_set<NodeId> nodeIds;
+    nodeIds.reserve(_nodes.size());
+    for (NodeSnapshot const &snapshot : _nodes) {
+        nodeIds.insert(snapshot.nodeId);
+    }
 
-    for (QJsonValue connection : connJsonArray) {
-        const QJsonObject connJson = connection.toObject();
-        const ConnectionId connId = fromJson(connJson);
-        // Restore the connection
-        graphModel.addConnection(connId);
-        scene->connectionGraphicsObject(connId)->setSelected(true);
+    // Connections attached to the nodes go away with them.
+    for (ConnectionId const &connId : _connections) {
+        if (nodeIds.count(connId.outNodeId) == 0 && nodeIds.count(connId.inNodeId) == 0) {
+            graphModel.deleteConnection(connId);
+        }
     }
+
+    graphModel.deleteNodes(nodeIds);
 }
 
-static void deleteSerializedItems(QJsonObject &sceneJson, AbstractGraphModel &graphModel)
+void GraphFragment::renumber(AbstractGraphModel &graphModel)
 {
-    QJsonArray connectionJsonArray = sceneJson["connections"].toArray();
+    std::unordered_map<NodeId, NodeId> mapNodeIds;
+
+    for (NodeSnapshot &snapshot : _nodes) {
+        const NodeId newNodeId = graphModel.newNodeId();
+        mapNodeIds[snapshot.nodeId] = newNodeId;
+        snapshot.nodeId = newNodeId;
+    }
+
+    std::vector<ConnectionId> connections;
+    connections.reserve(_connections.size());
 
-    for (QJsonValueRef connection : connectionJsonArray) {
-        const QJsonObject connJson = connection.toObject();
-        const ConnectionId connId = fromJson(connJson);
-        graphModel.deleteConnection(connId);
+    for (ConnectionId const &connId : _connections) {
+        const auto out = mapNodeIds.find(connId.outNodeId);
+        const auto in = mapNodeIds.find(connId.inNodeId);
+        if (out == mapNodeIds.end() || in == mapNodeIds.end()) {
+            continue;
+        }
+
+        connections.push_back(
+            ConnectionId{out->second, connId.outPortIndex, in->second, connId.inPortIndex});
     }
 
-    QJsonArray nodesJsonArray = sceneJson["nodes"].toArray();
+    _connections = std::move(connections);
+}
 
-    for (QJsonValueRef node : nodesJsonArray) {
-        const QJsonObject nodeJson = node.toObject();
-        graphModel.deleteNode(nodeJson["id"].toInt());
+void GraphFragment::offset(QPointF const &diff)
+{
+    for (NodeSnapshot &snapshot : _nodes) {
+        snapshot.position += diff;
     }
 }
 
-static QPointF computeAverageNodePosition(QJsonObject const &sceneJson)
+QPointF GraphFragment::averagePosition() const
 {
     QPointF averagePos(0, 0);
 
-    QJsonArray nodesJsonArray = sceneJson["nodes"].toArray();
+    if (_nodes.empty()) {
+        return averagePos;
+    }
+
+    for (NodeSnapshot const &snapshot : _nodes) {
+        averagePos += snapshot.position;
+    }
+
+    return averagePos / static_cast<double>(_nodes.size());
+}
 
-    for (QJsonValueRef node : nodesJsonArray) {
-        QJsonObject nodeJson = node.toObject();
+std::size_t GraphFragment::memoryCost() const
+{
+    std::size_t cost = sizeof(GraphFragment) + _nodes.capacity() * sizeof(NodeSnapshot)
+                       + _connections.capacity() * sizeof(ConnectionId);
 
-        averagePos += QPointF(nodeJson["position"].toObject()["x"].toDouble(),
-                              nodeJson["position"].toObject()["y"].toDouble());
+    for (NodeSnapshot const &snapshot : _nodes) {
+        cost += static_cast<std::size_t>(snapshot.state->size()) / snapshot.state.use_count();
     }
 
-    averagePos /= static_cast<double>(nodesJsonArray.size());
+    return cost;
+}
 
-    return averagePos;
+void GraphFragment::clear()
+{
+    std::vector<NodeSnapshot>().swap(_nodes);
+    std::vector<ConnectionId>().swap(_connections);
+}
+
+//-------------------------------------
+
+void GraphUndoCommand::releaseState()
+{
+    clearState();
+    setObsolete(true);
 }
 
 //-------------------------------------
@@ -117,7 +294,6 @@ CreateCommand::CreateCommand(BasicGraphicsScene *scene,
                              QString const name,
                              QPointF const &mouseScenePos)
     : _scene(scene)
-    , _sceneJson(QJsonObject())
 {
     _nodeId = _scene->graphModel().addNode(name);
     if (_nodeId != InvalidNodeId) {
@@ -131,25 +307,45 @@ CreateCommand::CreateCommand(BasicGraphicsScene *scene,
 
 void CreateCommand::undo()
 {
-    QJsonArray nodesJsonArray;
-    nodesJsonArray.append(_scene->graphModel().saveNode(_nodeId));
-    _sceneJson["nodes"] = nodesJsonArray;
-    _scene->graphModel().deleteNode(_nodeId);
+    if (isObsolete()) {
+        return;
+    }
+
+    auto &graphModel = _scene->graphModel();
+    const auto connections = graphModel.allConnectionIds(_nodeId);
+
+    _fragment = GraphFragment::capture(graphModel,
+                                       _scene->nodeStatePool(),
+                                       {_nodeId},
+                                       std::vector<ConnectionId>(connections.begin(),
+                                                                 connections.end()));
+    _fragment.remove(graphModel);
 }
 
 void CreateCommand::redo()
 {
-    if (_sceneJson.empty() || _sceneJson["nodes"].toArray().empty()) {
+    if (isObsolete() || _fragment.empty()) {
         return;
     }
 
-    insertSerializedItems(_sceneJson, _scene);
+    _fragment.insert(_scene);
+    _fragment.clear();
 }
 
 NodeId CreateCommand::getNodeId() const {
     return _nodeId;
 }
 
+std::size_t CreateCommand::memoryCost() const
+{
+    return sizeof(CreateCommand) + _fragment.memoryCost();
+}
+
+void CreateCommand::clearState()
+{
+    _fragment.clear();
+}
+
 //-------------------------------------
 
 DeleteCommand::DeleteCommand(BasicGraphicsScene *scene)
@@ -157,73 +353,63 @@ DeleteCommand::DeleteCommand(BasicGraphicsScene *scene)
 {
     auto &graphModel = _scene->graphModel();
 
-    QJsonArray connJsonArray;
+    std::unordered_set<ConnectionId> connections;
     // Delete the selected connections first, ensuring that they won't be
     // automatically deleted when selected nodes are deleted (deleting a
     // node deletes some connections as well)
     for (QGraphicsItem *item : _scene->selectedItems()) {
         if (auto c = qgraphicsitem_cast<ConnectionGraphicsObject *>(item)) {
-            auto const &cid = c->connectionId();
-            connJsonArray.append(toJson(cid));
+            connections.insert(c->connectionId());
         }
     }
 
-    QJsonArray nodesJsonArray;
-    // Delete the nodes; this will delete many of the connections.
-    // Selected connections were already deleted prior to this loop,
-    for (QGraphicsItem *item : _scene->selectedItems()) {
-        if (auto n = qgraphicsitem_cast<NodeGraphicsObject *>(item)) {
-            // saving connections attached to the selected nodes
-            for (auto const &cid : graphModel.allConnectionIds(n->nodeId())) {
-                connJsonArray.append(toJson(cid));
-            }
+    const auto nodeIds = _scene->selectedNodeIds();
 
-            nodesJsonArray.append(graphModel.saveNode(n->nodeId()));
+    // Saving connections attached to the selected nodes; deleting the nodes
+    // removes them implicitly.
+    for (NodeId const nodeId : *nodeIds) {
+        for (auto const &cid : graphModel.allConnectionIds(nodeId)) {
+            connections.insert(cid);
         }
     }
 
     // If nothing is deleted, cancel this operation
-    if (connJsonArray.isEmpty() && nodesJsonArray.isEmpty())
+    if (connections.empty() && nodeIds->empty())
         setObsolete(true);
 
-    _sceneJson["nodes"] = nodesJsonArray;
-    _sceneJson["connections"] = connJsonArray;
+    _fragment = GraphFragment::capture(graphModel,
+                                       _scene->nodeStatePool(),
+                                       *nodeIds,
+                                       std::vector<ConnectionId>(connections.begin(),
+                                                                 connections.end()));
 }
 
 void DeleteCommand::undo()
 {
-    insertSerializedItems(_sceneJson, _scene);
+    if (isObsolete()) {
+        return;
+    }
+
+    _fragment.insert(_scene);
 }
 
 void DeleteCommand::redo()
 {
-    deleteSerializedItems(_sceneJson, _scene->graphModel());
-}
+    if (isObsolete()) {
+        return;
+    }
 
-//-------------------------------------
+    _fragment.remove(_scene->graphModel());
+}
 
-void offsetNodeGroup(QJsonObject &sceneJson, QPointF const &diff)
+std::size_t DeleteCommand::memoryCost() const
 {
-    QJsonArray nodesJsonArray = sceneJson["nodes"].toArray();
-
-    QJsonArray newNodesJsonArray;
-    for (QJsonValueRef node : nodesJsonArray) {
-        QJsonObject obj = node.toObject();
-
-        QPointF oldPos(obj["position"].toObject()["x"].toDouble(),
-                       obj["position"].toObject()["y"].toDouble());
-
-        oldPos += diff;
-
-        QJsonObject posJson;
-        posJson["x"] = oldPos.x();
-        posJson["y"] = oldPos.y();
-        obj["position"] = posJson;
-
-        newNodesJsonArray.append(obj);
-    }
+    return sizeof(DeleteCommand) + _fragment.memoryCost();
+}
 
-    sceneJson["nodes"] = newNodesJsonArray;
+void DeleteCommand::clearState()
+{
+    _fragment.clear();
 }
 
 //-------------------------------------
@@ -257,50 +443,64 @@ CopyCommand::CopyCommand(BasicGraphicsScene *scene)
 
 PasteCommand::PasteCommand(BasicGraphicsScene *scene, QPointF const &mouseScenePos)
     : _scene(scene)
-    , _mouseScenePos(mouseScenePos)
 {
-    _newSceneJson = takeSceneJsonFromClipboard();
+    _fragment = GraphFragment::fromJson(takeSceneJsonFromClipboard(), _scene->nodeStatePool());
 
-    if (_newSceneJson.empty() || _newSceneJson["nodes"].toArray().empty()) {
+    if (_fragment.empty()) {
         setObsolete(true);
         return;
     }
 
-    _newSceneJson = makeNewNodeIdsInScene(_newSceneJson);
+    _fragment.renumber(_scene->graphModel());
 
-    QPointF averagePos = computeAverageNodePosition(_newSceneJson);
-
-    offsetNodeGroup(_newSceneJson, _mouseScenePos - averagePos);
+    _fragment.offset(mouseScenePos - _fragment.averagePosition());
 }
 
 void PasteCommand::undo()
 {
-    deleteSerializedItems(_newSceneJson, _scene->graphModel());
+    if (isObsolete()) {
+        return;
+    }
+
+    _fragment.remove(_scene->graphModel());
 }
 
 void PasteCommand::redo()
 {
+    if (isObsolete()) {
+        return;
+    }
+
     _scene->clearSelection();
 
     // Ignore if pasted in content does not generate nodes.
     try {
-        insertSerializedItems(_newSceneJson, _scene);
+        _fragment.insert(_scene);
     } catch (...) {
         // If the paste does not work, delete all selected nodes and connections
         // `deleteNode(...)` implicitly removed connections
         auto &graphModel = _scene->graphModel();
 
-        QJsonArray nodesJsonArray;
         for (QGraphicsItem *item : _scene->selectedItems()) {
             if (auto n = qgraphicsitem_cast<NodeGraphicsObject *>(item)) {
                 graphModel.deleteNode(n->nodeId());
             }
         }
 
-        setObsolete(true);
+        releaseState();
     }
 }
 
+std::size_t PasteCommand::memoryCost() const
+{
+    return sizeof(PasteCommand) + _fragment.memoryCost();
+}
+
+void PasteCommand::clearState()
+{
+    _fragment.clear();
+}
+
 QJsonObject PasteCommand::takeSceneJsonFromClipboard()
 {
     QClipboard const *clipboard = QApplication::clipboard();
@@ -316,54 +516,6 @@ QJsonObject PasteCommand::takeSceneJsonFromClipboard()
     return json.object();
 }
 
-QJsonObject PasteCommand::makeNewNodeIdsInScene(QJsonObject const &sceneJson)
-{
-    AbstractGraphModel &graphModel = _scene->graphModel();
-
-    std::unordered_map<NodeId, NodeId> mapNodeIds;
-
-    QJsonArray nodesJsonArray = sceneJson["nodes"].toArray();
-
-    QJsonArray newNodesJsonArray;
-    for (QJsonValueRef node : nodesJsonArray) {
-        QJsonObject nodeJson = node.toObject();
-
-        NodeId oldNodeId = nodeJson["id"].toInt();
-
-        NodeId newNodeId = graphModel.newNodeId();
-
-        mapNodeIds[oldNodeId] = newNodeId;
-
-        // Replace NodeId in json
-        nodeJson["id"] = static_cast<qint64>(newNodeId);
-
-        newNodesJsonArray.append(nodeJson);
-    }
-
-    QJsonArray connectionJsonArray = sceneJson["connections"].toArray();
-
-    QJsonArray newConnJsonArray;
-    for (QJsonValueRef connection : connectionJsonArray) {
-        QJsonObject connJson = connection.toObject();
-
-        ConnectionId connId = fromJson(connJson);
-
-        ConnectionId newConnId{mapNodeIds[connId.outNodeId],
-                               connId.outPortIndex,
-                               mapNodeIds[connId.inNodeId],
-                               connId.inPortIndex};
-
-        newConnJsonArray.append(toJson(newConnId));
-    }
-
-    QJsonObject newSceneJson;
-
-    newSceneJson["nodes"] = newNodesJsonArray;
-    newSceneJson["connections"] = newConnJsonArray;
-
-    return newSceneJson;
-}
-
 //-------------------------------------
 
 DisconnectCommand::DisconnectCommand(BasicGraphicsScene *scene, ConnectionId const connId)
@@ -375,12 +527,21 @@ DisconnectCommand::DisconnectCommand(BasicGraphicsScene *scene, ConnectionId con
 
 void DisconnectCommand::undo()
 {
-    _scene->graphModel().addConnection(_connId);
+    if (!isObsolete()) {
+        _scene->graphModel().addConnection(_connId);
+    }
 }
 
 void DisconnectCommand::redo()
 {
-    _scene->graphModel().deleteConnection(_connId);
+    if (!isObsolete()) {
+        _scene->graphModel().deleteConnection(_connId);
+    }
+}
+
+std::size_t DisconnectCommand::memoryCost() const
+{
+    return sizeof(DisconnectCommand);
 }
 
 //------
@@ -394,47 +555,70 @@ ConnectCommand::ConnectCommand(BasicGraphicsScene *scene, ConnectionId const con
 
 void ConnectCommand::undo()
 {
-    _scene->graphModel().deleteConnection(_connId);
+    if (!isObsolete()) {
+        _scene->graphModel().deleteConnection(_connId);
+    }
 }
 
 void ConnectCommand::redo()
 {
-    _scene->graphModel().addConnection(_connId);
+    if (!isObsolete()) {
+        _scene->graphModel().addConnection(_connId);
+    }
+}
+
+std::size_t ConnectCommand::memoryCost() const
+{
+    return sizeof(ConnectCommand);
 }
 
 //------
 
 MoveNodeCommand::MoveNodeCommand(BasicGraphicsScene *scene, QPointF const &diff)
     : _scene(scene)
+    , _nodeIds(scene->selectedNodeIds())
     , _diff(diff)
-{
-    _selectedNodes.clear();
-    for (QGraphicsItem *item : _scene->selectedItems()) {
-        if (auto n = qgraphicsitem_cast<NodeGraphicsObject *>(item)) {
-            _selectedNodes.insert(n->nodeId());
-        }
-    }
-}
+    , _applied(false)
+{}
+
+MoveNodeCommand::MoveNodeCommand(BasicGraphicsScene *scene,
+                                 std::shared_ptr<std::vector<NodeId> const> nodeIds,
+                                 QPointF const &diff)
+    : _scene(scene)
+    , _nodeIds(std::move(nodeIds))
+    , _diff(diff)
+    , _applied(true)
+{}
 
 void MoveNodeCommand::undo()
 {
-    for (auto nodeId : _selectedNodes) {
-        auto oldPos = _scene->graphModel().nodeData(nodeId, NodeRole::Position).value<QPointF>();
-
-        oldPos -= _diff;
+    translate(-_diff);
+}
 
-        _scene->graphModel().setNodeData(nodeId, NodeRole::Position, oldPos);
+void MoveNodeCommand::redo()
+{
+    if (_applied) {
+        _applied = false;
+        return;
     }
+
+    translate(_diff);
 }
 
-void MoveNodeCommand::redo()
+void MoveNodeCommand::translate(QPointF const &diff)
 {
-    for (auto nodeId : _selectedNodes) {
-        auto oldPos = _scene->graphModel().nodeData(nodeId, NodeRole::Position).value<QPointF>();
+    if (!_nodeIds) {
+        return;
+    }
 
-        oldPos += _diff;
+    auto &graphModel = _scene->graphModel();
 
-        _scene->graphModel().setNodeData(nodeId, NodeRole::Position, oldPos);
+    for (NodeId const nodeId : *_nodeIds) {
+        auto pos = graphModel.nodeData(nodeId, NodeRole::Position).value<QPointF>();
+
+        pos += diff;
+
+        graphModel.setNodeData(nodeId, NodeRole::Position, pos);
     }
 }
 
@@ -447,11 +631,30 @@ bool MoveNodeCommand::mergeWith(QUndoCommand const *c)
 {
     auto mc = static_cast<MoveNodeCommand const *>(c);
 
-    if (_selectedNodes == mc->_selectedNodes) {
+    if (!_nodeIds || !mc->_nodeIds) {
+        return false;
+    }
+
+    // Commands of one drag share the id set, the comparison is the fallback.
+    if (_nodeIds == mc->_nodeIds || *_nodeIds == *mc->_nodeIds) {
         _diff += mc->_diff;
         return true;
     }
     return false;
 }
 
+std::size_t MoveNodeCommand::memoryCost() const
+{
+    std::size_t cost = sizeof(MoveNodeCommand);
+    if (_nodeIds) {
+        cost += _nodeIds->capacity() * sizeof(NodeId) / _nodeIds.use_count();
+    }
+    return cost;
+}
+
+void MoveNodeCommand::clearState()
+{
+    _nodeIds.reset();
+}
+
 } // namespace QtNodes
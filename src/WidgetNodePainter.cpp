@@ -29,13 +29,19 @@ void QtNodes::WidgetNodePainter::paint(QPainter *painter, NodeGraphicsObject &ng
     drawResizeRect(painter, ngo);
 }
 
+void QtNodes::WidgetNodePainter::paintLowDetail(QPainter *painter, NodeGraphicsObject &ngo) const {
+    const AbstractNodeGeometry &geometry = ngo.nodeScene()->nodeGeometry();
+    const QSize size = geometry.size(ngo.nodeId());
+    painter->setPen(QPen(ngo.isSelected() ? QColor(255, 255, 255) : QColor(0, 0, 0), 0));
+    painter->setBrush(QApplication::palette().color(QPalette::AlternateBase));
+    painter->drawRect(QRectF(0, 0, size.width(), size.height()));
+}
+
 void QtNodes::WidgetNodePainter::drawNodeBackground(QPainter *painter, NodeGraphicsObject &ngo) const {
-    const AbstractGraphModel &model = ngo.graphModel();
     const NodeId nodeId = ngo.nodeId();
     const AbstractNodeGeometry &geometry = ngo.nodeScene()->nodeGeometry();
     const QSize size = geometry.size(nodeId);
-    const QJsonDocument json = QJsonDocument::fromVariant(model.nodeData(nodeId, NodeRole::Style));
-    const NodeStyle nodeStyle(json.object());
+    const NodeStyle &nodeStyle = ngo.nodeStyle();
     const QPen p(nodeStyle.NormalBoundaryColor, 0);
     painter->setPen(p);
 
@@ -72,8 +78,7 @@ void QtNodes::WidgetNodePainter::drawConnectionPoints(QPainter *painter, NodeGra
     const AbstractGraphModel &model = ngo.graphModel();
     const NodeId nodeId = ngo.nodeId();
     const AbstractNodeGeometry &geometry = ngo.nodeScene()->nodeGeometry();
-    const QJsonDocument json = QJsonDocument::fromVariant(model.nodeData(nodeId, NodeRole::Style));
-    const NodeStyle nodeStyle(json.object());
+    const NodeStyle &nodeStyle = ngo.nodeStyle();
     const float diameter = nodeStyle.ConnectionPointDiameter;
     const auto reducedDiameter = diameter * 0.6;
 
@@ -129,8 +134,7 @@ void QtNodes::WidgetNodePainter::drawFilledConnectionPoints(QPainter *painter, N
     const AbstractGraphModel &model = ngo.graphModel();
     const NodeId nodeId = ngo.nodeId();
     const AbstractNodeGeometry &geometry = ngo.nodeScene()->nodeGeometry();
-    const QJsonDocument json = QJsonDocument::fromVariant(model.nodeData(nodeId, NodeRole::Style));
-    const NodeStyle nodeStyle(json.object());
+    const NodeStyle &nodeStyle = ngo.nodeStyle();
     const auto diameter = nodeStyle.ConnectionPointDiameter;
 
     for (PortType portType: {PortType::Out, PortType::In}) {
@@ -175,8 +179,7 @@ void QtNodes::WidgetNodePainter::drawNodeCaption(QPainter *painter, NodeGraphics
     position.setX(10);
     position.setY(16);
 
-    const QJsonDocument json = QJsonDocument::fromVariant(model.nodeData(nodeId, NodeRole::Style));
-    const NodeStyle nodeStyle(json.object());
+    const NodeStyle &nodeStyle = ngo.nodeStyle();
     const QSize size = geometry.size(nodeId);
     const QRectF boundary(0, 0, size.width(), 22);
     const QColor captionCol = NodeColors::getColor(
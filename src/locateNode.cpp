@@ -5,6 +5,7 @@
 #include <QtCore/QList>
 #include <QtWidgets/QGraphicsScene>
 
+#include "BasicGraphicsScene.hpp"
 #include "NodeGraphicsObject.hpp"
 
 namespace QtNodes {
@@ -13,6 +14,13 @@ NodeGraphicsObject *locateNodeAt(QPointF scenePoint,
                                  QGraphicsScene &scene,
                                  QTransform const &viewTransform)
 {
+    // Spatial index avoids scanning every scene item.
+    if (auto nodeScene = qobject_cast<BasicGraphicsScene *>(&scene)) {
+        if (nodeScene->spatialIndexEnabled()) {
+            return nodeScene->nodeGraphicsObjectAt(scenePoint);
+        }
+    }
+
     // items under cursor
     const QList<QGraphicsItem *> items = scene.items(scenePoint,
                                                      Qt::IntersectsItemShape,
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <QtNodes/NodeDelegateModel>
+#include <QtNodes/NodeDelegateModelRegistry>
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+class ValueData : public QtNodes::NodeData
+{
+public:
+    explicit ValueData(int value = 0, bool hashable = true)
+        : _value(value)
+        , _hashable(hashable)
+    {}
+
+    QtNodes::NodeDataType type() const override { return {"value", "Value", {}}; }
+
+    bool empty() const override { return false; }
+
+    std::optional<std::size_t> contentHash() const override
+    {
+        return _hashable ? std::optional<std::size_t>(std::hash<int>{}(_value)) : std::nullopt;
+    }
+
+    int value() const { return _value; }
+
+private:
+    int _value;
+
+    bool _hashable;
+};
+
+/// One input and one output of the same type. Non-empty inputs are
+/// forwarded from `setInData`, so connected graphs, cycles included, stay
+/// quiet until `emitValue()` is called.
+class PassModel : public QtNodes::NodeDelegateModel
+{
+public:
+    static QString Name() { return "Pass"; }
+
+    QString caption() const override { return Name(); }
+
+    QString name() const override { return Name(); }
+
+    std::size_t nPorts(QtNodes::PortType) const override { return 1; }
+
+    QtNodes::NodeDataType dataType(QtNodes::PortType, QtNodes::PortIndex) const override
+    {
+        return ValueData().type();
+    }
+
+    void setInData(std::shared_ptr<QtNodes::NodeData> nodeData, QtNodes::PortIndex const) override
+    {
+        _data = std::move(nodeData);
+        if (_data) {
+            Q_EMIT dataUpdated(0);
+        }
+    }
+
+    std::shared_ptr<QtNodes::NodeData> outData(QtNodes::PortIndex const) override { return _data; }
+
+    QWidget *embeddedWidget() override { return nullptr; }
+
+    void emitValue(int value = 0) { emitData(std::make_shared<ValueData>(value)); }
+
+    void emitData(std::shared_ptr<QtNodes::NodeData> nodeData)
+    {
+        _data = std::move(nodeData);
+        Q_EMIT dataUpdated(0);
+    }
+
+private:
+    std::shared_ptr<QtNodes::NodeData> _data;
+};
+
+/// A `PassModel` whose input ports are inserted and deleted at run time.
+class PortsModel : public PassModel
+{
+public:
+    static QString Name() { return "Ports"; }
+
+    QString caption() const override { return Name(); }
+
+    QString name() const override { return Name(); }
+
+    std::size_t nPorts(QtNodes::PortType portType) const override
+    {
+        return portType == QtNodes::PortType::In ? _inPorts : 1;
+    }
+
+    void insertInPort(QtNodes::PortIndex const portIndex)
+    {
+        portsAboutToBeInserted(QtNodes::PortType::In, portIndex, portIndex);
+        ++_inPorts;
+        portsInserted();
+    }
+
+    void deleteInPort(QtNodes::PortIndex const portIndex)
+    {
+        portsAboutToBeDeleted(QtNodes::PortType::In, portIndex, portIndex);
+        --_inPorts;
+        portsDeleted();
+    }
+
+private:
+    std::size_t _inPorts = 1;
+};
+
+/// One input, records the values it receives.
+class SinkModel : public QtNodes::NodeDelegateModel
+{
+public:
+    static QString Name() { return "Sink"; }
+
+    QString caption() const override { return Name(); }
+
+    QString name() const override { return Name(); }
+
+    std::size_t nPorts(QtNodes::PortType portType) const override
+    {
+        return portType == QtNodes::PortType::In ? 1 : 0;
+    }
+
+    QtNodes::NodeDataType dataType(QtNodes::PortType, QtNodes::PortIndex) const override
+    {
+        return ValueData().type();
+    }
+
+    void setInData(std::shared_ptr<QtNodes::NodeData> nodeData, QtNodes::PortIndex const) override
+    {
+        ++received;
+        if (auto valueData = std::dynamic_pointer_cast<ValueData>(nodeData)) {
+            values.push_back(valueData->value());
+        }
+    }
+
+    std::shared_ptr<QtNodes::NodeData> outData(QtNodes::PortIndex const) override
+    {
+        return nullptr;
+    }
+
+    QWidget *embeddedWidget() override { return nullptr; }
+
+    /// The last value received, -1 before the first one.
+    int value() const { return values.empty() ? -1 : values.back(); }
+
+    /// Every delivery, empty data included.
+    int received = 0;
+
+    std::vector<int> values;
+};
+
+inline std::shared_ptr<QtNodes::NodeDelegateModelRegistry> makeRegistry()
+{
+    auto registry = std::make_shared<QtNodes::NodeDelegateModelRegistry>();
+    registry->registerModel<PassModel>([](auto const &) { return std::make_unique<PassModel>(); });
+    registry->registerModel<PortsModel>(
+        [](auto const &) { return std::make_unique<PortsModel>(); });
+    registry->registerModel<SinkModel>([](auto const &) { return std::make_unique<SinkModel>(); });
+    return registry;
+}
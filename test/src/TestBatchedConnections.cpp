@@ -0,0 +1,98 @@
+#include "ApplicationSetup.hpp"
+#include "PassNodeModel.hpp"
+
+#include <QtNodes/DataFlowGraphModel>
+#include <QtNodes/DataFlowGraphicsScene>
+#include <QtNodes/NodeDelegateModelRegistry>
+#include <QtNodes/internal/ConnectionGraphicsObject.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <QtCore/QCoreApplication>
+
+#include <memory>
+
+using QtNodes::ConnectionGraphicsObject;
+using QtNodes::ConnectionId;
+using QtNodes::DataFlowGraphicsScene;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::NodeId;
+using QtNodes::NodeRole;
+
+TEST_CASE("Batched connections", "[gui]")
+{
+    auto app = applicationSetup();
+
+    DataFlowGraphModel model(makeRegistry());
+
+    const NodeId first = model.addNode(PassModel::Name());
+    const NodeId second = model.addNode(PassModel::Name());
+    model.setNodeData(second, NodeRole::Position, QPointF(400, 0));
+
+    const ConnectionId connectionId{first, 0, second, 0};
+    model.addConnection(connectionId);
+
+    DataFlowGraphicsScene scene(model);
+    REQUIRE(scene.connectionGraphicsObject(connectionId) != nullptr);
+
+    scene.setBatchedConnectionsEnabled(true);
+
+    const QRectF area(-1000, -1000, 3000, 3000);
+
+    SECTION("connections are drawn by the layer")
+    {
+        CHECK(scene.batchedConnectionsEnabled());
+        CHECK(scene.connectionGraphicsObject(connectionId) == nullptr);
+        CHECK(scene.connectionsInRect(area).size() == 1);
+    }
+
+    SECTION("new connections are batched")
+    {
+        const NodeId third = model.addNode(PassModel::Name());
+        const ConnectionId other{second, 0, third, 0};
+        model.addConnection(other);
+
+        CHECK(scene.connectionGraphicsObject(other) == nullptr);
+        CHECK(scene.connectionsInRect(area).size() == 2);
+
+        model.deleteConnection(other);
+        CHECK(scene.connectionsInRect(area).size() == 1);
+    }
+
+    SECTION("selected connections keep their object")
+    {
+        ConnectionGraphicsObject *cgo = scene.materializeConnection(connectionId);
+        REQUIRE(cgo != nullptr);
+
+        cgo->setSelected(true);
+        QCoreApplication::processEvents();
+
+        REQUIRE(scene.connectionGraphicsObject(connectionId) == cgo);
+        CHECK(scene.connectionsInRect(area).size() == 1);
+
+        scene.clearSelection();
+        QCoreApplication::processEvents();
+
+        CHECK(scene.connectionGraphicsObject(connectionId) == nullptr);
+        CHECK(scene.connectionsInRect(area).size() == 1);
+    }
+
+    SECTION("moving a node keeps the batched connection attached")
+    {
+        const QRectF before = QRectF(-1000, -1000, 1500, 3000);
+        REQUIRE(scene.connectionsInRect(before).size() == 1);
+
+        model.setNodeData(first, NodeRole::Position, QPointF(5000, 5000));
+        model.setNodeData(second, NodeRole::Position, QPointF(5400, 5000));
+
+        CHECK(scene.connectionsInRect(before).empty());
+        CHECK(scene.connectionsInRect(QRectF(4000, 4000, 3000, 3000)).size() == 1);
+    }
+
+    SECTION("disabling creates the objects again")
+    {
+        scene.setBatchedConnectionsEnabled(false);
+
+        CHECK(scene.connectionGraphicsObject(connectionId) != nullptr);
+    }
+}
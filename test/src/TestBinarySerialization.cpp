@@ -0,0 +1,171 @@
+#include <QtNodes/BinaryGraphFormat>
+#include <QtNodes/DataFlowGraphModel>
+#include <QtNodes/NodeDelegateModelRegistry>
+
+#include <catch2/catch.hpp>
+
+#include <QtCore/QBuffer>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QStringList>
+
+#include <memory>
+
+using QtNodes::BinaryGraphReader;
+using QtNodes::ConnectionId;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::NodeData;
+using QtNodes::NodeDataType;
+using QtNodes::NodeDelegateModel;
+using QtNodes::NodeDelegateModelRegistry;
+using QtNodes::NodeId;
+using QtNodes::NodeRole;
+using QtNodes::PortIndex;
+using QtNodes::PortType;
+
+namespace {
+
+class ValueModel : public NodeDelegateModel
+{
+public:
+    static QString Name() { return "Value"; }
+
+    QString caption() const override { return Name(); }
+
+    QString name() const override { return Name(); }
+
+    size_t nPorts(PortType) const override { return 2; }
+
+    NodeDataType dataType(PortType, PortIndex) const override { return {"value", "Value", {}}; }
+
+    void setInData(std::shared_ptr<NodeData>, PortIndex const) override {}
+
+    std::shared_ptr<NodeData> outData(PortIndex const) override { return nullptr; }
+
+    QWidget *embeddedWidget() override { return nullptr; }
+
+    QJsonObject save() const override
+    {
+        QJsonObject json = NodeDelegateModel::save();
+        json["value"] = _value;
+        json["label"] = _label;
+        return json;
+    }
+
+    void load(QJsonObject const &json) override
+    {
+        _value = json["value"].toDouble();
+        _label = json["label"].toString();
+    }
+
+    double _value = 0.0;
+
+    QString _label;
+};
+
+std::shared_ptr<NodeDelegateModelRegistry> makeRegistry()
+{
+    auto registry = std::make_shared<NodeDelegateModelRegistry>();
+    registry->registerModel<ValueModel>([](auto const &) { return std::make_unique<ValueModel>(); });
+    return registry;
+}
+
+/// Graph as a set-like JSON document, independent of the hash map order.
+QJsonObject canonicalJson(DataFlowGraphModel const &model)
+{
+    QJsonObject json = model.save();
+
+    for (auto key : {"nodes", "connections"}) {
+        QStringList entries;
+        for (auto const &value : json[key].toArray()) {
+            entries << QString::fromUtf8(
+                QJsonDocument(value.toObject()).toJson(QJsonDocument::Compact));
+        }
+        entries.sort();
+        json[key] = QJsonArray::fromStringList(entries);
+    }
+
+    return json;
+}
+
+} // namespace
+
+TEST_CASE("Binary graph format round trip", "[serialization]")
+{
+    auto registry = makeRegistry();
+
+    DataFlowGraphModel source(registry);
+
+    std::vector<NodeId> nodeIds;
+    for (int i = 0; i < 16; ++i) {
+        const NodeId nodeId = source.addNode(ValueModel::Name());
+        source.setNodeData(nodeId, NodeRole::Position, QPointF(i * 10.5, -i * 3.25));
+
+        auto model = source.delegateModel<ValueModel>(nodeId);
+        model->_value = i * 0.5;
+        model->_label = QString("node %1").arg(i);
+
+        nodeIds.push_back(nodeId);
+    }
+
+    for (std::size_t i = 1; i < nodeIds.size(); ++i) {
+        source.addConnection(ConnectionId{nodeIds[i - 1], 0, nodeIds[i], 0});
+        source.addConnection(ConnectionId{nodeIds[0], 1, nodeIds[i], 1});
+    }
+
+    QBuffer buffer;
+    buffer.open(QIODevice::ReadWrite);
+    REQUIRE(source.saveBinary(buffer));
+
+    SECTION("binary matches JSON")
+    {
+        buffer.seek(0);
+        CHECK(QtNodes::BinaryGraphFormat::isBinaryGraph(buffer));
+
+        DataFlowGraphModel restored(registry);
+        REQUIRE(restored.loadBinary(buffer));
+
+        DataFlowGraphModel fromJson(registry);
+        fromJson.load(source.save());
+
+        CHECK(canonicalJson(restored) == canonicalJson(source));
+        CHECK(canonicalJson(restored) == canonicalJson(fromJson));
+        CHECK(restored.connections(nodeIds[0], PortType::Out, 1).size() == nodeIds.size() - 1);
+    }
+
+    SECTION("new node ids continue after the restored ones")
+    {
+        buffer.seek(0);
+
+        DataFlowGraphModel restored(registry);
+        REQUIRE(restored.loadBinary(buffer));
+
+        CHECK(restored.addNode(ValueModel::Name()) == nodeIds.back() + 1);
+    }
+
+    SECTION("truncated data is reported")
+    {
+        QByteArray truncated = buffer.data();
+        truncated.chop(12);
+
+        QBuffer truncatedBuffer(&truncated);
+        truncatedBuffer.open(QIODevice::ReadOnly);
+
+        DataFlowGraphModel restored(registry);
+        CHECK_FALSE(restored.loadBinary(truncatedBuffer));
+    }
+
+    SECTION("foreign data is rejected")
+    {
+        QByteArray json = QJsonDocument(source.save()).toJson();
+
+        QBuffer jsonBuffer(&json);
+        jsonBuffer.open(QIODevice::ReadOnly);
+
+        CHECK_FALSE(QtNodes::BinaryGraphFormat::isBinaryGraph(jsonBuffer));
+
+        BinaryGraphReader reader(jsonBuffer);
+        CHECK_FALSE(reader.readHeader());
+        CHECK(reader.hasError());
+    }
+}
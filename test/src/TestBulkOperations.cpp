@@ -0,0 +1,82 @@
+#include "PassNodeModel.hpp"
+
+#include <QtNodes/DataFlowGraphModel>
+#include <QtNodes/NodeDelegateModelRegistry>
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <vector>
+
+using QtNodes::AbstractGraphModel;
+using QtNodes::ConnectionId;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::InvalidNodeId;
+using QtNodes::NodeId;
+
+TEST_CASE("Bulk graph mutations", "[model]")
+{
+    DataFlowGraphModel model(makeRegistry());
+
+    int nodeCreated = 0;
+    int nodesCreated = 0;
+    int connectionsCreated = 0;
+    int connectionsDeleted = 0;
+    int nodesDeleted = 0;
+
+    QObject::connect(&model, &AbstractGraphModel::nodeCreated, [&]() { ++nodeCreated; });
+    QObject::connect(&model, &AbstractGraphModel::nodesCreated, [&]() { ++nodesCreated; });
+    QObject::connect(&model, &AbstractGraphModel::connectionsCreated, [&]() {
+        ++connectionsCreated;
+    });
+    QObject::connect(&model, &AbstractGraphModel::connectionsDeleted, [&]() {
+        ++connectionsDeleted;
+    });
+    QObject::connect(&model, &AbstractGraphModel::nodesDeleted, [&]() { ++nodesDeleted; });
+
+    const std::vector<NodeId> nodeIds = model.addNodes(
+        {PassModel::Name(), "Unknown", PassModel::Name(), PassModel::Name()});
+
+    REQUIRE(nodeIds.size() == 4);
+    CHECK(nodeIds[1] == InvalidNodeId);
+    CHECK(model.allNodeIds().size() == 3);
+    CHECK(nodeCreated == 0);
+    CHECK(nodesCreated == 1);
+
+    const ConnectionId first{nodeIds[0], 0, nodeIds[2], 0};
+    const ConnectionId second{nodeIds[2], 0, nodeIds[3], 0};
+
+    model.addConnections({first, second, first});
+
+    CHECK(model.connectionExists(first));
+    CHECK(model.connectionExists(second));
+    CHECK(connectionsCreated == 1);
+
+    SECTION("Deleting nodes removes their connections")
+    {
+        model.deleteNodes({nodeIds[0], nodeIds[2]});
+
+        CHECK(model.allNodeIds().size() == 1);
+        CHECK_FALSE(model.connectionExists(first));
+        CHECK_FALSE(model.connectionExists(second));
+        CHECK(model.allConnectionIds(nodeIds[3]).empty());
+        CHECK(connectionsDeleted == 1);
+        CHECK(nodesDeleted == 1);
+    }
+
+    SECTION("Loading emits a signal per connection")
+    {
+        DataFlowGraphModel loaded(makeRegistry());
+
+        int connectionCreated = 0;
+        QObject::connect(&loaded, &AbstractGraphModel::connectionCreated, [&]() {
+            ++connectionCreated;
+        });
+
+        loaded.load(model.save());
+
+        CHECK(loaded.connectionExists(first));
+        CHECK(loaded.connectionExists(second));
+        CHECK(connectionCreated == 2);
+    }
+}
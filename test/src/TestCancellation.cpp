@@ -0,0 +1,144 @@
+#include "ApplicationSetup.hpp"
+#include "PassNodeModel.hpp"
+
+#include <QtNodes/DataFlowGraphModel>
+
+#include <catch2/catch.hpp>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+using QtNodes::CancellationToken;
+using QtNodes::ConnectionId;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::NodeData;
+using QtNodes::NodeDataType;
+using QtNodes::NodeDelegateModel;
+using QtNodes::NodeId;
+using QtNodes::PortIndex;
+using QtNodes::PortType;
+
+namespace {
+
+/// Multiplies by ten. The value 1 blocks until the compute is cancelled,
+/// its result is announced nevertheless.
+class SlowModel : public NodeDelegateModel
+{
+public:
+    static QString Name() { return "Slow"; }
+
+    QString caption() const override { return Name(); }
+
+    QString name() const override { return Name(); }
+
+    size_t nPorts(PortType) const override { return 1; }
+
+    NodeDataType dataType(PortType, PortIndex) const override { return ValueData().type(); }
+
+    void setInData(std::shared_ptr<NodeData> nodeData, PortIndex const) override
+    {
+        _input = std::dynamic_pointer_cast<ValueData>(nodeData);
+    }
+
+    std::shared_ptr<NodeData> outData(PortIndex const) override { return _result; }
+
+    QWidget *embeddedWidget() override { return nullptr; }
+
+    bool threadSafeCompute() const override { return true; }
+
+    void compute() override
+    {
+        if (_input && _input->value() == 1) {
+            QElapsedTimer timer;
+            timer.start();
+
+            while (!cancellationToken().isCancelled() && timer.elapsed() < 5000) {
+                QThread::msleep(1);
+            }
+
+            cancelled = cancellationToken().isCancelled();
+        }
+
+        _result = _input ? std::make_shared<ValueData>(_input->value() * 10) : nullptr;
+        Q_EMIT dataUpdated(0);
+    }
+
+    void restoreOutData(std::shared_ptr<NodeData> nodeData, PortIndex const) override
+    {
+        _result = std::static_pointer_cast<ValueData>(nodeData);
+        ++restores;
+    }
+
+    std::atomic<bool> cancelled{false};
+
+    int restores = 0;
+
+private:
+    std::shared_ptr<ValueData> _input;
+    std::shared_ptr<ValueData> _result;
+};
+
+} // namespace
+
+TEST_CASE("Cancellation tokens share their state", "[cancellation]")
+{
+    CancellationToken token;
+    const CancellationToken copy = token;
+
+    CHECK_FALSE(copy.isCancelled());
+
+    token.cancel();
+
+    CHECK(copy.isCancelled());
+    CHECK_FALSE(CancellationToken().isCancelled());
+}
+
+TEST_CASE("Superseded computes are not propagated", "[cancellation]")
+{
+    auto app = applicationSetup();
+
+    auto registry = makeRegistry();
+    registry->registerModel<SlowModel>([](auto const &) { return std::make_unique<SlowModel>(); });
+
+    DataFlowGraphModel model(registry);
+    model.setAsynchronousEvaluation(true);
+
+    const NodeId source = model.addNode(PassModel::Name());
+    const NodeId slow = model.addNode(SlowModel::Name());
+    const NodeId sink = model.addNode(SinkModel::Name());
+
+    model.addConnection(ConnectionId{source, 0, slow, 0});
+    REQUIRE(model.waitForEvaluation(5000));
+    model.addConnection(ConnectionId{slow, 0, sink, 0});
+    REQUIRE(model.waitForEvaluation(5000));
+
+    auto *sourceModel = model.delegateModel<PassModel>(source);
+    auto *slowModel = model.delegateModel<SlowModel>(slow);
+    auto *sinkModel = model.delegateModel<SinkModel>(sink);
+
+    SECTION("the latest inputs win")
+    {
+        sourceModel->emitValue(1);
+        sourceModel->emitValue(2);
+
+        REQUIRE(model.waitForEvaluation(10000));
+
+        CHECK(slowModel->cancelled);
+        CHECK(slowModel->restores == 1);
+        CHECK(sinkModel->values == std::vector<int>{20});
+        CHECK_FALSE(slowModel->cancellationToken().isCancelled());
+    }
+
+    SECTION("computes without newer inputs are propagated")
+    {
+        sourceModel->emitValue(3);
+
+        REQUIRE(model.waitForEvaluation(10000));
+
+        CHECK(sinkModel->values == std::vector<int>{30});
+    }
+}
@@ -0,0 +1,170 @@
+#include <QtNodes/ConvertersRegister>
+#include <QtNodes/DataFlowGraphModel>
+#include <QtNodes/NodeDelegateModelRegistry>
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+
+using QtNodes::ConnectionId;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::FromToTypes;
+using QtNodes::NodeData;
+using QtNodes::NodeDataType;
+using QtNodes::NodeDelegateModel;
+using QtNodes::NodeDelegateModelRegistry;
+using QtNodes::NodeId;
+using QtNodes::PortIndex;
+using QtNodes::PortType;
+
+namespace {
+
+class IntData : public NodeData
+{
+public:
+    explicit IntData(int value)
+        : value(value)
+    {}
+
+    NodeDataType type() const override { return {"int", "Int", {}}; }
+
+    bool empty() const override { return false; }
+
+    int value;
+};
+
+class TextData : public NodeData
+{
+public:
+    explicit TextData(QString text)
+        : text(std::move(text))
+    {}
+
+    NodeDataType type() const override { return {"text", "Text", {}}; }
+
+    bool empty() const override { return text.isEmpty(); }
+
+    QString text;
+};
+
+class IntSourceModel : public NodeDelegateModel
+{
+public:
+    static QString Name() { return "IntSource"; }
+
+    QString caption() const override { return Name(); }
+
+    QString name() const override { return Name(); }
+
+    size_t nPorts(PortType portType) const override { return portType == PortType::Out ? 1 : 0; }
+
+    NodeDataType dataType(PortType, PortIndex) const override { return {"int", "Int", {}}; }
+
+    void setInData(std::shared_ptr<NodeData>, PortIndex const) override {}
+
+    std::shared_ptr<NodeData> outData(PortIndex const) override { return _data; }
+
+    QWidget *embeddedWidget() override { return nullptr; }
+
+    void setValue(int value)
+    {
+        _data = std::make_shared<IntData>(value);
+        Q_EMIT dataUpdated(0);
+    }
+
+private:
+    std::shared_ptr<IntData> _data;
+};
+
+class TextSinkModel : public NodeDelegateModel
+{
+public:
+    static QString Name() { return "TextSink"; }
+
+    QString caption() const override { return Name(); }
+
+    QString name() const override { return Name(); }
+
+    size_t nPorts(PortType portType) const override { return portType == PortType::In ? 1 : 0; }
+
+    NodeDataType dataType(PortType, PortIndex) const override { return {"text", "Text", {}}; }
+
+    void setInData(std::shared_ptr<NodeData> nodeData, PortIndex const) override
+    {
+        received = nodeData;
+    }
+
+    std::shared_ptr<NodeData> outData(PortIndex const) override { return nullptr; }
+
+    QWidget *embeddedWidget() override { return nullptr; }
+
+    std::shared_ptr<NodeData> received;
+};
+
+} // namespace
+
+TEST_CASE("Converters are applied on propagation", "[converters]")
+{
+    auto registry = std::make_shared<NodeDelegateModelRegistry>();
+    registry->registerModel<IntSourceModel>(
+        [](auto const &) { return std::make_unique<IntSourceModel>(); });
+    registry->registerModel<TextSinkModel>(
+        [](auto const &) { return std::make_unique<TextSinkModel>(); });
+
+    int conversions = 0;
+    registry->convertersRegister()->add_node_data_converter(
+        FromToTypes{"int", "text"},
+        [&conversions](std::shared_ptr<NodeData> const &data) -> std::shared_ptr<NodeData> {
+            ++conversions;
+            auto const &intData = static_cast<IntData const &>(*data);
+            return std::make_shared<TextData>(QString::number(intData.value));
+        });
+
+    DataFlowGraphModel model(registry);
+
+    const NodeId source = model.addNode(IntSourceModel::Name());
+    const NodeId firstSink = model.addNode(TextSinkModel::Name());
+    const NodeId secondSink = model.addNode(TextSinkModel::Name());
+
+    const ConnectionId first{source, 0, firstSink, 0};
+    const ConnectionId second{source, 0, secondSink, 0};
+
+    REQUIRE(model.connectionPossible(first));
+
+    model.addConnection(first);
+    model.addConnection(second);
+
+    auto *sourceModel = model.delegateModel<IntSourceModel>(source);
+    auto *firstModel = model.delegateModel<TextSinkModel>(firstSink);
+    auto *secondModel = model.delegateModel<TextSinkModel>(secondSink);
+
+    SECTION("consumers get the converted data")
+    {
+        sourceModel->setValue(42);
+
+        auto text = std::dynamic_pointer_cast<TextData>(firstModel->received);
+        REQUIRE(text != nullptr);
+        CHECK(text->text == "42");
+    }
+
+    SECTION("fan-out converts once")
+    {
+        conversions = 0;
+        sourceModel->setValue(7);
+
+        CHECK(conversions == 1);
+        CHECK(firstModel->received == secondModel->received);
+
+        sourceModel->setValue(8);
+        CHECK(conversions == 2);
+    }
+
+    SECTION("empty data is not converted")
+    {
+        conversions = 0;
+        model.deleteConnection(first);
+
+        CHECK(firstModel->received == nullptr);
+        CHECK(conversions == 0);
+    }
+}
@@ -0,0 +1,56 @@
+#include "CubicBezier.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <QtGui/QPainterPath>
+
+#include <limits>
+
+using QtNodes::CubicBezier;
+
+TEST_CASE("CubicBezier distance", "[geometry]")
+{
+    const CubicBezier curve{QPointF(0, 0), QPointF(100, 0), QPointF(100, 100), QPointF(200, 100)};
+
+    SECTION("points on the curve")
+    {
+        for (double t : {0.0, 0.1, 0.35, 0.5, 0.8, 1.0}) {
+            CAPTURE(t);
+            CHECK(curve.distanceTo(curve.pointAt(t)) == Approx(0.0).margin(1e-6));
+        }
+    }
+
+    SECTION("matches a dense sampling of the path")
+    {
+        QPainterPath path(curve.p0);
+        path.cubicTo(curve.p1, curve.p2, curve.p3);
+
+        const QPointF points[] = {QPointF(50, 40),
+                                  QPointF(150, 20),
+                                  QPointF(-20, 5),
+                                  QPointF(100, 51),
+                                  QPointF(230, 140)};
+
+        for (QPointF const &point : points) {
+            double expected = std::numeric_limits<double>::max();
+            for (int i = 0; i <= 2000; ++i) {
+                const QPointF onPath = path.pointAtPercent(i / 2000.0);
+                expected = std::min(expected,
+                                    std::sqrt(CubicBezier::squaredDistance(onPath, point)));
+            }
+
+            CAPTURE(point);
+            CHECK(curve.distanceTo(point) == Approx(expected).margin(0.5));
+        }
+    }
+
+    SECTION("segment distance")
+    {
+        const QLineF line(QPointF(0, 0), QPointF(10, 0));
+
+        CHECK(CubicBezier::distanceToSegment(line, QPointF(5, 3)) == Approx(3.0));
+        CHECK(CubicBezier::distanceToSegment(line, QPointF(-4, 3)) == Approx(5.0));
+        CHECK(CubicBezier::distanceToSegment(QLineF(QPointF(1, 1), QPointF(1, 1)), QPointF(4, 5))
+              == Approx(5.0));
+    }
+}
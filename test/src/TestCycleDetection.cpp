@@ -0,0 +1,97 @@
+#include "PassNodeModel.hpp"
+
+#include <QtNodes/DataFlowGraphModel>
+#include <QtNodes/NodeDelegateModelRegistry>
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+using QtNodes::AbstractGraphModel;
+using QtNodes::ConnectionId;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::NodeId;
+
+namespace {
+
+std::vector<NodeId> addNodes(DataFlowGraphModel &model, int count)
+{
+    std::vector<NodeId> nodeIds;
+    for (int i = 0; i < count; ++i) {
+        nodeIds.push_back(model.addNode(PassModel::Name()));
+    }
+    return nodeIds;
+}
+
+ConnectionId connection(NodeId const from, NodeId const to)
+{
+    return ConnectionId{from, 0, to, 0};
+}
+
+} // namespace
+
+TEST_CASE("Cycle detection on a chain", "[cycles]")
+{
+    DataFlowGraphModel model(makeRegistry());
+    const auto n = addNodes(model, 4);
+
+    // Connected against the creation order to force reordering.
+    model.addConnection(connection(n[2], n[3]));
+    model.addConnection(connection(n[1], n[2]));
+    model.addConnection(connection(n[0], n[1]));
+
+    CHECK(model.wouldCreateCycle(n[3], n[0]));
+    CHECK(model.wouldCreateCycle(n[2], n[1]));
+    CHECK(model.wouldCreateCycle(n[1], n[1]));
+    CHECK_FALSE(model.wouldCreateCycle(n[0], n[3]));
+
+    SECTION("Removing a connection breaks the path")
+    {
+        model.deleteConnection(connection(n[1], n[2]));
+
+        CHECK_FALSE(model.wouldCreateCycle(n[3], n[0]));
+        CHECK(model.wouldCreateCycle(n[3], n[2]));
+    }
+
+    SECTION("Order recovers after a cycle is removed")
+    {
+        model.addConnection(connection(n[3], n[0]));
+        CHECK(model.wouldCreateCycle(n[1], n[0]));
+
+        model.deleteConnection(connection(n[3], n[0]));
+        CHECK(model.wouldCreateCycle(n[3], n[0]));
+        CHECK_FALSE(model.wouldCreateCycle(n[0], n[2]));
+    }
+}
+
+TEST_CASE("Cycle detection matches the reference traversal", "[cycles]")
+{
+    DataFlowGraphModel model(makeRegistry());
+    const auto n = addNodes(model, 30);
+
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<std::size_t> pick(0, n.size() - 1);
+    std::bernoulli_distribution remove(0.3);
+
+    std::vector<ConnectionId> added;
+
+    for (int step = 0; step < 500; ++step) {
+        const NodeId from = n[pick(generator)];
+        const NodeId to = n[pick(generator)];
+
+        const bool expected = model.AbstractGraphModel::wouldCreateCycle(from, to);
+        REQUIRE(model.wouldCreateCycle(from, to) == expected);
+
+        if (remove(generator) && !added.empty()) {
+            const std::size_t i = pick(generator) % added.size();
+            model.deleteConnection(added[i]);
+            added.erase(added.begin() + static_cast<std::ptrdiff_t>(i));
+        } else if (!expected || step % 50 == 0) {
+            // Occasional cycles exercise the fallback and the rebuild.
+            model.addConnection(connection(from, to));
+            added.push_back(connection(from, to));
+        }
+    }
+}
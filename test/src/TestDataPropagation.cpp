@@ -0,0 +1,231 @@
+#include "PassNodeModel.hpp"
+
+#include <QtNodes/DataFlowGraphModel>
+
+#include <catch2/catch.hpp>
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+
+#include <memory>
+#include <stdexcept>
+
+using QtNodes::ConnectionId;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::NodeData;
+using QtNodes::NodeDataType;
+using QtNodes::NodeDelegateModel;
+using QtNodes::NodeId;
+using QtNodes::PortIndex;
+using QtNodes::PortRole;
+using QtNodes::PortType;
+
+namespace {
+
+/// Joins two inputs, counts its computes and the inputs each one saw.
+class JoinModel : public NodeDelegateModel
+{
+public:
+    static QString Name() { return "Join"; }
+
+    QString caption() const override { return Name(); }
+
+    QString name() const override { return Name(); }
+
+    size_t nPorts(PortType portType) const override { return portType == PortType::In ? 2 : 1; }
+
+    NodeDataType dataType(PortType, PortIndex) const override { return ValueData().type(); }
+
+    void setInData(std::shared_ptr<NodeData> nodeData, PortIndex const portIndex) override
+    {
+        _inputs[portIndex] = std::move(nodeData);
+    }
+
+    std::shared_ptr<NodeData> outData(PortIndex const) override { return _result; }
+
+    QWidget *embeddedWidget() override { return nullptr; }
+
+    bool threadSafeCompute() const override { return true; }
+
+    void compute() override
+    {
+        ++computeCount;
+        lastInputCount = (_inputs[0] ? 1 : 0) + (_inputs[1] ? 1 : 0);
+
+        _result = std::make_shared<ValueData>();
+        Q_EMIT dataUpdated(0);
+    }
+
+    int computeCount = 0;
+
+    int lastInputCount = 0;
+
+private:
+    std::shared_ptr<NodeData> _inputs[2];
+
+    std::shared_ptr<NodeData> _result;
+};
+
+/// Throws on any data it receives.
+class ThrowModel : public PassModel
+{
+public:
+    static QString Name() { return "Throw"; }
+
+    QString name() const override { return Name(); }
+
+    void setInData(std::shared_ptr<NodeData> nodeData, PortIndex const) override
+    {
+        if (nodeData) {
+            throw std::runtime_error("ThrowModel");
+        }
+    }
+};
+
+} // namespace
+
+TEST_CASE("Change waves in a diamond", "[propagation]")
+{
+    auto registry = makeRegistry();
+    registry->registerModel<JoinModel>([](auto const &) { return std::make_unique<JoinModel>(); });
+
+    DataFlowGraphModel model(registry);
+
+    // Created bottom-up, so the creation order disagrees with the data flow.
+    const NodeId bottom = model.addNode(JoinModel::Name());
+    const NodeId right = model.addNode(JoinModel::Name());
+    const NodeId left = model.addNode(JoinModel::Name());
+    const NodeId source = model.addNode(PassModel::Name());
+
+    model.addConnection(ConnectionId{source, 0, left, 0});
+    model.addConnection(ConnectionId{source, 0, right, 0});
+    model.addConnection(ConnectionId{left, 0, bottom, 0});
+    model.addConnection(ConnectionId{right, 0, bottom, 1});
+
+    auto *bottomModel = model.delegateModel<JoinModel>(bottom);
+    auto *leftModel = model.delegateModel<JoinModel>(left);
+
+    const int bottomComputes = bottomModel->computeCount;
+    const int leftComputes = leftModel->computeCount;
+
+    SECTION("every node computes once per wave, after both of its inputs")
+    {
+        model.delegateModel<PassModel>(source)->emitValue();
+
+        CHECK(leftModel->computeCount == leftComputes + 1);
+        CHECK(bottomModel->computeCount == bottomComputes + 1);
+        CHECK(bottomModel->lastInputCount == 2);
+
+        model.delegateModel<PassModel>(source)->emitValue();
+
+        CHECK(bottomModel->computeCount == bottomComputes + 2);
+    }
+
+    SECTION("a batch forms a single wave")
+    {
+        {
+            const DataFlowGraphModel::BatchUpdate batch(model);
+            model.delegateModel<PassModel>(source)->emitValue();
+            model.delegateModel<PassModel>(source)->emitValue();
+        }
+
+        CHECK(leftModel->computeCount == leftComputes + 1);
+        CHECK(bottomModel->computeCount == bottomComputes + 1);
+    }
+}
+
+TEST_CASE("Batch updates", "[propagation]")
+{
+    auto registry = makeRegistry();
+    registry->registerModel<ThrowModel>([](auto const &) { return std::make_unique<ThrowModel>(); });
+
+    DataFlowGraphModel model(registry);
+
+    const NodeId source = model.addNode(PassModel::Name());
+    const NodeId sink = model.addNode(PassModel::Name());
+    model.addConnection(ConnectionId{source, 0, sink, 0});
+
+    int delivered = 0;
+    QObject::connect(&model,
+                     &DataFlowGraphModel::inPortDataWasSet,
+                     [&](NodeId const nodeId, PortType const, PortIndex const) {
+                         if (nodeId == sink) {
+                             ++delivered;
+                         }
+                     });
+
+    auto *sourceModel = model.delegateModel<PassModel>(source);
+
+    SECTION("nested batches propagate once, when the outermost one ends")
+    {
+        model.beginBatchUpdate();
+        model.beginBatchUpdate();
+
+        sourceModel->emitValue();
+        sourceModel->emitValue();
+
+        model.endBatchUpdate();
+        CHECK(delivered == 0);
+
+        model.endBatchUpdate();
+        CHECK(delivered == 1);
+        CHECK(model.portData(sink, PortType::Out, 0, PortRole::Data)
+                  .value<std::shared_ptr<NodeData>>()
+              != nullptr);
+    }
+
+    SECTION("scoped batches nest like the explicit calls")
+    {
+        {
+            const DataFlowGraphModel::BatchUpdate outer(model);
+            {
+                const DataFlowGraphModel::BatchUpdate inner(model);
+                sourceModel->emitValue();
+            }
+            CHECK(delivered == 0);
+        }
+        CHECK(delivered == 1);
+    }
+
+    SECTION("a failed load does not leave the batch open")
+    {
+        QJsonObject internalData;
+        internalData["model-name"] = "Unknown";
+
+        QJsonObject nodeJson;
+        nodeJson["id"] = 100;
+        nodeJson["internal-data"] = internalData;
+
+        QJsonObject graphJson;
+        graphJson["nodes"] = QJsonArray{nodeJson};
+
+        CHECK_THROWS_AS(model.load(graphJson), std::logic_error);
+
+        sourceModel->emitValue();
+        CHECK(delivered == 1);
+    }
+
+    SECTION("a failing model does not escape the end of the batch")
+    {
+        const ConnectionId throwing{source, 0, model.addNode(ThrowModel::Name()), 0};
+        model.addConnection(throwing);
+
+        model.beginBatchUpdate();
+        sourceModel->emitValue();
+        CHECK_NOTHROW(model.endBatchUpdate());
+
+        model.deleteConnection(throwing);
+        const int before = delivered;
+
+        sourceModel->emitValue();
+        CHECK(delivered == before + 1);
+    }
+
+    SECTION("an unbalanced end is ignored")
+    {
+        model.endBatchUpdate();
+
+        sourceModel->emitValue();
+        CHECK(delivered == 1);
+    }
+}
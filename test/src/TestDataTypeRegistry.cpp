@@ -0,0 +1,198 @@
+#include <QtNodes/ConnectionStyle>
+#include <QtNodes/ConvertersRegister>
+#include <QtNodes/DataFlowGraphModel>
+#include <QtNodes/DataTypeRegistry>
+#include <QtNodes/NodeDelegateModelRegistry>
+
+#include <catch2/catch.hpp>
+
+#include <any>
+#include <memory>
+#include <vector>
+
+using QtNodes::ConnectionId;
+using QtNodes::ConnectionStyle;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::DataTypeHandle;
+using QtNodes::DataTypeRegistry;
+using QtNodes::FromToTypes;
+using QtNodes::NodeData;
+using QtNodes::NodeDataType;
+using QtNodes::NodeDelegateModel;
+using QtNodes::NodeDelegateModelRegistry;
+using QtNodes::NodeId;
+using QtNodes::PortIndex;
+using QtNodes::PortType;
+
+namespace {
+
+class SourceModel : public NodeDelegateModel
+{
+public:
+    static QString Name() { return "Source"; }
+
+    QString caption() const override { return Name(); }
+
+    QString name() const override { return Name(); }
+
+    size_t nPorts(PortType portType) const override { return portType == PortType::Out ? 1 : 0; }
+
+    NodeDataType dataType(PortType, PortIndex) const override { return {"source", "Source", {}}; }
+
+    void setInData(std::shared_ptr<NodeData>, PortIndex const) override {}
+
+    std::shared_ptr<NodeData> outData(PortIndex const) override { return nullptr; }
+
+    QWidget *embeddedWidget() override { return nullptr; }
+};
+
+class SinkModel : public NodeDelegateModel
+{
+public:
+    static QString Name() { return "Sink"; }
+
+    QString caption() const override { return Name(); }
+
+    QString name() const override { return Name(); }
+
+    size_t nPorts(PortType portType) const override { return portType == PortType::In ? 1 : 0; }
+
+    NodeDataType dataType(PortType, PortIndex) const override { return {"sink", "Sink", {}}; }
+
+    void setInData(std::shared_ptr<NodeData>, PortIndex const) override {}
+
+    std::shared_ptr<NodeData> outData(PortIndex const) override { return nullptr; }
+
+    QWidget *embeddedWidget() override { return nullptr; }
+};
+
+/// Input ports of the given types, inserted at run time.
+class MixedModel : public NodeDelegateModel
+{
+public:
+    static QString Name() { return "Mixed"; }
+
+    QString caption() const override { return Name(); }
+
+    QString name() const override { return Name(); }
+
+    size_t nPorts(PortType portType) const override
+    {
+        return portType == PortType::In ? _types.size() : 0;
+    }
+
+    NodeDataType dataType(PortType, PortIndex portIndex) const override
+    {
+        return {_types[static_cast<std::size_t>(portIndex)], "Mixed", {}};
+    }
+
+    void setInData(std::shared_ptr<NodeData>, PortIndex const) override {}
+
+    std::shared_ptr<NodeData> outData(PortIndex const) override { return nullptr; }
+
+    QWidget *embeddedWidget() override { return nullptr; }
+
+    void insertInPort(PortIndex const portIndex, QString const &typeId)
+    {
+        portsAboutToBeInserted(PortType::In, portIndex, portIndex);
+        _types.insert(_types.begin() + portIndex, typeId);
+        portsInserted();
+    }
+
+private:
+    std::vector<QString> _types{"test_mixed_a"};
+};
+
+} // namespace
+
+TEST_CASE("Data type interning", "[types]")
+{
+    const DataTypeHandle first = DataTypeRegistry::intern("test_interning_first");
+    const DataTypeHandle second = DataTypeRegistry::intern("test_interning_second");
+
+    CHECK(first != second);
+    CHECK(DataTypeRegistry::intern(QString("test_interning_") + "first") == first);
+    CHECK(DataTypeRegistry::typeId(second) == "test_interning_second");
+    CHECK(second < DataTypeRegistry::size());
+
+    ConnectionStyle style;
+    CHECK(style.normalColor(first) == style.normalColor(QString("test_interning_first")));
+}
+
+TEST_CASE("Colors given by the data types", "[types]")
+{
+    const DataTypeHandle handle = DataTypeRegistry::intern(
+        NodeDataType{"test_colored", "Colored", QColor(Qt::red)});
+
+    CHECK(DataTypeRegistry::color(handle) == QColor(Qt::red));
+
+    // A type without a color keeps the recorded one.
+    CHECK(DataTypeRegistry::intern(NodeDataType{"test_colored", "Colored", {}}) == handle);
+    CHECK(ConnectionStyle().normalColor(handle) == QColor(Qt::red));
+
+    // The first color given wins.
+    DataTypeRegistry::intern(NodeDataType{"test_colored", "Colored", QColor(Qt::blue)});
+    CHECK(DataTypeRegistry::color(handle) == QColor(Qt::red));
+}
+
+TEST_CASE("Color lookups do not intern", "[types]")
+{
+    const std::size_t size = DataTypeRegistry::size();
+
+    const QColor color = ConnectionStyle().normalColor(QString("test_looked_up_only"));
+
+    CHECK(DataTypeRegistry::size() == size);
+    CHECK(DataTypeRegistry::color(DataTypeRegistry::intern("test_looked_up_only")) == color);
+}
+
+TEST_CASE("Port type handles follow port insertion", "[types]")
+{
+    auto registry = std::make_shared<NodeDelegateModelRegistry>();
+    registry->registerModel<MixedModel>([](auto const &) { return std::make_unique<MixedModel>(); });
+
+    DataFlowGraphModel model(registry);
+    const NodeId nodeId = model.addNode(MixedModel::Name());
+
+    const DataTypeHandle a = DataTypeRegistry::intern("test_mixed_a");
+    const DataTypeHandle b = DataTypeRegistry::intern("test_mixed_b");
+
+    CHECK(model.portTypeHandle(nodeId, PortType::In, 0) == a);
+
+    model.delegateModel<MixedModel>(nodeId)->insertInPort(0, "test_mixed_b");
+
+    CHECK(model.portTypeHandle(nodeId, PortType::In, 0) == b);
+    CHECK(model.portTypeHandle(nodeId, PortType::In, 1) == a);
+}
+
+TEST_CASE("Converter keys use the interned types", "[types]")
+{
+    const FromToTypes byName{"test_key_from", "test_key_to"};
+    const FromToTypes byHandle{DataTypeRegistry::intern("test_key_from"),
+                               DataTypeRegistry::intern("test_key_to")};
+
+    CHECK(byName == byHandle);
+    CHECK(byName.from() == "test_key_from");
+    CHECK(byName.to() == "test_key_to");
+    CHECK_FALSE(byName == FromToTypes(byHandle.toHandle(), byHandle.fromHandle()));
+}
+
+TEST_CASE("Connections between types need a converter", "[types]")
+{
+    auto registry = std::make_shared<NodeDelegateModelRegistry>();
+    registry->registerModel<SourceModel>(
+        [](auto const &) { return std::make_unique<SourceModel>(); });
+    registry->registerModel<SinkModel>([](auto const &) { return std::make_unique<SinkModel>(); });
+
+    DataFlowGraphModel model(registry);
+
+    const NodeId source = model.addNode(SourceModel::Name());
+    const NodeId sink = model.addNode(SinkModel::Name());
+    const ConnectionId connectionId{source, 0, sink, 0};
+
+    CHECK_FALSE(model.connectionPossible(connectionId));
+
+    registry->convertersRegister()->emplace(FromToTypes{"source", "sink"},
+                                            [](std::any const &from) { return from; });
+
+    CHECK(model.connectionPossible(connectionId));
+}
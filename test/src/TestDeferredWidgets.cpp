@@ -0,0 +1,112 @@
+#include "ApplicationSetup.hpp"
+
+#include <QtNodes/DataFlowGraphModel>
+#include <QtNodes/DataFlowGraphicsScene>
+#include <QtNodes/NodeDelegateModelRegistry>
+#include <QtNodes/internal/NodeGraphicsObject.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <QtCore/QPointer>
+#include <QtWidgets/QLabel>
+
+#include <memory>
+
+using QtNodes::DataFlowGraphicsScene;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::NodeData;
+using QtNodes::NodeDataType;
+using QtNodes::NodeDelegateModel;
+using QtNodes::NodeDelegateModelRegistry;
+using QtNodes::NodeGraphicsObject;
+using QtNodes::NodeId;
+using QtNodes::PortIndex;
+using QtNodes::PortType;
+
+namespace {
+
+class LabelModel : public NodeDelegateModel
+{
+public:
+    static QString Name() { return "Label"; }
+
+    QString caption() const override { return Name(); }
+
+    QString name() const override { return Name(); }
+
+    size_t nPorts(PortType) const override { return 1; }
+
+    NodeDataType dataType(PortType, PortIndex) const override { return {"value", "Value", {}}; }
+
+    void setInData(std::shared_ptr<NodeData>, PortIndex const) override {}
+
+    std::shared_ptr<NodeData> outData(PortIndex const) override { return nullptr; }
+
+    QWidget *embeddedWidget() override
+    {
+        if (!_label) {
+            _label = new QLabel("0.0");
+        }
+        return _label;
+    }
+
+private:
+    QLabel *_label = nullptr;
+};
+
+std::shared_ptr<NodeDelegateModelRegistry> makeRegistry()
+{
+    auto registry = std::make_shared<NodeDelegateModelRegistry>();
+    registry->registerModel<LabelModel>([](auto const &) { return std::make_unique<LabelModel>(); });
+    return registry;
+}
+
+} // namespace
+
+TEST_CASE("Deferred embedded widgets", "[gui]")
+{
+    auto app = applicationSetup();
+
+    DataFlowGraphModel model(makeRegistry());
+    DataFlowGraphicsScene scene(model);
+    scene.setDeferredWidgetsEnabled(true);
+
+    const NodeId nodeId = model.addNode(LabelModel::Name());
+    NodeGraphicsObject *ngo = scene.nodeGraphicsObject(nodeId);
+    REQUIRE(ngo != nullptr);
+
+    QPointer<QWidget> widget = model.delegateModel<LabelModel>(nodeId)->embeddedWidget();
+
+    SECTION("the proxy is created on demand")
+    {
+        CHECK_FALSE(ngo->embeddedWidgetActive());
+        CHECK(widget->graphicsProxyWidget() == nullptr);
+
+        ngo->activateEmbeddedWidget();
+
+        CHECK(ngo->embeddedWidgetActive());
+        CHECK(widget->graphicsProxyWidget() != nullptr);
+    }
+
+    SECTION("releasing keeps the widget")
+    {
+        ngo->activateEmbeddedWidget();
+        ngo->releaseEmbeddedWidget();
+
+        CHECK_FALSE(ngo->embeddedWidgetActive());
+        REQUIRE(widget);
+        CHECK(widget->graphicsProxyWidget() == nullptr);
+
+        ngo->activateEmbeddedWidget();
+
+        CHECK(widget->graphicsProxyWidget() != nullptr);
+        CHECK(widget->graphicsProxyWidget()->isVisible());
+    }
+
+    SECTION("disabling the mode embeds all widgets")
+    {
+        scene.setDeferredWidgetsEnabled(false);
+
+        CHECK(ngo->embeddedWidgetActive());
+    }
+}
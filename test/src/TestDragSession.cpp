@@ -0,0 +1,92 @@
+#include "ApplicationSetup.hpp"
+#include "PassNodeModel.hpp"
+
+#include <QtNodes/DataFlowGraphModel>
+#include <QtNodes/DataFlowGraphicsScene>
+#include <QtNodes/NodeDelegateModelRegistry>
+#include <QtNodes/internal/NodeGraphicsObject.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <QUndoStack>
+
+#include <memory>
+
+using QtNodes::ConnectionId;
+using QtNodes::DataFlowGraphicsScene;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::NodeId;
+using QtNodes::NodeRole;
+
+TEST_CASE("Drag sessions", "[gui]")
+{
+    auto app = applicationSetup();
+
+    DataFlowGraphModel model(makeRegistry());
+
+    const NodeId first = model.addNode(PassModel::Name());
+    const NodeId second = model.addNode(PassModel::Name());
+    const NodeId third = model.addNode(PassModel::Name());
+    model.setNodeData(second, NodeRole::Position, QPointF(300, 0));
+    model.setNodeData(third, NodeRole::Position, QPointF(600, 0));
+    model.addConnection(ConnectionId{first, 0, second, 0});
+
+    DataFlowGraphicsScene scene(model);
+    scene.setDragSessionsEnabled(true);
+
+    scene.nodeGraphicsObject(first)->setSelected(true);
+    scene.nodeGraphicsObject(second)->setSelected(true);
+
+    auto position = [&](NodeId const nodeId) {
+        return model.nodeData(nodeId, NodeRole::Position).value<QPointF>();
+    };
+
+    SECTION("moves are coalesced into one command")
+    {
+        scene.beginDragSession();
+        REQUIRE(scene.dragSessionActive());
+
+        for (int i = 0; i < 10; ++i) {
+            scene.updateDragSession(QPointF(1, 2));
+        }
+
+        // Nothing moves before the frame.
+        CHECK(position(first) == QPointF(0, 0));
+
+        scene.endDragSession();
+
+        CHECK_FALSE(scene.dragSessionActive());
+        CHECK(position(first) == QPointF(10, 20));
+        CHECK(position(second) == QPointF(310, 20));
+        CHECK(position(third) == QPointF(600, 0));
+        CHECK(scene.nodeGraphicsObject(second)->pos() == QPointF(310, 20));
+        CHECK(scene.undoStack().count() == 1);
+
+        scene.undoStack().undo();
+        CHECK(position(first) == QPointF(0, 0));
+        CHECK(position(second) == QPointF(300, 0));
+
+        scene.undoStack().redo();
+        CHECK(position(first) == QPointF(10, 20));
+    }
+
+    SECTION("the selection is taken once")
+    {
+        scene.beginDragSession();
+        scene.nodeGraphicsObject(third)->setSelected(true);
+
+        scene.updateDragSession(QPointF(5, 5));
+        scene.endDragSession();
+
+        CHECK(position(first) == QPointF(5, 5));
+        CHECK(position(third) == QPointF(600, 0));
+    }
+
+    SECTION("a click without a move records nothing")
+    {
+        scene.beginDragSession();
+        scene.endDragSession();
+
+        CHECK(scene.undoStack().count() == 0);
+    }
+}
@@ -0,0 +1,61 @@
+#include "PassNodeModel.hpp"
+
+#include <QtNodes/DataFlowGraphModel>
+
+#include <catch2/catch.hpp>
+
+#include <unordered_set>
+
+using QtNodes::ConnectionId;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::NodeId;
+using QtNodes::PortType;
+
+TEST_CASE("Connection indices follow port insertion and deletion", "[ports]")
+{
+    DataFlowGraphModel model(makeRegistry());
+
+    const NodeId first = model.addNode(PassModel::Name());
+    const NodeId second = model.addNode(PassModel::Name());
+    const NodeId node = model.addNode(PortsModel::Name());
+
+    auto *portsModel = model.delegateModel<PortsModel>(node);
+    portsModel->insertInPort(1);
+
+    model.addConnection(ConnectionId{first, 0, node, 0});
+    model.addConnection(ConnectionId{second, 0, node, 1});
+
+    using Connections = std::unordered_set<ConnectionId>;
+
+    SECTION("insertion shifts the connections behind the new port")
+    {
+        portsModel->insertInPort(0);
+
+        const ConnectionId shiftedFirst{first, 0, node, 1};
+        const ConnectionId shiftedSecond{second, 0, node, 2};
+
+        CHECK(model.connections(node, PortType::In, 0).empty());
+        CHECK(model.connections(node, PortType::In, 1) == Connections{shiftedFirst});
+        CHECK(model.connections(node, PortType::In, 2) == Connections{shiftedSecond});
+        CHECK(model.connections(first, PortType::Out, 0) == Connections{shiftedFirst});
+
+        CHECK(model.allConnectionIds(node) == Connections{shiftedFirst, shiftedSecond});
+        CHECK(model.allConnectionIds(second) == Connections{shiftedSecond});
+        CHECK_FALSE(model.connectionExists(ConnectionId{first, 0, node, 0}));
+    }
+
+    SECTION("deletion drops the connections of the port and shifts the others back")
+    {
+        portsModel->deleteInPort(0);
+
+        const ConnectionId shiftedSecond{second, 0, node, 0};
+
+        CHECK(model.connections(node, PortType::In, 0) == Connections{shiftedSecond});
+        CHECK(model.connections(node, PortType::In, 1).empty());
+        CHECK(model.connections(second, PortType::Out, 0) == Connections{shiftedSecond});
+
+        CHECK(model.allConnectionIds(node) == Connections{shiftedSecond});
+        CHECK(model.allConnectionIds(first).empty());
+        CHECK_FALSE(model.connectionExists(ConnectionId{second, 0, node, 1}));
+    }
+}
@@ -0,0 +1,213 @@
+#include "ApplicationSetup.hpp"
+#include "PassNodeModel.hpp"
+
+#include <QtNodes/DataFlowGraphModel>
+
+#include <catch2/catch.hpp>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+using QtNodes::ConnectionId;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::NodeData;
+using QtNodes::NodeDataType;
+using QtNodes::NodeDelegateModel;
+using QtNodes::NodeId;
+using QtNodes::PortIndex;
+using QtNodes::PortRole;
+using QtNodes::PortType;
+
+namespace {
+
+std::atomic<int> &computeSequence()
+{
+    static std::atomic<int> sequence{0};
+    return sequence;
+}
+
+/// Outputs the sum of its inputs plus one. Blocks while `gate` is closed.
+class SumModel : public NodeDelegateModel
+{
+public:
+    static QString Name() { return "Sum"; }
+
+    QString caption() const override { return Name(); }
+
+    QString name() const override { return Name(); }
+
+    size_t nPorts(PortType portType) const override { return portType == PortType::In ? 2 : 1; }
+
+    NodeDataType dataType(PortType, PortIndex) const override { return ValueData().type(); }
+
+    void setInData(std::shared_ptr<NodeData> nodeData, PortIndex const portIndex) override
+    {
+        _inputs[portIndex] = std::dynamic_pointer_cast<ValueData>(nodeData);
+    }
+
+    std::shared_ptr<NodeData> outData(PortIndex const) override { return _result; }
+
+    QWidget *embeddedWidget() override { return nullptr; }
+
+    bool threadSafeCompute() const override { return true; }
+
+    void compute() override
+    {
+        QElapsedTimer timer;
+        timer.start();
+        while (!gate && timer.elapsed() < 5000) {
+            QThread::msleep(1);
+        }
+
+        int sum = 1;
+        for (auto const &input : _inputs) {
+            sum += input ? input->value() : 0;
+        }
+
+        _result = std::make_shared<ValueData>(sum);
+
+        ranOnWorker = QThread::currentThread() != thread();
+        sequence = ++computeSequence();
+        ++computeCount;
+
+        Q_EMIT dataUpdated(0);
+    }
+
+    int result() const { return _result ? _result->value() : -1; }
+
+    std::atomic<bool> gate{true};
+
+    std::atomic<bool> ranOnWorker{false};
+
+    std::atomic<int> sequence{0};
+
+    std::atomic<int> computeCount{0};
+
+private:
+    std::shared_ptr<ValueData> _inputs[2];
+
+    std::shared_ptr<ValueData> _result;
+};
+
+std::shared_ptr<QtNodes::NodeDelegateModelRegistry> makeSumRegistry()
+{
+    auto registry = makeRegistry();
+    registry->registerModel<SumModel>([](auto const &) { return std::make_unique<SumModel>(); });
+    return registry;
+}
+
+} // namespace
+
+TEST_CASE("Asynchronous evaluation", "[evaluation]")
+{
+    auto app = applicationSetup();
+
+    DataFlowGraphModel model(makeSumRegistry());
+    model.setAsynchronousEvaluation(true);
+
+    const NodeId source = model.addNode(PassModel::Name());
+    const NodeId left = model.addNode(SumModel::Name());
+    const NodeId right = model.addNode(SumModel::Name());
+    const NodeId bottom = model.addNode(SumModel::Name());
+
+    model.addConnections({ConnectionId{source, 0, left, 0},
+                          ConnectionId{source, 0, right, 0},
+                          ConnectionId{left, 0, bottom, 0},
+                          ConnectionId{right, 0, bottom, 1}});
+    REQUIRE(model.waitForEvaluation(5000));
+
+    auto *sourceModel = model.delegateModel<PassModel>(source);
+    auto *leftModel = model.delegateModel<SumModel>(left);
+    auto *rightModel = model.delegateModel<SumModel>(right);
+    auto *bottomModel = model.delegateModel<SumModel>(bottom);
+
+    const int bottomComputes = bottomModel->computeCount;
+
+    SECTION("computes run on the pool in dependency order")
+    {
+        sourceModel->emitValue(1);
+        REQUIRE(model.waitForEvaluation(5000));
+
+        CHECK(bottomModel->result() == 5);
+        CHECK(bottomModel->computeCount == bottomComputes + 1);
+        CHECK(bottomModel->sequence > leftModel->sequence);
+        CHECK(bottomModel->sequence > rightModel->sequence);
+
+        CHECK(leftModel->ranOnWorker);
+        CHECK(bottomModel->ranOnWorker);
+    }
+
+    SECTION("computingStarted and computingFinished bracket every compute")
+    {
+        std::vector<std::string> events;
+        QObject::connect(leftModel, &NodeDelegateModel::computingStarted, [&]() {
+            events.push_back("started");
+        });
+        QObject::connect(leftModel, &NodeDelegateModel::computingFinished, [&]() {
+            events.push_back("finished");
+        });
+
+        sourceModel->emitValue(1);
+
+        // The compute is running or its result is not delivered yet.
+        CHECK(events == std::vector<std::string>{"started"});
+
+        REQUIRE(model.waitForEvaluation(5000));
+        CHECK(events == std::vector<std::string>{"started", "finished"});
+    }
+
+    SECTION("disabled, the computes run synchronously")
+    {
+        model.setAsynchronousEvaluation(false);
+
+        sourceModel->emitValue(2);
+
+        CHECK(bottomModel->result() == 7);
+        CHECK_FALSE(bottomModel->ranOnWorker);
+    }
+}
+
+TEST_CASE("Connections from a computing node wait for its outputs", "[evaluation]")
+{
+    auto app = applicationSetup();
+
+    DataFlowGraphModel model(makeSumRegistry());
+    model.setAsynchronousEvaluation(true);
+
+    const NodeId source = model.addNode(PassModel::Name());
+    const NodeId busy = model.addNode(SumModel::Name());
+    const NodeId sink = model.addNode(SumModel::Name());
+
+    model.addConnection(ConnectionId{source, 0, busy, 0});
+    REQUIRE(model.waitForEvaluation(5000));
+
+    auto *busyModel = model.delegateModel<SumModel>(busy);
+    auto *sinkModel = model.delegateModel<SumModel>(sink);
+
+    int delivered = 0;
+    QObject::connect(&model,
+                     &DataFlowGraphModel::inPortDataWasSet,
+                     [&](NodeId const nodeId, PortType const, PortIndex const) {
+                         if (nodeId == sink) {
+                             ++delivered;
+                         }
+                     });
+
+    busyModel->gate = false;
+    model.delegateModel<PassModel>(source)->emitValue(1);
+
+    // Connected while `busy` writes its outputs on a worker thread.
+    model.addConnection(ConnectionId{busy, 0, sink, 0});
+    CHECK(delivered == 0);
+
+    busyModel->gate = true;
+    REQUIRE(model.waitForEvaluation(5000));
+
+    CHECK(delivered == 1);
+    CHECK(sinkModel->result() == 3);
+}
@@ -0,0 +1,106 @@
+#include "ApplicationSetup.hpp"
+#include "PassNodeModel.hpp"
+
+#include <QtNodes/DataFlowGraphModel>
+#include <QtNodes/DataFlowGraphicsScene>
+#include <QtNodes/GraphicsView>
+#include <QtNodes/internal/NodeGraphicsObject.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <QtWidgets/QGraphicsEffect>
+
+using QtNodes::BasicGraphicsScene;
+using QtNodes::DataFlowGraphicsScene;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::GraphicsView;
+using QtNodes::NodeGraphicsObject;
+using QtNodes::NodeId;
+using QtNodes::NodeRole;
+
+TEST_CASE("Low detail mode follows the view scale", "[gui]")
+{
+    auto app = applicationSetup();
+
+    DataFlowGraphModel model(makeRegistry());
+    const NodeId nodeId = model.addNode(PassModel::Name());
+
+    DataFlowGraphicsScene scene(model);
+    scene.setNodeShadowMode(BasicGraphicsScene::ShadowMode::Effect);
+
+    GraphicsView view(&scene);
+    view.setupScale(1.0);
+
+    NodeGraphicsObject *ngo = scene.nodeGraphicsObject(nodeId);
+    REQUIRE(ngo != nullptr);
+    REQUIRE(ngo->graphicsEffect() != nullptr);
+
+    SECTION("disabled by default")
+    {
+        view.setupScale(0.4);
+
+        CHECK(view.lowDetailScale() == 0.0);
+        CHECK_FALSE(scene.lowDetailMode());
+    }
+
+    SECTION("switched on below the low detail scale and back above it")
+    {
+        view.setLowDetailScale(0.5);
+        CHECK_FALSE(scene.lowDetailMode());
+
+        view.setupScale(0.4);
+        CHECK(scene.lowDetailMode());
+        CHECK_FALSE(ngo->graphicsEffect()->isEnabled());
+
+        view.setupScale(1.0);
+        CHECK_FALSE(scene.lowDetailMode());
+        CHECK(ngo->graphicsEffect()->isEnabled());
+    }
+
+    SECTION("nodes created in low detail mode start in it")
+    {
+        view.setLowDetailScale(0.5);
+        view.setupScale(0.4);
+
+        const NodeId created = model.addNode(PassModel::Name());
+        NodeGraphicsObject *createdObject = scene.nodeGraphicsObject(created);
+        REQUIRE(createdObject != nullptr);
+        REQUIRE(createdObject->graphicsEffect() != nullptr);
+        CHECK_FALSE(createdObject->graphicsEffect()->isEnabled());
+    }
+}
+
+TEST_CASE("Nodes are found under a point with and without the spatial index", "[gui]")
+{
+    auto app = applicationSetup();
+
+    DataFlowGraphModel model(makeRegistry());
+    const NodeId bottom = model.addNode(PassModel::Name());
+    const NodeId top = model.addNode(PassModel::Name());
+    const NodeId away = model.addNode(PassModel::Name());
+    model.setNodeData(away, NodeRole::Position, QPointF(1000, 1000));
+
+    DataFlowGraphicsScene scene(model);
+    scene.nodeGraphicsObject(top)->setZValue(1);
+
+    const QPointF inside = scene.nodeGraphicsObject(bottom)->sceneBoundingRect().center();
+
+    auto check = [&]() {
+        CHECK(scene.nodeGraphicsObjectAt(inside) == scene.nodeGraphicsObject(top));
+        CHECK(scene.nodeGraphicsObjectAt(QPointF(1000, 1000) + QPointF(5, 5))
+              == scene.nodeGraphicsObject(away));
+        CHECK(scene.nodeGraphicsObjectAt(QPointF(-500, -500)) == nullptr);
+    };
+
+    SECTION("without the index")
+    {
+        scene.setSpatialIndexEnabled(false);
+        check();
+    }
+
+    SECTION("with the index")
+    {
+        scene.setSpatialIndexEnabled(true);
+        check();
+    }
+}
@@ -0,0 +1,158 @@
+#include "PassNodeModel.hpp"
+
+#include <QtNodes/DataFlowGraphModel>
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+
+using QtNodes::ConnectionId;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::NodeData;
+using QtNodes::NodeDataType;
+using QtNodes::NodeDelegateModel;
+using QtNodes::NodeId;
+using QtNodes::PortIndex;
+using QtNodes::PortType;
+
+namespace {
+
+/// Squares its input in `compute()` and keeps the last two results.
+class SquareModel : public NodeDelegateModel
+{
+public:
+    static QString Name() { return "Square"; }
+
+    QString caption() const override { return Name(); }
+
+    QString name() const override { return Name(); }
+
+    size_t nPorts(PortType) const override { return 1; }
+
+    NodeDataType dataType(PortType, PortIndex) const override { return ValueData().type(); }
+
+    void setInData(std::shared_ptr<NodeData> nodeData, PortIndex const) override
+    {
+        _input = std::dynamic_pointer_cast<ValueData>(nodeData);
+    }
+
+    std::shared_ptr<NodeData> outData(PortIndex const) override { return _result; }
+
+    QWidget *embeddedWidget() override { return nullptr; }
+
+    bool threadSafeCompute() const override { return true; }
+
+    void compute() override
+    {
+        ++computes;
+        _result = _input ? std::make_shared<ValueData>(_input->value() * _input->value())
+                         : nullptr;
+        Q_EMIT dataUpdated(0);
+    }
+
+    std::size_t memoizationCacheSize() const override { return 2; }
+
+    void restoreOutData(std::shared_ptr<NodeData> nodeData, PortIndex const) override
+    {
+        _result = std::static_pointer_cast<ValueData>(nodeData);
+    }
+
+    int computes = 0;
+
+private:
+    std::shared_ptr<ValueData> _input;
+    std::shared_ptr<ValueData> _result;
+};
+
+} // namespace
+
+TEST_CASE("Memoized outputs", "[memoization]")
+{
+    auto registry = makeRegistry();
+    registry->registerModel<SquareModel>(
+        [](auto const &) { return std::make_unique<SquareModel>(); });
+
+    DataFlowGraphModel model(registry);
+
+    const NodeId source = model.addNode(PassModel::Name());
+    const NodeId square = model.addNode(SquareModel::Name());
+    const NodeId sink = model.addNode(SinkModel::Name());
+
+    model.addConnection(ConnectionId{source, 0, square, 0});
+    model.addConnection(ConnectionId{square, 0, sink, 0});
+
+    auto *sourceModel = model.delegateModel<PassModel>(source);
+    auto *squareModel = model.delegateModel<SquareModel>(square);
+    auto *sinkModel = model.delegateModel<SinkModel>(sink);
+
+    sourceModel->emitValue(3);
+    REQUIRE(sinkModel->value() == 9);
+
+    const int computes = squareModel->computes;
+    const int received = sinkModel->received;
+    const auto stats = model.memoizationStats(square);
+
+    SECTION("unchanged inputs neither compute nor propagate")
+    {
+        sourceModel->emitValue(3);
+
+        CHECK(squareModel->computes == computes);
+        CHECK(sinkModel->received == received);
+        CHECK(model.memoizationStats(square).hits == stats.hits + 1);
+    }
+
+    SECTION("older entries are restored and propagated")
+    {
+        sourceModel->emitValue(4);
+        CHECK(sinkModel->value() == 16);
+
+        sourceModel->emitValue(3);
+
+        CHECK(squareModel->computes == computes + 1);
+        CHECK(sinkModel->value() == 9);
+        CHECK(sinkModel->received == received + 2);
+        CHECK(model.memoizationStats(square).misses == stats.misses + 1);
+    }
+
+    SECTION("the cache is bounded")
+    {
+        sourceModel->emitValue(4);
+        sourceModel->emitValue(5);
+        sourceModel->emitValue(3);
+
+        CHECK(squareModel->computes == computes + 3);
+        CHECK(sinkModel->value() == 9);
+    }
+
+    SECTION("data without a hash is always computed")
+    {
+        sourceModel->emitData(std::make_shared<ValueData>(3, false));
+        sourceModel->emitData(std::make_shared<ValueData>(3, false));
+
+        CHECK(squareModel->computes == computes + 2);
+        CHECK(model.memoizationStats(square).misses == stats.misses + 2);
+    }
+
+    SECTION("empty inputs do not match data hashing like them")
+    {
+        const ConnectionId connection{source, 0, square, 0};
+
+        model.deleteConnection(connection);
+        model.addConnection(connection);
+        const int reconnected = squareModel->computes;
+
+        // std::hash<int> may well map 0 to 0.
+        sourceModel->emitValue(0);
+
+        CHECK(squareModel->computes == reconnected + 1);
+        CHECK(sinkModel->value() == 0);
+    }
+
+    SECTION("clearing forces a compute")
+    {
+        model.clearMemoizedOutputs(square);
+        sourceModel->emitValue(3);
+
+        CHECK(squareModel->computes == computes + 1);
+    }
+}
@@ -0,0 +1,75 @@
+#include "ApplicationSetup.hpp"
+#include "PassNodeModel.hpp"
+
+#include <QtNodes/DataFlowGraphModel>
+#include <QtNodes/DataFlowGraphicsScene>
+#include <QtNodes/internal/AbstractNodeGeometry.hpp>
+
+#include <catch2/catch.hpp>
+
+using QtNodes::AbstractNodeGeometry;
+using QtNodes::DataFlowGraphicsScene;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::NodeId;
+using QtNodes::NodeRole;
+using QtNodes::PortType;
+
+TEST_CASE("Node layouts follow port insertion and deletion", "[gui][geometry]")
+{
+    auto app = applicationSetup();
+
+    DataFlowGraphModel model(makeRegistry());
+    const NodeId nodeId = model.addNode(PortsModel::Name());
+
+    DataFlowGraphicsScene scene(model);
+    AbstractNodeGeometry &geometry = scene.nodeGeometry();
+
+    auto *portsModel = model.delegateModel<PortsModel>(nodeId);
+
+    const QSize initialSize = geometry.size(nodeId);
+    const QPointF firstPort = geometry.portPosition(nodeId, PortType::In, 0);
+
+    // A port the node does not have yet is placed where it will appear.
+    const QPointF secondPort = geometry.portPosition(nodeId, PortType::In, 1);
+    CHECK(secondPort.y() > firstPort.y());
+    CHECK(geometry.portTextPosition(nodeId, PortType::In, 1).y() > firstPort.y());
+
+    SECTION("insertion")
+    {
+        portsModel->insertInPort(1);
+
+        // The scene does it on `nodeUpdated`.
+        geometry.recomputeSize(nodeId);
+
+        CHECK(geometry.size(nodeId).height() > initialSize.height());
+        CHECK(geometry.portPosition(nodeId, PortType::In, 0) == firstPort);
+        CHECK(geometry.portPosition(nodeId, PortType::In, 1) == secondPort);
+        CHECK(geometry.portPosition(nodeId, PortType::Out, 0).x()
+              == geometry.size(nodeId).width());
+    }
+
+    SECTION("deletion")
+    {
+        portsModel->insertInPort(1);
+        const QPointF thirdPort = geometry.portPosition(nodeId, PortType::In, 2);
+
+        portsModel->insertInPort(2);
+        CHECK(geometry.portPosition(nodeId, PortType::In, 2) == thirdPort);
+
+        portsModel->deleteInPort(0);
+        portsModel->deleteInPort(0);
+        geometry.recomputeSize(nodeId);
+
+        CHECK(geometry.size(nodeId) == initialSize);
+        CHECK(geometry.portPosition(nodeId, PortType::In, 0) == firstPort);
+        CHECK(geometry.portPosition(nodeId, PortType::In, 1) == secondPort);
+    }
+
+    SECTION("size")
+    {
+        model.setNodeData(nodeId, NodeRole::Size, QSize(300, 200));
+
+        CHECK(geometry.portPosition(nodeId, PortType::Out, 0).x() == 300);
+        CHECK(geometry.portPosition(nodeId, PortType::In, 0) == firstPort);
+    }
+}
@@ -0,0 +1,119 @@
+#include "PassNodeModel.hpp"
+
+#include <QtNodes/DataFlowGraphModel>
+#include <QtNodes/DefaultNodePainter>
+#include <QtNodes/NodeDelegateModelRegistry>
+#include <QtNodes/NodeHeatMapPainter>
+#include <QtNodes/NodeProfiler>
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <memory>
+
+using QtNodes::ConnectionId;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::DefaultNodePainter;
+using QtNodes::NodeHeatMapPainter;
+using QtNodes::NodeId;
+using QtNodes::NodeProfile;
+using QtNodes::NodeProfiler;
+
+TEST_CASE("Node profiler", "[profiler]")
+{
+    auto registry = makeRegistry();
+
+    DataFlowGraphModel model(registry);
+
+    const NodeId source = model.addNode(PassModel::Name());
+    const NodeId first = model.addNode(PassModel::Name());
+    const NodeId second = model.addNode(PassModel::Name());
+
+    model.addConnection(ConnectionId{source, 0, first, 0});
+    model.addConnection(ConnectionId{source, 0, second, 0});
+
+    auto *sourceModel = model.delegateModel<PassModel>(source);
+
+    SECTION("disabled by default")
+    {
+        CHECK_FALSE(model.profilingEnabled());
+        CHECK(model.profiler() == nullptr);
+    }
+
+    SECTION("records inputs, computes, latency and fan-out")
+    {
+        model.setProfilingEnabled(true);
+        REQUIRE(model.profiler() != nullptr);
+
+        sourceModel->emitValue();
+        sourceModel->emitValue();
+
+        NodeProfiler const &profiler = *model.profiler();
+
+        const NodeProfile *sourceProfile = profiler.profile(source);
+        REQUIRE(sourceProfile != nullptr);
+        CHECK(sourceProfile->fanOutCount == 4);
+        CHECK(sourceProfile->setInDataCount == 0);
+
+        const NodeProfile *firstProfile = profiler.profile(first);
+        REQUIRE(firstProfile != nullptr);
+        CHECK(firstProfile->setInDataCount == 2);
+        CHECK(firstProfile->computeCount == 2);
+        CHECK(firstProfile->latencyCount == 2);
+        CHECK(firstProfile->recentComputeTimes().size() == 2);
+        CHECK(profiler.maxComputeTime() >= firstProfile->computeTime);
+
+        model.deleteNode(second);
+        CHECK(profiler.profile(second) == nullptr);
+    }
+
+    SECTION("disabling drops the statistics")
+    {
+        model.setProfilingEnabled(true);
+        sourceModel->emitValue();
+
+        model.setProfilingEnabled(false);
+        model.setProfilingEnabled(true);
+
+        CHECK(model.profiler()->profiledNodes().empty());
+    }
+
+    SECTION("heat map follows the compute times")
+    {
+        model.setProfilingEnabled(true);
+
+        NodeProfiler &profiler = *model.profiler();
+        profiler.recordCompute(first, std::chrono::milliseconds(10));
+        profiler.recordCompute(second, std::chrono::milliseconds(5));
+        profiler.recordCompute(second, std::chrono::milliseconds(1));
+
+        NodeHeatMapPainter painter(std::make_unique<DefaultNodePainter>(), model);
+
+        CHECK(painter.heat(first) == Approx(1.0));
+        CHECK(painter.heat(second) == Approx(0.6));
+        CHECK(painter.heat(source) < 0.0);
+
+        painter.setMetric(NodeHeatMapPainter::Metric::LastComputeTime);
+        CHECK(painter.heat(second) == Approx(0.1));
+    }
+}
+
+TEST_CASE("Node profile history", "[profiler]")
+{
+    NodeProfiler profiler;
+
+    const std::size_t total = NodeProfile::HistorySize + 3;
+    for (std::size_t i = 1; i <= total; ++i) {
+        profiler.recordCompute(0, std::chrono::microseconds(i));
+    }
+
+    const NodeProfile *profile = profiler.profile(0);
+    REQUIRE(profile != nullptr);
+
+    const auto recent = profile->recentComputeTimes();
+    REQUIRE(recent.size() == NodeProfile::HistorySize);
+    CHECK(recent.front() == std::chrono::microseconds(4));
+    CHECK(recent.back() == std::chrono::microseconds(total));
+    CHECK(profile->lastComputeTime() == std::chrono::microseconds(total));
+    CHECK(profile->computeCount == total);
+}
@@ -0,0 +1,63 @@
+#include "ApplicationSetup.hpp"
+#include "PassNodeModel.hpp"
+
+#include <QtNodes/DataFlowGraphModel>
+#include <QtNodes/DataFlowGraphicsScene>
+#include <QtNodes/NodeDelegateModelRegistry>
+#include <QtNodes/internal/NodeGraphicsObject.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+
+using QtNodes::BasicGraphicsScene;
+using QtNodes::DataFlowGraphicsScene;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::NodeGraphicsObject;
+using QtNodes::NodeId;
+
+TEST_CASE("Node shadow modes", "[gui]")
+{
+    auto app = applicationSetup();
+
+    DataFlowGraphModel model(makeRegistry());
+    DataFlowGraphicsScene scene(model);
+
+    const NodeId nodeId = model.addNode(PassModel::Name());
+    NodeGraphicsObject *ngo = scene.nodeGraphicsObject(nodeId);
+    REQUIRE(ngo != nullptr);
+
+    CHECK(scene.nodeShadowMode() == BasicGraphicsScene::ShadowMode::Effect);
+    CHECK(ngo->graphicsEffect() != nullptr);
+
+    const QRectF effectBounds = ngo->boundingRect();
+
+    SECTION("cached shadows replace the effect")
+    {
+        scene.setNodeShadowMode(BasicGraphicsScene::ShadowMode::Cached);
+
+        CHECK(ngo->graphicsEffect() == nullptr);
+        CHECK(ngo->boundingRect().contains(effectBounds));
+        CHECK(ngo->boundingRect() != effectBounds);
+
+        scene.setNodeShadowMode(BasicGraphicsScene::ShadowMode::Effect);
+        CHECK(ngo->graphicsEffect() != nullptr);
+        CHECK(ngo->boundingRect() == effectBounds);
+    }
+
+    SECTION("shadows can be disabled")
+    {
+        scene.setNodeShadowMode(BasicGraphicsScene::ShadowMode::None);
+
+        CHECK(ngo->graphicsEffect() == nullptr);
+        CHECK(ngo->boundingRect() == effectBounds);
+    }
+
+    SECTION("new nodes follow the scene")
+    {
+        scene.setNodeShadowMode(BasicGraphicsScene::ShadowMode::Cached);
+
+        const NodeId other = model.addNode(PassModel::Name());
+        CHECK(scene.nodeGraphicsObject(other)->graphicsEffect() == nullptr);
+    }
+}
@@ -0,0 +1,51 @@
+#include "SpatialGridIndex.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+
+using QtNodes::SpatialGridIndex;
+
+namespace {
+
+std::vector<int> sorted(std::vector<int> keys)
+{
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+} // namespace
+
+TEST_CASE("SpatialGridIndex queries", "[spatial]")
+{
+    SpatialGridIndex<int> index(100.0);
+
+    index.insert(1, QRectF(10, 10, 50, 50));
+    index.insert(2, QRectF(-150, -150, 400, 400)); // spans many cells
+    index.insert(3, QRectF(1000, 1000, 20, 20));
+
+    SECTION("point lookup")
+    {
+        CHECK(sorted(index.query(QPointF(20, 20))) == std::vector<int>{1, 2});
+        CHECK(index.query(QPointF(1010, 1010)) == std::vector<int>{3});
+        CHECK(index.query(QPointF(500, 500)).empty());
+    }
+
+    SECTION("rect lookup reports every key once")
+    {
+        CHECK(sorted(index.query(QRectF(-500, -500, 2000, 2000))) == std::vector<int>{1, 2, 3});
+        CHECK(index.query(QRectF(300, 300, 10, 10)).empty());
+    }
+
+    SECTION("moving and removing")
+    {
+        index.insert(1, QRectF(1005, 1005, 10, 10));
+        CHECK(sorted(index.query(QPointF(1010, 1010))) == std::vector<int>{1, 3});
+        CHECK(index.query(QPointF(20, 20)) == std::vector<int>{2});
+
+        index.remove(2);
+        CHECK(index.query(QPointF(20, 20)).empty());
+        CHECK(index.size() == 2);
+        CHECK_FALSE(index.contains(2));
+    }
+}
@@ -0,0 +1,83 @@
+#include "PassNodeModel.hpp"
+
+#include <QtNodes/DataFlowGraphModel>
+#include <QtNodes/NodeDelegateModelRegistry>
+#include <QtNodes/Tracing>
+
+#include <catch2/catch.hpp>
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTemporaryDir>
+
+#include <memory>
+#include <set>
+
+using QtNodes::ConnectionId;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::NodeId;
+using QtNodes::Tracing;
+
+TEST_CASE("Chrome trace export", "[tracing]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+
+    const QString fileName = dir.filePath("trace.json");
+
+    if (!Tracing::compiledIn()) {
+        CHECK_FALSE(Tracing::start(fileName));
+        CHECK_FALSE(Tracing::isActive());
+        CHECK_FALSE(Tracing::stop());
+        return;
+    }
+
+    auto registry = makeRegistry();
+
+    DataFlowGraphModel model(registry);
+    const NodeId first = model.addNode(PassModel::Name());
+    const NodeId second = model.addNode(PassModel::Name());
+    model.addConnection(ConnectionId{first, 0, second, 0});
+
+    const QJsonObject saved = model.save();
+
+    REQUIRE(Tracing::start(fileName));
+    CHECK(Tracing::isActive());
+
+    DataFlowGraphModel restored(registry);
+    restored.load(saved);
+
+    REQUIRE(Tracing::stop());
+    CHECK_FALSE(Tracing::isActive());
+
+    QFile file(fileName);
+    REQUIRE(file.open(QIODevice::ReadOnly));
+
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+    REQUIRE(document.isObject());
+
+    std::set<QString> names;
+    int begins = 0;
+    int ends = 0;
+
+    for (QJsonValue const value : document.object()["traceEvents"].toArray()) {
+        const QJsonObject event = value.toObject();
+        names.insert(event["name"].toString());
+
+        CHECK(event.contains("tid"));
+
+        if (event["ph"] == "B") {
+            ++begins;
+        } else if (event["ph"] == "E") {
+            ++ends;
+        }
+    }
+
+    CHECK(names.count("load") == 1);
+    CHECK(names.count("propagationWave") == 1);
+    CHECK(names.count("setInData") == 1);
+    CHECK(names.count("thread_name") == 1);
+    CHECK(begins == ends);
+}
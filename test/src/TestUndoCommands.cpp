@@ -0,0 +1,265 @@
+#include "ApplicationSetup.hpp"
+#include "PassNodeModel.hpp"
+
+#include <QtNodes/DataFlowGraphModel>
+#include <QtNodes/DataFlowGraphicsScene>
+#include <QtNodes/internal/NodeGraphicsObject.hpp>
+#include <QtNodes/internal/UndoCommands.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <QUndoStack>
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+using QtNodes::ConnectionId;
+using QtNodes::CopyCommand;
+using QtNodes::CreateCommand;
+using QtNodes::DataFlowGraphicsScene;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::DeleteCommand;
+using QtNodes::GraphUndoCommand;
+using QtNodes::MoveNodeCommand;
+using QtNodes::NodeId;
+using QtNodes::NodeRole;
+using QtNodes::NodeStatePool;
+using QtNodes::PasteCommand;
+
+namespace {
+
+bool isReleased(QUndoStack const &stack, int const index)
+{
+    auto command = dynamic_cast<GraphUndoCommand const *>(stack.command(index));
+    return command && command->isObsolete();
+}
+
+} // namespace
+
+TEST_CASE("Undo commands round trip", "[gui][undo]")
+{
+    auto app = applicationSetup();
+
+    DataFlowGraphModel model(makeRegistry());
+
+    const NodeId first = model.addNode(PassModel::Name());
+    const NodeId second = model.addNode(PassModel::Name());
+    model.setNodeData(second, NodeRole::Position, QPointF(300, 0));
+
+    const ConnectionId connectionId{first, 0, second, 0};
+    model.addConnection(connectionId);
+
+    DataFlowGraphicsScene scene(model);
+    QUndoStack &stack = scene.undoStack();
+
+    auto position = [&](NodeId const nodeId) {
+        return model.nodeData(nodeId, NodeRole::Position).value<QPointF>();
+    };
+
+    SECTION("delete")
+    {
+        scene.nodeGraphicsObject(first)->setSelected(true);
+        scene.nodeGraphicsObject(second)->setSelected(true);
+
+        stack.push(new DeleteCommand(&scene));
+        CHECK(model.allNodeIds().empty());
+
+        stack.undo();
+        CHECK(model.nodeExists(first));
+        CHECK(model.nodeExists(second));
+        CHECK(model.connectionExists(connectionId));
+        CHECK(position(second) == QPointF(300, 0));
+        CHECK(scene.nodeGraphicsObject(second) != nullptr);
+
+        stack.redo();
+        CHECK(model.allNodeIds().empty());
+        CHECK_FALSE(model.connectionExists(connectionId));
+    }
+
+    SECTION("create")
+    {
+        auto command = new CreateCommand(&scene, PassModel::Name(), QPointF(50, 60));
+        const NodeId created = command->getNodeId();
+        stack.push(command);
+
+        REQUIRE(model.nodeExists(created));
+        const QPointF createdPosition = position(created);
+
+        stack.undo();
+        CHECK_FALSE(model.nodeExists(created));
+
+        stack.redo();
+        CHECK(model.nodeExists(created));
+        CHECK(position(created) == createdPosition);
+        CHECK(model.allNodeIds().size() == 3);
+    }
+
+    SECTION("paste")
+    {
+        scene.nodeGraphicsObject(first)->setSelected(true);
+        scene.nodeGraphicsObject(second)->setSelected(true);
+
+        stack.push(new CopyCommand(&scene));
+        stack.push(new PasteCommand(&scene, QPointF(1000, 1000)));
+
+        CHECK(model.allNodeIds().size() == 4);
+        CHECK(model.allConnectionIds(first).size() == 1);
+
+        stack.undo();
+        CHECK(model.allNodeIds().size() == 2);
+
+        stack.redo();
+        CHECK(model.allNodeIds().size() == 4);
+    }
+
+    SECTION("merged moves")
+    {
+        scene.nodeGraphicsObject(first)->setSelected(true);
+
+        stack.push(new MoveNodeCommand(&scene, QPointF(10, 0)));
+        stack.push(new MoveNodeCommand(&scene, QPointF(0, 20)));
+
+        CHECK(stack.count() == 1);
+        CHECK(position(first) == QPointF(10, 20));
+
+        stack.undo();
+        CHECK(position(first) == QPointF(0, 0));
+        CHECK(position(second) == QPointF(300, 0));
+
+        stack.redo();
+        CHECK(position(first) == QPointF(10, 20));
+    }
+}
+
+TEST_CASE("Undo memory budget", "[gui][undo]")
+{
+    auto app = applicationSetup();
+
+    DataFlowGraphModel model(makeRegistry());
+    DataFlowGraphicsScene scene(model);
+    QUndoStack &stack = scene.undoStack();
+
+    auto create = [&](double const x) {
+        stack.push(new CreateCommand(&scene, PassModel::Name(), QPointF(x, 0)));
+    };
+
+    SECTION("unlimited by default")
+    {
+        create(0);
+        create(300);
+        create(600);
+
+        CHECK(scene.undoMemoryBudget() == 0);
+        CHECK_FALSE(isReleased(stack, 0));
+        CHECK_FALSE(isReleased(stack, 1));
+    }
+
+    SECTION("the oldest commands are released, the latest stays undoable")
+    {
+        scene.setUndoMemoryBudget(1);
+
+        create(0);
+        create(300);
+        create(600);
+
+        REQUIRE(stack.count() == 3);
+        CHECK(isReleased(stack, 0));
+        CHECK(isReleased(stack, 1));
+        CHECK_FALSE(isReleased(stack, 2));
+
+        stack.undo();
+        CHECK(model.allNodeIds().size() == 2);
+    }
+
+    SECTION("commands fitting the budget are kept")
+    {
+        create(0);
+        create(300);
+
+        auto command = dynamic_cast<GraphUndoCommand const *>(stack.command(1));
+        REQUIRE(command != nullptr);
+
+        // Room for two commands of this size.
+        scene.setUndoMemoryBudget(2 * command->memoryCost());
+        create(600);
+        create(900);
+
+        CHECK(isReleased(stack, 0));
+        CHECK(isReleased(stack, 1));
+        CHECK_FALSE(isReleased(stack, 2));
+        CHECK_FALSE(isReleased(stack, 3));
+    }
+
+    SECTION("the redo side is never released")
+    {
+        create(0);
+        create(300);
+        create(600);
+
+        stack.setIndex(0);
+        CHECK(model.allNodeIds().empty());
+
+        scene.setUndoMemoryBudget(1);
+
+        CHECK_FALSE(isReleased(stack, 0));
+        CHECK_FALSE(isReleased(stack, 1));
+        CHECK_FALSE(isReleased(stack, 2));
+
+        stack.setIndex(stack.count());
+        CHECK(model.allNodeIds().size() == 3);
+    }
+
+    SECTION("undone commands leave the accounting")
+    {
+        scene.setUndoMemoryBudget(std::numeric_limits<std::size_t>::max());
+
+        create(0);
+        create(300);
+        create(600);
+
+        stack.undo();
+        stack.undo();
+
+        // Only the first command is below the redo side, it is the latest.
+        scene.setUndoMemoryBudget(1);
+        CHECK_FALSE(isReleased(stack, 0));
+
+        stack.redo();
+        CHECK(isReleased(stack, 0));
+        CHECK_FALSE(isReleased(stack, 1));
+        CHECK_FALSE(isReleased(stack, 2));
+    }
+}
+
+TEST_CASE("Node state pool", "[undo]")
+{
+    NodeStatePool pool;
+
+    SECTION("equal states share one blob")
+    {
+        const auto first = pool.intern("{\"a\":1}");
+        const auto second = pool.intern("{\"a\":1}");
+
+        CHECK(first == second);
+        CHECK(pool.intern("{\"a\":2}") != first);
+    }
+
+    SECTION("released states are pruned with their buckets")
+    {
+        std::vector<std::shared_ptr<QByteArray const>> kept;
+        for (int i = 0; i < 1000; ++i) {
+            const auto blob = pool.intern(QByteArray::number(i));
+            if (i % 100 == 0) {
+                kept.push_back(blob);
+            }
+        }
+
+        CHECK(pool.bucketCount() < 1000);
+
+        pool.prune();
+
+        CHECK(pool.bucketCount() == kept.size());
+        CHECK(pool.intern(QByteArray::number(0)) == kept.front());
+    }
+}
@@ -0,0 +1,116 @@
+#include "ApplicationSetup.hpp"
+#include "PassNodeModel.hpp"
+
+#include <QtNodes/DataFlowGraphModel>
+#include <QtNodes/DataFlowGraphicsScene>
+#include <QtNodes/GraphicsView>
+#include <QtNodes/NodeDelegateModelRegistry>
+#include <QtNodes/internal/ConnectionGraphicsObject.hpp>
+#include <QtNodes/internal/NodeGraphicsObject.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <QtTest>
+
+#include <memory>
+
+using QtNodes::ConnectionId;
+using QtNodes::DataFlowGraphicsScene;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::GraphicsView;
+using QtNodes::NodeId;
+using QtNodes::NodeRole;
+
+namespace {
+
+NodeId addNodeAt(DataFlowGraphModel &model, QPointF const &pos)
+{
+    const NodeId nodeId = model.addNode(PassModel::Name());
+    model.setNodeData(nodeId, NodeRole::Position, pos);
+    return nodeId;
+}
+
+} // namespace
+
+TEST_CASE("Virtualized scene materializes items near the view", "[gui]")
+{
+    auto app = applicationSetup();
+
+    DataFlowGraphModel model(makeRegistry());
+
+    const NodeId nearNode = addNodeAt(model, QPointF(0, 0));
+    const NodeId farNode = addNodeAt(model, QPointF(20000, 20000));
+    const NodeId farNeighbour = addNodeAt(model, QPointF(20300, 20000));
+
+    const ConnectionId longConnection{nearNode, 0, farNode, 0};
+    const ConnectionId farConnection{farNode, 0, farNeighbour, 0};
+    model.addConnection(longConnection);
+    model.addConnection(farConnection);
+
+    DataFlowGraphicsScene scene(model);
+    scene.setVirtualizationEnabled(true);
+
+    CHECK(scene.spatialIndexEnabled());
+    CHECK(scene.nodeGraphicsObject(nearNode) == nullptr);
+
+    GraphicsView view(&scene);
+    view.resize(400, 300);
+    view.show();
+    REQUIRE(QTest::qWaitForWindowExposed(&view));
+
+    view.centerOn(QPointF(0, 0));
+
+    SECTION("only the visible part has graphics objects")
+    {
+        CHECK(scene.nodeGraphicsObject(nearNode) != nullptr);
+        CHECK(scene.nodeGraphicsObject(farNode) == nullptr);
+        CHECK(scene.connectionGraphicsObject(longConnection) != nullptr);
+        CHECK(scene.connectionGraphicsObject(farConnection) == nullptr);
+
+        // Released items are still found by id and by area.
+        CHECK(scene.nodesInRect(QRectF(19000, 19000, 2000, 2000)).size() == 2);
+        CHECK(scene.connectionsInRect(QRectF(19000, 19000, 2000, 2000)).size() == 2);
+    }
+
+    SECTION("panning swaps the materialized items")
+    {
+        view.centerOn(QPointF(20150, 20000));
+
+        CHECK(scene.nodeGraphicsObject(nearNode) == nullptr);
+        CHECK(scene.nodeGraphicsObject(farNode) != nullptr);
+        CHECK(scene.nodeGraphicsObject(farNeighbour) != nullptr);
+        CHECK(scene.connectionGraphicsObject(farConnection) != nullptr);
+    }
+
+    SECTION("selected nodes stay materialized")
+    {
+        scene.nodeGraphicsObject(nearNode)->setSelected(true);
+
+        view.centerOn(QPointF(20150, 20000));
+
+        REQUIRE(scene.nodeGraphicsObject(nearNode) != nullptr);
+        CHECK(scene.selectedNodeIds()->size() == 1);
+        CHECK(scene.selectedNodeIds()->front() == nearNode);
+    }
+
+    SECTION("released nodes follow model changes")
+    {
+        model.setNodeData(farNode, NodeRole::Position, QPointF(50, 50));
+
+        CHECK(scene.nodeGraphicsObject(farNode) != nullptr);
+        CHECK(scene.nodesInRect(QRectF(19000, 19000, 2000, 2000)).size() == 1);
+
+        model.deleteNode(farNeighbour);
+        CHECK(scene.nodesInRect(QRectF(19000, 19000, 2000, 2000)).empty());
+        CHECK(scene.connectionsInRect(QRectF(19000, 19000, 2000, 2000)).empty());
+    }
+
+    SECTION("disabling creates every object")
+    {
+        scene.setVirtualizationEnabled(false);
+
+        CHECK(scene.nodeGraphicsObject(farNode) != nullptr);
+        CHECK(scene.nodeGraphicsObject(farNeighbour) != nullptr);
+        CHECK(scene.connectionGraphicsObject(farConnection) != nullptr);
+    }
+}
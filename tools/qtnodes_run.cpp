@@ -0,0 +1,462 @@
+#include <QtNodes/BinaryGraphFormat>
+#include <QtNodes/DataFlowGraphModel>
+#include <QtNodes/NodeDelegateModelRegistry>
+#include <QtNodes/NodeProfiler>
+#include <QtNodes/NodeRegistryPlugin>
+#include <QtNodes/Tracing>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QLibrary>
+#include <QtCore/QPluginLoader>
+#include <QtCore/QTextStream>
+
+#include <chrono>
+#include <exception>
+#include <map>
+#include <memory>
+
+using QtNodes::BinaryGraphFormat::isBinaryGraph;
+using QtNodes::DataFlowGraphModel;
+using QtNodes::NodeData;
+using QtNodes::NodeDelegateModel;
+using QtNodes::NodeDelegateModelRegistry;
+using QtNodes::NodeId;
+using QtNodes::NodeProfile;
+using QtNodes::NodeProfiler;
+using QtNodes::NodeRegistryPlugin;
+using QtNodes::NodeRole;
+using QtNodes::PortIndex;
+using QtNodes::PortRole;
+using QtNodes::PortType;
+using QtNodes::Tracing;
+
+namespace {
+
+struct Options
+{
+    QString flowFile;
+    QStringList plugins;
+    QStringList pluginDirs;
+    QStringList inputs;
+    QString inputsFile;
+    QString traceFile;
+    bool async = false;
+    int timeout = 60000;
+    bool json = false;
+};
+
+/// Internal data values merged into the nodes before the evaluation.
+using Inputs = std::map<NodeId, QJsonObject>;
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+bool parseOptions(QCoreApplication const &app, Options &options)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Evaluates a .flow or .flowb graph without a scene and reports its outputs and timings.");
+    parser.addHelpOption();
+
+    QCommandLineOption pluginOption({"p", "plugin"},
+                                    "Registry plugin providing delegate models, repeatable.",
+                                    "file");
+    QCommandLineOption pluginDirOption({"P", "plugin-dir"},
+                                       "Loads every registry plugin of the directory.",
+                                       "dir");
+    QCommandLineOption inputOption({"i", "input"},
+                                   "Sets the internal data value <node>.<key> to the string "
+                                   "<value> before the evaluation, repeatable.",
+                                   "node.key=value");
+    QCommandLineOption inputsOption({"I", "inputs"},
+                                    "JSON file of the form {\"<node>\": {\"<key>\": <value>}}.",
+                                    "file");
+    QCommandLineOption asyncOption({"a", "async"},
+                                   "Computes thread-safe models on the evaluation thread pool.");
+    QCommandLineOption timeoutOption({"t", "timeout"},
+                                     "Milliseconds to wait for the evaluation.",
+                                     "msec",
+                                     "60000");
+    QCommandLineOption jsonOption({"j", "json"}, "Prints the report as JSON.");
+    QCommandLineOption traceOption("trace",
+                                   "Writes a Chrome trace of the run, needs a library built "
+                                   "with QT_NODES_TRACING.",
+                                   "file");
+
+    parser.addOptions({pluginOption,
+                       pluginDirOption,
+                       inputOption,
+                       inputsOption,
+                       asyncOption,
+                       timeoutOption,
+                       jsonOption,
+                       traceOption});
+    parser.addPositionalArgument("flow", "Graph file written by DataFlowGraphicsScene::save.");
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1) {
+        err() << parser.helpText();
+        return false;
+    }
+
+    options.flowFile = parser.positionalArguments().front();
+    options.plugins = parser.values(pluginOption);
+    options.pluginDirs = parser.values(pluginDirOption);
+    options.inputs = parser.values(inputOption);
+    options.inputsFile = parser.value(inputsOption);
+    options.traceFile = parser.value(traceOption);
+    options.async = parser.isSet(asyncOption);
+    options.json = parser.isSet(jsonOption);
+
+    bool ok = true;
+    options.timeout = parser.value(timeoutOption).toInt(&ok);
+    if (!ok || options.timeout < 0) {
+        err() << "Invalid timeout " << parser.value(timeoutOption) << "\n";
+        return false;
+    }
+
+    return true;
+}
+
+bool loadPlugin(QString const &fileName, NodeDelegateModelRegistry &registry)
+{
+    QPluginLoader loader(fileName);
+
+    auto plugin = qobject_cast<NodeRegistryPlugin *>(loader.instance());
+    if (!plugin) {
+        err() << "Cannot load the registry plugin " << fileName << ": " << loader.errorString()
+              << "\n";
+        return false;
+    }
+
+    plugin->registerModels(registry);
+    return true;
+}
+
+bool loadPlugins(Options const &options, NodeDelegateModelRegistry &registry)
+{
+    QStringList fileNames = options.plugins;
+
+    for (QString const &dirName : options.pluginDirs) {
+        QDir const dir(dirName);
+        for (QString const &entry : dir.entryList(QDir::Files, QDir::Name)) {
+            if (QLibrary::isLibrary(entry)) {
+                fileNames.push_back(dir.absoluteFilePath(entry));
+            }
+        }
+    }
+
+    if (fileNames.empty()) {
+        err() << "No registry plugin given, see --plugin and --plugin-dir\n";
+        return false;
+    }
+
+    for (QString const &fileName : fileNames) {
+        if (!loadPlugin(fileName, registry)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool parseInputs(Options const &options, Inputs &inputs)
+{
+    if (!options.inputsFile.isEmpty()) {
+        QFile file(options.inputsFile);
+        if (!file.open(QIODevice::ReadOnly)) {
+            err() << "Cannot open " << options.inputsFile << "\n";
+            return false;
+        }
+
+        QJsonParseError error;
+        const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+        if (!document.isObject()) {
+            err() << options.inputsFile << ": " << error.errorString() << "\n";
+            return false;
+        }
+
+        const QJsonObject root = document.object();
+        for (auto it = root.begin(); it != root.end(); ++it) {
+            bool ok = false;
+            const NodeId nodeId = it.key().toUInt(&ok);
+            if (!ok || !it.value().isObject()) {
+                err() << options.inputsFile << ": invalid entry " << it.key() << "\n";
+                return false;
+            }
+
+            QJsonObject &values = inputs[nodeId];
+            const QJsonObject nodeValues = it.value().toObject();
+            for (auto value = nodeValues.begin(); value != nodeValues.end(); ++value) {
+                values[value.key()] = value.value();
+            }
+        }
+    }
+
+    // The command line comes last and overrides the file.
+    for (QString const &input : options.inputs) {
+        const int equal = input.indexOf('=');
+        const int dot = input.indexOf('.');
+
+        bool ok = dot > 0 && equal > dot + 1;
+        const NodeId nodeId = ok ? input.left(dot).toUInt(&ok) : NodeId();
+        if (!ok) {
+            err() << "Invalid input " << input << ", expected <node>.<key>=<value>\n";
+            return false;
+        }
+
+        inputs[nodeId][input.mid(dot + 1, equal - dot - 1)] = input.mid(equal + 1);
+    }
+
+    return true;
+}
+
+/// Loads the graph inside the caller's batch, the inputs join the same wave.
+bool loadGraph(QString const &fileName, DataFlowGraphModel &model)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        err() << "Cannot open " << fileName << "\n";
+        return false;
+    }
+
+    try {
+        if (isBinaryGraph(file)) {
+            if (!model.loadBinary(file)) {
+                err() << fileName << ": corrupted binary graph\n";
+                return false;
+            }
+        } else {
+            QJsonParseError error;
+            const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+            if (!document.isObject()) {
+                err() << fileName << ": " << error.errorString() << "\n";
+                return false;
+            }
+            model.load(document.object());
+        }
+    } catch (std::exception const &e) {
+        err() << fileName << ": " << e.what() << "\n";
+        return false;
+    }
+
+    return true;
+}
+
+bool applyInputs(Inputs const &inputs, DataFlowGraphModel &model)
+{
+    for (auto const &input : inputs) {
+        const NodeId nodeId = input.first;
+
+        auto delegate = model.delegateModel<NodeDelegateModel>(nodeId);
+        if (!delegate) {
+            err() << "No node " << nodeId << " in the graph\n";
+            return false;
+        }
+
+        QJsonObject internalData = delegate->save();
+        for (auto it = input.second.begin(); it != input.second.end(); ++it) {
+            internalData[it.key()] = it.value();
+        }
+        delegate->load(internalData);
+
+        // `load` does not propagate, the node re-emits all of its outputs.
+        const auto outPorts = model.nodeData(nodeId, NodeRole::OutPortCount).toUInt();
+        for (PortIndex portIndex = 0; portIndex < outPorts; ++portIndex) {
+            Q_EMIT delegate->dataUpdated(portIndex);
+        }
+    }
+
+    return true;
+}
+
+QString describe(std::shared_ptr<NodeData> const &nodeData)
+{
+    return nodeData ? nodeData->getDescription() : QStringLiteral("<empty>");
+}
+
+/// Data arriving at the inputs of the nodes without outgoing connections.
+QJsonArray collectOutputs(DataFlowGraphModel const &model)
+{
+    std::map<NodeId, bool> sinks;
+    for (NodeId const nodeId : model.allNodeIds()) {
+        sinks[nodeId] = true;
+    }
+    for (auto const &connectionId : model.allConnectionIds()) {
+        sinks[connectionId.outNodeId] = false;
+    }
+
+    QJsonArray outputs;
+
+    for (auto const &sink : sinks) {
+        if (!sink.second) {
+            continue;
+        }
+
+        const NodeId nodeId = sink.first;
+        const auto inPorts = model.nodeData(nodeId, NodeRole::InPortCount).toUInt();
+
+        for (PortIndex portIndex = 0; portIndex < inPorts; ++portIndex) {
+            for (auto const &connectionId : model.connections(nodeId, PortType::In, portIndex)) {
+                const auto nodeData = model
+                                          .portData(connectionId.outNodeId,
+                                                    PortType::Out,
+                                                    connectionId.outPortIndex,
+                                                    PortRole::Data)
+                                          .value<std::shared_ptr<NodeData>>();
+
+                QJsonObject output;
+                output["node"] = static_cast<qint64>(nodeId);
+                output["model"] = model.nodeData(nodeId, NodeRole::Type).toString();
+                output["port"] = static_cast<qint64>(portIndex);
+                output["value"] = describe(nodeData);
+                outputs.append(output);
+            }
+        }
+    }
+
+    return outputs;
+}
+
+double toMs(NodeProfile::Duration const duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+QJsonArray collectTimings(DataFlowGraphModel const &model, NodeProfiler const &profiler)
+{
+    QJsonArray result;
+
+    for (NodeId const nodeId : profiler.profiledNodes()) {
+        const NodeProfile &profile = *profiler.profile(nodeId);
+
+        QJsonObject node;
+        node["node"] = static_cast<qint64>(nodeId);
+        node["model"] = model.nodeData(nodeId, NodeRole::Type).toString();
+        node["inputs"] = static_cast<qint64>(profile.setInDataCount);
+        node["computes"] = static_cast<qint64>(profile.computeCount);
+        node["compute_ms"] = toMs(profile.computeTime);
+        node["latency_ms"] = toMs(profile.latencyTime);
+        node["fan_out"] = static_cast<qint64>(profile.fanOutCount);
+        node["fan_out_ms"] = toMs(profile.fanOutTime);
+        result.append(node);
+    }
+
+    return result;
+}
+
+void printReport(QJsonObject const &report)
+{
+    QTextStream out(stdout);
+
+    out << "Outputs\n";
+    for (QJsonValue const value : report["outputs"].toArray()) {
+        const QJsonObject output = value.toObject();
+        out << "  node " << output["node"].toInt() << " (" << output["model"].toString()
+            << ") in " << output["port"].toInt() << ": " << output["value"].toString() << "\n";
+    }
+
+    out << "Nodes\n";
+    for (QJsonValue const value : report["nodes"].toArray()) {
+        const QJsonObject node = value.toObject();
+        out << "  node " << node["node"].toInt() << " (" << node["model"].toString() << "): "
+            << node["inputs"].toInt() << " inputs, " << node["computes"].toInt() << " computes, "
+            << node["compute_ms"].toDouble() << " ms, latency " << node["latency_ms"].toDouble()
+            << " ms, " << node["fan_out"].toInt() << " deliveries in "
+            << node["fan_out_ms"].toDouble() << " ms\n";
+    }
+
+    out << "Load " << report["load_ms"].toDouble() << " ms, evaluation "
+        << report["evaluation_ms"].toDouble() << " ms, wall time "
+        << report["wall_ms"].toDouble() << " ms\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // No widgets: delegate models are evaluated without ever creating their embedded widget.
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("qtnodes_run");
+
+    Options options;
+    if (!parseOptions(app, options)) {
+        return 2;
+    }
+
+    auto registry = std::make_shared<NodeDelegateModelRegistry>();
+
+    Inputs inputs;
+    if (!loadPlugins(options, *registry) || !parseInputs(options, inputs)) {
+        return 2;
+    }
+
+    DataFlowGraphModel model(registry);
+    model.setAsynchronousEvaluation(options.async);
+
+    model.setProfilingEnabled(true);
+
+    if (!options.traceFile.isEmpty() && !Tracing::start(options.traceFile)) {
+        err() << "Tracing is not compiled in, --trace is ignored\n";
+    }
+
+    QElapsedTimer wallTimer;
+    wallTimer.start();
+
+    qint64 loadNs = 0;
+    bool loaded = false;
+
+    // The restored connections and the inputs form one change wave, which is
+    // closed before any early return.
+    {
+        const DataFlowGraphModel::BatchUpdate batch(model);
+
+        loaded = loadGraph(options.flowFile, model) && applyInputs(inputs, model);
+
+        loadNs = wallTimer.nsecsElapsed();
+    }
+
+    if (!loaded) {
+        return 1;
+    }
+
+    const bool finished = model.waitForEvaluation(options.timeout);
+
+    const qint64 wallNs = wallTimer.nsecsElapsed();
+
+    // Also written for a stalled evaluation, which is when it helps the most.
+    if (Tracing::isActive() && !Tracing::stop()) {
+        err() << "Cannot write the trace " << options.traceFile << "\n";
+    }
+
+    if (!finished) {
+        err() << "The evaluation did not finish within " << options.timeout << " ms\n";
+        return 1;
+    }
+
+    QJsonObject report;
+    report["flow"] = options.flowFile;
+    report["outputs"] = collectOutputs(model);
+    report["nodes"] = collectTimings(model, *model.profiler());
+    report["load_ms"] = loadNs / 1e6;
+    report["evaluation_ms"] = (wallNs - loadNs) / 1e6;
+    report["wall_ms"] = wallNs / 1e6;
+
+    if (options.json) {
+        QTextStream(stdout) << QJsonDocument(report).toJson();
+    } else {
+        printReport(report);
+    }
+
+    return 0;
+}